@@ -20,13 +20,76 @@
 #include <string.h> // For strerror
 #include <limits.h> // For INT_MIN
 #include <ctype.h>  // For isspace
+#include <stdint.h> // For uint64_t
+#include <stddef.h> // For max_align_t
+#include <stdatomic.h> // For snapshot dict publication and reader epochs
+#include <stdarg.h> // For va_list in formatted appends
+#include <float.h>  // For DBL_EPSILON and FLT_EVAL_METHOD
+#include <locale.h> // For the decimal point handed to strtod
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
+    #include <immintrin.h> // For 32 byte compare and movemask
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+    #include <emmintrin.h> // For 16 byte compare and movemask
+#endif
+
+#if defined(_WIN32)
+    #include <windows.h>  // For SRWLOCK
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <pthread.h>  // For pthread_rwlock_t
+    #include <sched.h>    // For sched_yield
+    #include <sys/mman.h> // For mmap of binary images and CSV files
+    #include <sys/stat.h> // For fstat
+    #include <fcntl.h>    // For open
+    #include <unistd.h>   // For close
+#endif
 // ================================================================================ 
 // ================================================================================
 
 static const float LOAD_FACTOR_THRESHOLD = 0.7;
+static const float SHRINK_FACTOR_THRESHOLD = 0.1;  // Dicts shrink below this load factor
 static const size_t VEC_THRESHOLD = 1 * 1024 * 1024;  // 1 MB
 static const size_t VEC_FIXED_AMOUNT = 1 * 1024 * 1024;  // 1 MB
-static const size_t hashSize = 3;  //  Size fo hash map initi functions
+static const size_t hashSize = 4;  //  Size fo hash map initi functions, a power of two
+static const size_t DICT_SLAB_MIN = 1024;  // First slab handed to a dict, in bytes
+static const size_t DICT_SLAB_MAX = 64 * 1024;  // Slabs double up to this size
+static const size_t DICT_REHASH_STEP = 4;  // Old buckets migrated per incremental operation
+static const size_t DICT_DEFAULT_SHARDS = 64;  // Shards in a concurrent dict when 0 is requested
+static const size_t SET_GALLOP_RATIO = 8;  // Size skew at which set operations gallop
+// ================================================================================ 
+// ================================================================================ 
+// READER / WRITER LOCKS 
+
+// Thin wrapper over the platform reader/writer lock.  Targets without a 
+// thread library (e.g. AVR) compile the lock down to nothing.
+#if defined(_WIN32)
+    typedef SRWLOCK rw_lock;
+    static void _rw_init(rw_lock* l) { InitializeSRWLock(l); }
+    static void _rw_destroy(rw_lock* l) { (void)l; }
+    static void _rw_read_lock(rw_lock* l) { AcquireSRWLockShared(l); }
+    static void _rw_read_unlock(rw_lock* l) { ReleaseSRWLockShared(l); }
+    static void _rw_write_lock(rw_lock* l) { AcquireSRWLockExclusive(l); }
+    static void _rw_write_unlock(rw_lock* l) { ReleaseSRWLockExclusive(l); }
+    static void _thread_yield(void) { SwitchToThread(); }
+#elif defined(__unix__) || defined(__APPLE__)
+    typedef pthread_rwlock_t rw_lock;
+    static void _rw_init(rw_lock* l) { pthread_rwlock_init(l, NULL); }
+    static void _rw_destroy(rw_lock* l) { pthread_rwlock_destroy(l); }
+    static void _rw_read_lock(rw_lock* l) { pthread_rwlock_rdlock(l); }
+    static void _rw_read_unlock(rw_lock* l) { pthread_rwlock_unlock(l); }
+    static void _rw_write_lock(rw_lock* l) { pthread_rwlock_wrlock(l); }
+    static void _rw_write_unlock(rw_lock* l) { pthread_rwlock_unlock(l); }
+    static void _thread_yield(void) { sched_yield(); }
+#else
+    typedef char rw_lock;
+    static void _rw_init(rw_lock* l) { (void)l; }
+    static void _rw_destroy(rw_lock* l) { (void)l; }
+    static void _rw_read_lock(rw_lock* l) { (void)l; }
+    static void _rw_read_unlock(rw_lock* l) { (void)l; }
+    static void _rw_write_lock(rw_lock* l) { (void)l; }
+    static void _rw_write_unlock(rw_lock* l) { (void)l; }
+    static void _thread_yield(void) { }
+#endif
 // ================================================================================ 
 // ================================================================================ 
 // STRING_T DATA TYPE 
@@ -35,6 +98,7 @@ struct string_t {
     char* str;
     size_t len;
     size_t alloc;
+    size_t hash;  // Cached hash of str, 0 until computed
 };
 // ================================================================================ 
 // ================================================================================ 
@@ -68,6 +132,213 @@ static char* _last_literal_between_ptrs(const char* string, char* min_ptr, char*
     }
     return NULL;
 }
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the index of the first byte that differs between a and b, or len
+ * if the first len bytes are identical.  Blocks of 32 (AVX2) or 16 (SSE2)
+ * bytes are compared at once and the first mismatch is located with a
+ * movemask; other targets fall back to a word-at-a-time scan.
+ */
+static size_t _first_mismatch(const char* a, const char* b, size_t len) {
+    size_t i = 0;
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
+    for (; i + 32 <= len; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+        if (mask != 0xFFFFFFFFu) return i + __builtin_ctz(~mask);
+    }
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+    for (; i + 16 <= len; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+        if (mask != 0xFFFFu) return i + __builtin_ctz(~mask & 0xFFFFu);
+    }
+#endif
+    // Word at a time until a block differs, then locate the byte
+    for (; i + sizeof(size_t) <= len; i += sizeof(size_t)) {
+        size_t wa, wb;
+        memcpy(&wa, a + i, sizeof(size_t));
+        memcpy(&wb, b + i, sizeof(size_t));
+        if (wa != wb) break;
+    }
+    for (; i < len; i++) {
+        if (a[i] != b[i]) return i;
+    }
+    return len;
+}
+// --------------------------------------------------------------------------------
+
+static int _compare_bytes(const char* a, size_t a_len, const char* b, size_t b_len) {
+    size_t min_len = (a_len < b_len) ? a_len : b_len;
+    size_t index = _first_mismatch(a, b, min_len);
+    if (index < min_len) {
+        return (unsigned char)a[index] - (unsigned char)b[index];
+    }
+    return (a_len > b_len) - (a_len < b_len);
+}
+// --------------------------------------------------------------------------------
+
+static inline bool _equal_bytes(const char* a, size_t a_len, const char* b, size_t b_len) {
+    // Length check first, most unequal keys never touch their bytes
+    if (a_len != b_len) return false;
+    if (a == b) return true;
+    return _first_mismatch(a, b, a_len) == a_len;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * 64 x 64 -> 128 bit multiply, folded back to 64 bits by the callers.  This
+ * is the mixing step of wyhash.
+ */
+static inline void _mum(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 r = (uint128)(*a) * (*b);
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static inline uint64_t _mix(uint64_t a, uint64_t b) {
+    _mum(&a, &b);
+    return a ^ b;
+}
+// --------------------------------------------------------------------------------
+
+static inline uint64_t _read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+// --------------------------------------------------------------------------------
+
+static inline uint64_t _read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+// --------------------------------------------------------------------------------
+
+static const uint64_t _wyp[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 
+    0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+// --------------------------------------------------------------------------------
+
+/*
+ * wyhash style hash.  Reads the key 8 or 16 bytes at a time and mixes with a 
+ * 128 bit multiply, so long keys cost a few cycles per word rather than one 
+ * dependent multiply per byte.
+ */
+static uint64_t _wyhash(const char* key, size_t len, uint64_t seed) {
+    const uint8_t* p = (const uint8_t*)key;
+    uint64_t a, b;
+    seed ^= _mix(seed ^ _wyp[0], _wyp[1]);
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (_read32(p) << 32) | _read32(p + ((len >> 3) << 2));
+            b = (_read32(p + len - 4) << 32) | _read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = _mix(_read64(p) ^ _wyp[1], _read64(p + 8) ^ seed);
+                see1 = _mix(_read64(p + 16) ^ _wyp[2], _read64(p + 24) ^ see1);
+                see2 = _mix(_read64(p + 32) ^ _wyp[3], _read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = _mix(_read64(p) ^ _wyp[1], _read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = _read64(p + i - 16);
+        b = _read64(p + i - 8);
+    }
+    a ^= _wyp[1];
+    b ^= seed;
+    _mum(&a, &b);
+    return _mix(a ^ _wyp[0] ^ len, b ^ _wyp[1]);
+}
+// --------------------------------------------------------------------------------
+
+#define ROTL64(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+#define SIP_ROUND(v0, v1, v2, v3)                                   \
+    do {                                                             \
+        v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32); \
+        v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2;                    \
+        v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0;                    \
+        v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32); \
+    } while (0)
+// --------------------------------------------------------------------------------
+
+/*
+ * SipHash-1-3 keyed with a 128 bit secret.  Slower than _wyhash but an 
+ * attacker who does not know the key cannot construct colliding keys.
+ */
+static uint64_t _siphash(const char* key, size_t len, const uint64_t k[2]) {
+    const uint8_t* p = (const uint8_t*)key;
+    uint64_t v0 = 0x736f6d6570736575ull ^ k[0];
+    uint64_t v1 = 0x646f72616e646f6dull ^ k[1];
+    uint64_t v2 = 0x6c7967656e657261ull ^ k[0];
+    uint64_t v3 = 0x7465646279746573ull ^ k[1];
+    const uint8_t* end = p + (len & ~(size_t)7);
+
+    for (; p != end; p += 8) {
+        uint64_t m = _read64(p);
+        v3 ^= m;
+        SIP_ROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+    uint64_t last = (uint64_t)len << 56;
+    switch (len & 7) {
+        case 7: last |= (uint64_t)p[6] << 48; /* fall through */
+        case 6: last |= (uint64_t)p[5] << 40; /* fall through */
+        case 5: last |= (uint64_t)p[4] << 32; /* fall through */
+        case 4: last |= (uint64_t)p[3] << 24; /* fall through */
+        case 3: last |= (uint64_t)p[2] << 16; /* fall through */
+        case 2: last |= (uint64_t)p[1] << 8;  /* fall through */
+        case 1: last |= (uint64_t)p[0]; break;
+        default: break;
+    }
+    v3 ^= last;
+    SIP_ROUND(v0, v1, v2, v3);
+    v0 ^= last;
+    v2 ^= 0xff;
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+// --------------------------------------------------------------------------------
+
+static size_t hash_function(const char* key, size_t len) {
+    return (size_t)_wyhash(key, len, 0);
+}
 // ================================================================================ 
 // ================================================================================ 
 // --------------------------------------------------------------------------------
@@ -104,6 +375,7 @@ string_t* init_string(const char* str) {
     ptr->str = ptr2;
     ptr->len = len;
     ptr->alloc = len + 1;
+    ptr->hash = 0;
     return ptr;
 }
 // --------------------------------------------------------------------------------
@@ -182,6 +454,7 @@ bool string_string_concat(string_t* str1, const string_t* str2) {
 
     // Update the length of the first string
     str1->len = new_len;
+    str1->hash = 0;
     return true;
 }
 // --------------------------------------------------------------------------------
@@ -214,6 +487,7 @@ bool string_lit_concat(string_t* str1, const char* literal) {
 
     // Update the length of the first string
     str1->len = new_len;
+    str1->hash = 0;
 
     return true; // Indicate success
 }
@@ -225,15 +499,7 @@ int compare_strings_lit(const string_t* str_struct, const char* string) {
         return INT_MIN; // Or another designated error value
     }
 
-    size_t string_len = strlen(string);
-    size_t min_len = (str_struct->len < string_len) ? str_struct->len : string_len;
-
-    for (size_t i = 0; i < min_len; i++) {
-        if (str_struct->str[i] != string[i]) {
-            return (unsigned char)str_struct->str[i] - (unsigned char)string[i];
-        }
-    }
-    return str_struct->len - string_len;
+    return _compare_bytes(str_struct->str, str_struct->len, string, strlen(string));
 }
 // --------------------------------------------------------------------------------
 
@@ -243,15 +509,47 @@ int compare_strings_string(const string_t* str_struct_one, string_t* str_struct_
         return INT_MIN; // Or another designated error value
     } 
 
-    size_t string_len = str_struct_two->len;
-    size_t min_len = (str_struct_one->len < string_len) ? str_struct_one->len : string_len;
+    return _compare_bytes(str_struct_one->str, str_struct_one->len, 
+                          str_struct_two->str, str_struct_two->len);
+}
+// --------------------------------------------------------------------------------
+
+bool equal_strings_lit(const string_t* str_struct, const char* string) {
+    if (!str_struct || !string || !str_struct->str) {
+        errno = EINVAL;
+        return false;
+    }
 
-    for (size_t i = 0; i < min_len; i++) {
-        if (str_struct_one->str[i] != str_struct_two->str[i]) {
-            return (unsigned char)str_struct_one->str[i] - (unsigned char)str_struct_two->str[i];
-        }
+    return _equal_bytes(str_struct->str, str_struct->len, string, strlen(string));
+}
+// --------------------------------------------------------------------------------
+
+bool equal_strings_string(const string_t* str_struct_one, const string_t* str_struct_two) {
+    if (!str_struct_one || !str_struct_two || !str_struct_one->str || !str_struct_two->str) {
+        errno = EINVAL;
+        return false;
+    }
+
+    return _equal_bytes(str_struct_one->str, str_struct_one->len,
+                        str_struct_two->str, str_struct_two->len);
+}
+// --------------------------------------------------------------------------------
+
+size_t string_hash(string_t* str) {
+    if (!str || !str->str) {
+        errno = EINVAL;
+        return 0;
     }
-    return str_struct_one->len - string_len;
+    if (str->hash == 0) {
+        str->hash = hash_function(str->str, str->len);
+    }
+    return str->hash;
+}
+// --------------------------------------------------------------------------------
+
+// Uses a cached hash but never stores one, so const strings stay untouched
+static size_t _peek_string_hash(const string_t* str) {
+    return str->hash != 0 ? str->hash : hash_function(str->str, str->len);
 }
 // --------------------------------------------------------------------------------
 
@@ -560,6 +858,7 @@ bool drop_lit_substr(string_t* string, const char* substring, char* min_ptr, cha
         max_ptr -= drop_len;
         *(string->str + string->len) = '\0';
     }
+    string->hash = 0;
     return true;
 }
 // --------------------------------------------------------------------------------
@@ -597,6 +896,7 @@ bool drop_string_substr(string_t* string, const string_t* substring, char* min_p
         max_ptr -= drop_len;
         *(string->str + string->len) = '\0';
     }
+    string->hash = 0;
     return true;
 }
 // -------------------------------------------------------------------------------- 
@@ -692,6 +992,7 @@ bool replace_lit_substr(string_t* string, const char* pattern, const char* repla
             ptr = NULL;
     }
 
+    string->hash = 0;
     return true;
 }
 // --------------------------------------------------------------------------------
@@ -773,6 +1074,7 @@ bool replace_string_substr(string_t* string, const string_t* pattern, const stri
     }
    
     string->str[string->len] = '\0';
+    string->hash = 0;
     return true;
 }
 // --------------------------------------------------------------------------------
@@ -805,6 +1107,7 @@ void to_uppercase(string_t *s) {
     for (char* i =  begin; i != end; i++) {
         if (*i >= 'a' && *i <= 'z') *i -= 32;
     }
+    s->hash = 0;
 }
 // --------------------------------------------------------------------------------
 
@@ -818,6 +1121,7 @@ void to_lowercase(string_t *s) {
     for (char* i =  begin; i != end; i++) {
         if (*i >= 'A' && *i <= 'Z') *i += 32;
     }
+    s->hash = 0;
 }
 // --------------------------------------------------------------------------------
 
@@ -835,12 +1139,14 @@ string_t* pop_string_token(string_t* str_struct, char token) {
             if (i == str_struct->len - 1) {
                 str_struct->str[i] = '\0';
                 str_struct->len = i;
+                str_struct->hash = 0;
                 return init_string("");
             }
             
             string_t *one = init_string(str_struct->str + (i + 1));
             str_struct->str[i] = '\0';
             str_struct->len = i;
+            str_struct->hash = 0;
             return one;
         }
     }
@@ -911,6 +1217,7 @@ void replace_char(string_t* str, size_t index, char value) {
         return;
     }
     str->str[index] = value;
+    str->hash = 0;
 }
 // --------------------------------------------------------------------------------
 
@@ -943,6 +1250,7 @@ void trim_leading_whitespace(string_t* str) {
     
     // Update length
     str->len -= whitespace_count;
+    str->hash = 0;
     
     return;
 }
@@ -972,6 +1280,7 @@ void trim_trailing_whitespace(string_t* str) {
     
     // Update length (ptr - str->str gives new length)
     str->len = ptr - str->str;
+    str->hash = 0;
 }
 // --------------------------------------------------------------------------------
 
@@ -1001,6 +1310,7 @@ void trim_all_whitespace(string_t* str) {
     
     // Update length (write - str->str gives new length)
     str->len = write - str->str;
+    str->hash = 0;
     
     return;
 }
@@ -1047,9 +1357,44 @@ struct string_v {
     string_t* data;
     size_t len;
     size_t alloc;
+    char* arena;  // Single buffer backing borrowed elements, NULL if unused
+    bool sorted;  // True while the elements are known to be in ascending order
 };
 // -------------------------------------------------------------------------------- 
 
+/*
+ * Frees the character buffer of a vector element.  Elements pushed from an
+ * intern pool or built by the set operations borrow their buffer and are 
+ * marked with alloc == 0.
+ */
+static void _release_str(string_t* str) {
+    if (str->alloc != 0) {
+        free(str->str);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static inline int _cmp_str(const string_t* a, const string_t* b) {
+    return _compare_bytes(a->str, a->len, b->str, b->len);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Checks the element just placed at index against its neighbours.  Keeping 
+ * the sorted flag up to date this way costs at most two compares per 
+ * insertion, and removals never break the order.
+ */
+static bool _in_order_at(const string_v* vec, size_t index) {
+    if (index > 0 && _cmp_str(&vec->data[index - 1], &vec->data[index]) > 0) {
+        return false;
+    }
+    if (index + 1 < vec->len && _cmp_str(&vec->data[index], &vec->data[index + 1]) > 0) {
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
 string_v* init_str_vector(size_t buff) {
     string_v* struct_ptr = malloc(sizeof(string_v));
     if (struct_ptr == NULL) {
@@ -1070,6 +1415,8 @@ string_v* init_str_vector(size_t buff) {
     struct_ptr->data = data_ptr;
     struct_ptr->len = 0;
     struct_ptr->alloc = buff;
+    struct_ptr->arena = NULL;
+    struct_ptr->sorted = true;
     return struct_ptr;
 }
 // --------------------------------------------------------------------------------
@@ -1083,10 +1430,11 @@ void free_str_vector(string_v* vec) {
    // Free each string in the vector
    if (vec->data) {
        for (size_t i = 0; i < vec->len; i++) {
-           free(vec->data[i].str);
+           _release_str(&vec->data[i]);
        }
        free(vec->data);
    }
+   free(vec->arena);
    free(vec);
 }
 // --------------------------------------------------------------------------------
@@ -1139,7 +1487,9 @@ bool push_back_str_vector(string_v* vec, const char* value) {
     strcpy(vec->data[vec->len].str, value);
     vec->data[vec->len].alloc = str_len + 1;
     vec->data[vec->len].len = str_len;
+    vec->data[vec->len].hash = 0;
     vec->len++;
+    vec->sorted = vec->sorted && _in_order_at(vec, vec->len - 1);
    
     return true;
 }
@@ -1191,6 +1541,7 @@ bool push_front_str_vector(string_v* vec, const char* value) {
     vec->data[0].alloc = str_len + 1;
     vec->data[0].len = str_len;
     vec->len++;
+    vec->sorted = vec->sorted && _in_order_at(vec, 0);
     return true;
 }
 // --------------------------------------------------------------------------------
@@ -1251,6 +1602,7 @@ bool insert_str_vector(string_v* vec, const char* str, size_t index) {
     vec->data[index].alloc = str_len + 1;
     vec->data[index].len = str_len;
     vec->len++;
+    vec->sorted = vec->sorted && _in_order_at(vec, index);
     return true;
 }
 // --------------------------------------------------------------------------------
@@ -1273,7 +1625,7 @@ string_t* pop_back_str_vector(string_v* vec) {
     }
     
     // Clear the popped element for future reuse
-    free(vec->data[vec->len - 1].str);
+    _release_str(&vec->data[vec->len - 1]);
     vec->data[vec->len - 1].str = NULL;
     vec->data[vec->len - 1].len = 0;
     vec->data[vec->len - 1].alloc = 0;
@@ -1301,7 +1653,7 @@ string_t* pop_front_str_vector(string_v* vec) {
     }
    
     // Free the first element
-    free(vec->data[0].str);
+    _release_str(&vec->data[0]);
    
     // Shift remaining elements left
     memmove(vec->data, vec->data + 1, (vec->len - 1) * sizeof(string_t));
@@ -1337,7 +1689,7 @@ string_t* pop_any_str_vector(string_v* vec, size_t index) {
     }
    
     // Free the element being removed
-    free(vec->data[index].str);
+    _release_str(&vec->data[index]);
     
     // Shift remaining elements left
     memmove(&vec->data[index], &vec->data[index + 1], 
@@ -1363,7 +1715,7 @@ bool delete_back_str_vector(string_v* vec) {
     }
     
     // Clear the popped element for future reuse
-    free(vec->data[vec->len - 1].str);
+    _release_str(&vec->data[vec->len - 1]);
     vec->data[vec->len - 1].str = NULL;
     vec->data[vec->len - 1].len = 0;
     vec->data[vec->len - 1].alloc = 0;
@@ -1385,7 +1737,7 @@ bool delete_front_str_vector(string_v* vec) {
     }
    
     // Free the first element
-    free(vec->data[0].str);
+    _release_str(&vec->data[0]);
    
     // Shift remaining elements left
     memmove(vec->data, vec->data + 1, (vec->len - 1) * sizeof(string_t));
@@ -1415,7 +1767,7 @@ bool delete_any_str_vector(string_v* vec, size_t index) {
     }
 
     // Free the element being removed
-    free(vec->data[index].str);
+    _release_str(&vec->data[index]);
     
     // Shift remaining elements left
     memmove(&vec->data[index], &vec->data[index + 1], 
@@ -1472,6 +1824,7 @@ void reverse_str_vector(string_v* vec) {
        i++;
        j--;
     }
+    vec->sorted = vec->len < 2;
 }
 // ================================================================================
 // ================================================================================ 
@@ -1574,9 +1927,44 @@ void sort_str_vector(string_v* vec, iter_dir direction) {
         errno = EINVAL;
         return;
     }
-    if (vec->len < 2) return;
+    if (vec->len < 2) {
+        vec->sorted = true;
+        return;
+    }
+    // Ascending order is tracked, so sorting an already sorted vector is free
+    if (direction == FORWARD && vec->sorted) return;
     
     _quicksort_str_vector(vec->data, 0, vec->len - 1, direction);
+    vec->sorted = direction == FORWARD;
+}
+// --------------------------------------------------------------------------------
+
+static void _delim_table(const char* delim, bool table[256]) {
+    memset(table, 0, 256 * sizeof(bool));
+    for (const char* d = delim; *d; d++) {
+        table[(unsigned char)*d] = true;
+    }
+}
+// --------------------------------------------------------------------------------
+
+// Returns the next token at or after *cursor and moves the cursor past it
+static const char* _next_token(const char** cursor, const char* end, 
+                               const bool delims[256], size_t* len) {
+    const char* current = *cursor;
+    while (current < end && delims[(unsigned char)*current]) {
+        current++;
+    }
+    if (current >= end) {
+        *cursor = end;
+        return NULL;
+    }
+    const char* token_end = current;
+    while (token_end < end && !delims[(unsigned char)*token_end]) {
+        token_end++;
+    }
+    *len = (size_t)(token_end - current);
+    *cursor = token_end;
+    return current;
 }
 // --------------------------------------------------------------------------------
 
@@ -1649,144 +2037,340 @@ string_v* tokenize_string(const string_t* str, const char* delim) {
 
 typedef struct dictNode {
     char* key;
-    float value;
+    size_t key_len;
+    size_t key_cap;         // Bytes of slab storage behind key, 0 if borrowed
+    size_t hash;
+    size_t value;
+    size_t order_idx;       // Position in the insertion order array, if kept
     struct dictNode* next;
 } dictNode;
 // --------------------------------------------------------------------------------
 
+/*
+ * Nodes and key bytes are carved out of large blocks owned by the dict, so an 
+ * insert costs no malloc in the common case and free_dict costs one free per 
+ * slab.  Popped nodes go on a free list and keep their key storage for reuse.
+ */
+typedef struct dictSlab {
+    struct dictSlab* next;
+    size_t used;
+    size_t cap;
+    max_align_t data[];
+} dictSlab;
+// --------------------------------------------------------------------------------
+
 struct dict_t {
     dictNode* keyValues;
     size_t hash_size;
     size_t len;
-    size_t alloc;
+    size_t alloc;           // Always a power of two
+    hash_type hash_kind;
+    uint64_t hash_key[2];   // SipHash key, unused for FAST_HASH
+    dictSlab* slabs;        // Head is the slab currently being carved
+    dictNode* free_nodes;
+    size_t slab_size;
+    bool incremental;       // Resize by migrating a few buckets per operation
+    dictNode* old_values;   // Table being drained, NULL when not rehashing
+    size_t old_alloc;
+    size_t rehash_idx;      // Old buckets below this index are already empty
+    dictNode** order;       // Nodes in insertion order, NULL where popped
+    size_t order_len;
+    size_t order_alloc;
+    size_t order_holes;
 };
 // --------------------------------------------------------------------------------
 
-static size_t hash_function(const char* key) {
-    size_t hash = 5381; // Initialize hash with a prime number
-    int c;
+static void* _dict_slab_alloc(dict_t* dict, size_t size, size_t align) {
+    dictSlab* slab = dict->slabs;
+    if (slab) {
+        size_t offset = (slab->used + align - 1) & ~(align - 1);
+        if (offset + size <= slab->cap) {
+            slab->used = offset + size;
+            return (unsigned char*)slab->data + offset;
+        }
+    }
+
+    size_t cap = dict->slab_size;
+    bool oversized = size > cap;
+    if (oversized) {
+        cap = size;
+    } else if (dict->slab_size < DICT_SLAB_MAX) {
+        dict->slab_size *= 2;
+    }
+    dictSlab* new_slab = malloc(sizeof(dictSlab) + cap);
+    if (!new_slab) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    new_slab->cap = cap;
+    new_slab->used = size;
+    if (oversized && slab) {
+        // Keep carving the current slab, a long key gets a block to itself
+        new_slab->next = slab->next;
+        slab->next = new_slab;
+    } else {
+        new_slab->next = slab;
+        dict->slabs = new_slab;
+    }
+    return new_slab->data;
+}
+// --------------------------------------------------------------------------------
+
+static dictNode* _dict_node_alloc(dict_t* dict, size_t key_len, bool copy_key) {
+    dictNode* node = dict->free_nodes;
+    if (node) {
+        dict->free_nodes = node->next;
+    } else {
+        node = _dict_slab_alloc(dict, sizeof(dictNode), _Alignof(dictNode));
+        if (!node) return NULL;
+        node->key = NULL;
+        node->key_cap = 0;
+    }
+    if (!copy_key) {
+        node->key_cap = 0;
+        return node;
+    }
+    if (node->key_cap <= key_len) {
+        char* key = _dict_slab_alloc(dict, key_len + 1, 1);
+        if (!key) {
+            node->next = dict->free_nodes;
+            dict->free_nodes = node;
+            return NULL;
+        }
+        node->key = key;
+        node->key_cap = key_len + 1;
+    }
+    return node;
+}
+// --------------------------------------------------------------------------------
+
+static size_t _dict_hash(const dict_t* dict, const char* key, size_t len) {
+    if (dict->hash_kind == SECURE_HASH) {
+        return (size_t)_siphash(key, len, dict->hash_key);
+    }
+    return hash_function(key, len);
+}
+// --------------------------------------------------------------------------------
+
+static size_t _dict_string_hash(const dict_t* dict, const string_t* key) {
+    // The hash cached in string_t is unkeyed and only valid for FAST_HASH
+    if (dict->hash_kind == SECURE_HASH) {
+        return (size_t)_siphash(key->str, key->len, dict->hash_key);
+    }
+    return _peek_string_hash(key);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * While an incremental resize is in flight a key lives in the old table if its 
+ * old bucket has not been migrated yet, and in the new table otherwise, so every 
+ * operation still probes exactly one chain.
+ */
+static dictNode* _dict_bucket(const dict_t* dict, size_t hash) {
+    if (dict->old_values) {
+        size_t old_index = hash & (dict->old_alloc - 1);
+        if (old_index >= dict->rehash_idx) {
+            return &dict->old_values[old_index];
+        }
+    }
+    return &dict->keyValues[hash & (dict->alloc - 1)];
+}
+// --------------------------------------------------------------------------------
+
+static dictNode* _dict_walk(const dict_t* dict, size_t* slot, dictNode* node) {
+    if (node && node->next) {
+        return node->next;
+    }
+    // Slots below alloc are the live table, the rest the table being drained
+    size_t total = dict->alloc + (dict->old_values ? dict->old_alloc : 0);
+    while (*slot < total) {
+        size_t i = (*slot)++;
+        dictNode* head;
+        if (i < dict->alloc) {
+            head = &dict->keyValues[i];
+        } else if (i - dict->alloc >= dict->rehash_idx) {
+            head = &dict->old_values[i - dict->alloc];
+        } else {
+            continue;
+        }
+        if (head->next) {
+            return head->next;
+        }
+    }
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+static void _dict_move_chain(dictNode* head, dictNode* table, size_t size) {
+    dictNode* current = head->next;
+    while (current) {
+        dictNode* next = current->next;
+        size_t new_index = current->hash & (size - 1);
+        
+        // Insert at front of new chain
+        current->next = table[new_index].next;
+        table[new_index].next = current;
+        
+        current = next;
+    }
+    head->next = NULL;
+}
+// --------------------------------------------------------------------------------
 
-    while ((c = *key++)) { // Iterate over each character in the key
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+static void _dict_rehash_step(dict_t* dict, size_t buckets) {
+    if (!dict->old_values) return;
+    
+    // Empty buckets count toward the step so the cost per call stays bounded
+    while (buckets-- > 0 && dict->rehash_idx < dict->old_alloc) {
+        _dict_move_chain(&dict->old_values[dict->rehash_idx], dict->keyValues, dict->alloc);
+        dict->rehash_idx++;
+    }
+    if (dict->rehash_idx == dict->old_alloc) {
+        free(dict->old_values);
+        dict->old_values = NULL;
+        dict->old_alloc = 0;
+        dict->rehash_idx = 0;
     }
+}
+// --------------------------------------------------------------------------------
 
-    return hash; // Return the computed hash value
+static size_t _dict_capacity_for(size_t entries) {
+    // Smallest power of two table that holds entries below the load factor
+    size_t size = hashSize;
+    while (entries >= size * LOAD_FACTOR_THRESHOLD) {
+        if (size > SIZE_MAX / 2) return 0;
+        size *= 2;
+    }
+    return size;
 }
 // --------------------------------------------------------------------------------
 
 static bool resize_dict(dict_t* dict, size_t new_size) {
-    if (!dict || new_size <= dict->alloc) {
+    if (!dict || new_size < hashSize || (new_size & (new_size - 1)) != 0) {
         errno = EINVAL;
         return false;
     }
+    if (new_size == dict->alloc) {
+        return true;
+    }
+    
+    // Only one migration runs at a time, finish any that is still pending
+    _dict_rehash_step(dict, SIZE_MAX);
 
-    dictNode* new_table = malloc(new_size * sizeof(dictNode));
+    dictNode* new_table = calloc(new_size, sizeof(dictNode));
     if (!new_table) {
         errno = ENOMEM;
         return false;
     }
 
-    // Initialize new table
-    memset(new_table, 0, new_size * sizeof(dictNode));
-
-    // Rehash existing entries
-    for (size_t i = 0; i < dict->alloc; i++) {
-        dictNode* current = dict->keyValues[i].next;
-        while (current) {
-            dictNode* next = current->next;
-            size_t new_index = hash_function(current->key) % new_size;
-            
-            // Insert at front of new chain
-            current->next = new_table[new_index].next;
-            new_table[new_index].next = current;
-            
-            current = next;
+    if (dict->incremental) {
+        // Entries move over a few buckets at a time on later operations
+        dict->old_values = dict->keyValues;
+        dict->old_alloc = dict->alloc;
+        dict->rehash_idx = 0;
+    } else {
+        // Redistribute existing entries using their stored hash
+        for (size_t i = 0; i < dict->alloc; i++) {
+            _dict_move_chain(&dict->keyValues[i], new_table, new_size);
         }
+        free(dict->keyValues);
     }
-
-    free(dict->keyValues);
     dict->keyValues = new_table;
     dict->alloc = new_size;
 
     return true;
 }
-
 // --------------------------------------------------------------------------------
 
-dict_t* init_dict() {
-    dict_t* hashPtr = malloc(sizeof(*hashPtr));
-    if (!hashPtr) {
-        errno = ENOMEM;
-        fprintf(stderr, "ERROR: Allocation failure in init_dict() function\n");
-        return NULL;
+static bool _dict_order_reserve(dict_t* dict) {
+    if (!dict->order || dict->order_len < dict->order_alloc) {
+        return true;
     }
-    dictNode* arrPtr = malloc(hashSize * sizeof(*arrPtr));
-    if (!arrPtr) {
+    size_t new_alloc = dict->order_alloc * 2;
+    dictNode** order = realloc(dict->order, new_alloc * sizeof(dictNode*));
+    if (!order) {
         errno = ENOMEM;
-        fprintf(stderr, "ERROR: Allocation failure in init_dict() function\n");
-        free(hashPtr);
-        return NULL;
+        return false;
     }
+    dict->order = order;
+    dict->order_alloc = new_alloc;
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    // Initialize each index in the keyValues array with a designated head node
-    for (size_t i = 0; i < hashSize; i++) {
-        arrPtr[i].key = NULL; // Set the head node's key pointer to NULL
-        arrPtr[i].next = NULL; // Set the head node's next pointer to NULL
-        arrPtr[i].value = 0; // Initialize value
+static void _dict_order_compact(dict_t* dict) {
+    // Slide live nodes over the holes left by pops, keeping their order
+    size_t len = 0;
+    for (size_t i = 0; i < dict->order_len; i++) {
+        dictNode* node = dict->order[i];
+        if (node) {
+            node->order_idx = len;
+            dict->order[len++] = node;
+        }
     }
-    
-    hashPtr->keyValues = arrPtr;
-    hashPtr->hash_size = 0;
-    hashPtr->len = 0;
-    hashPtr->alloc = hashSize;
-    return hashPtr;
+    dict->order_len = len;
+    dict->order_holes = 0;
 }
 // --------------------------------------------------------------------------------
 
-bool insert_dict(dict_t* dict, const char* key, size_t value) {
-    if (!dict || !key) {
-        errno = EINVAL;
-        return false;
+static dictNode* _dict_find(const dict_t* dict, const char* key, size_t key_len, size_t hash) {
+    dictNode* current = _dict_bucket(dict, hash)->next;
+    while (current) {
+        if (current->hash == hash && 
+            _equal_bytes(current->key, current->key_len, key, key_len)) {
+            return current;
+        }
+        current = current->next;
     }
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+static bool _dict_insert(dict_t* dict, const char* key, size_t key_len, size_t hash,
+                         size_t value, bool copy_key) {
+    _dict_rehash_step(dict, DICT_REHASH_STEP);
     
     // Check load factor and resize if needed
     if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
-        size_t new_size = dict->alloc < VEC_THRESHOLD ? 
-                         dict->alloc * 2 : dict->alloc + VEC_FIXED_AMOUNT;
-        if (!resize_dict(dict, new_size)) {
+        // Tables always double so the bucket index stays a mask
+        if (!resize_dict(dict, dict->alloc * 2)) {
             return false;
         }
     }
     
-    size_t index = hash_function(key) % dict->alloc;
-    
-    // Check for existing key while finding insertion point
-    dictNode* current = dict->keyValues[index].next;
-    while (current) {
-        if (strcmp(current->key, key) == 0) {
-            errno = EINVAL;
-            return false;  // Key already exists
-        }
-        current = current->next;
+    if (_dict_find(dict, key, key_len, hash)) {
+        errno = EINVAL;
+        return false;  // Key already exists
     }
     
-    // Allocate and initialize new node
-    dictNode* new_node = malloc(sizeof(*new_node));
-    if (!new_node) {
-        errno = ENOMEM;
+    if (!_dict_order_reserve(dict)) {
         return false;
     }
     
-    new_node->key = strdup(key);
-    if (!new_node->key) {
-        errno = ENOMEM;
-        free(new_node);
+    // Take a node, and storage for its key, from the dict's slabs
+    dictNode* new_node = _dict_node_alloc(dict, key_len, copy_key);
+    if (!new_node) {
         return false;
     }
     
+    if (copy_key) {
+        memcpy(new_node->key, key, key_len);
+        new_node->key[key_len] = '\0';
+    } else {
+        new_node->key = (char*)key;
+    }
+    new_node->key_len = key_len;
+    new_node->hash = hash;
+    
+    dictNode* head = _dict_bucket(dict, hash);
     new_node->value = value;
-    new_node->next = dict->keyValues[index].next;
-    dict->keyValues[index].next = new_node;
+    new_node->next = head->next;
+    head->next = new_node;
+    
+    if (dict->order) {
+        new_node->order_idx = dict->order_len;
+        dict->order[dict->order_len++] = new_node;
+    }
     
     dict->hash_size++;
     dict->len++;
@@ -1795,73 +2379,199 @@ bool insert_dict(dict_t* dict, const char* key, size_t value) {
 }
 // --------------------------------------------------------------------------------
 
-size_t pop_dict(dict_t* dict, char* key) {
-    if (!dict || !key) {
-        errno = EINVAL;
-        return LONG_MAX;
-    }
-    size_t index = hash_function(key) % dict->alloc;
+static bool _dict_pop(dict_t* dict, const char* key, size_t key_len, size_t hash, 
+                      size_t* value) {
+    _dict_rehash_step(dict, DICT_REHASH_STEP);
 
     // Traverse the linked list at the index
-    dictNode* prev = &dict->keyValues[index];
+    dictNode* prev = _dict_bucket(dict, hash);
     dictNode* current = prev->next;
     while (current) {
-        if (strcmp(current->key, key) == 0) {
+        if (current->hash == hash && 
+            _equal_bytes(current->key, current->key_len, key, key_len)) {
             // Key found, unlink the node from the linked list
             prev->next = current->next;
             
             // Retrieve the value associated with the key
-            float value = current->value;
+            *value = current->value;
 
-            // Free the memory allocated for the key and the node
-            free(current->key);
-            free(current);
+            // Recycle the node, and its key storage, for a later insert
+            current->next = dict->free_nodes;
+            dict->free_nodes = current;
+            
+            if (dict->order) {
+                dict->order[current->order_idx] = NULL;
+                if (++dict->order_holes > dict->order_len / 2) {
+                    _dict_order_compact(dict);
+                }
+            }
 
             // Decrement the number of key-value pairs in the hash table
             dict->len--;
-
-            // Return the value associated with the key
-            return value;
+            dict->hash_size--;
+            
+            // Give back a drained table, leaving room to grow before the next resize.
+            // A failed shrink leaves the dict valid, so the pop still succeeds.
+            if (!dict->old_values && dict->alloc > hashSize &&
+                dict->hash_size < dict->alloc * SHRINK_FACTOR_THRESHOLD) {
+                int saved = errno;
+                if (!resize_dict(dict, _dict_capacity_for(dict->hash_size * 2))) {
+                    errno = saved;
+                }
+            }
+            return true;
         }
         prev = current;
         current = current->next;
     }
+    return false;
+}
+// --------------------------------------------------------------------------------
 
-    return LONG_MAX;
+dict_t* init_dict() {
+    return init_dict_hash(FAST_HASH, NULL);
 }
 // --------------------------------------------------------------------------------
 
-const size_t get_dict_value(const dict_t* table, char* key) {
-    if (!table || !key) {
+dict_t* init_dict_hash(hash_type type, const unsigned char* key) {
+    if ((type != FAST_HASH && type != SECURE_HASH) || (type == SECURE_HASH && !key)) {
         errno = EINVAL;
-        return LONG_MAX;
+        return NULL;
     }
-    size_t index = hash_function(key) % table->alloc;
-    // Traverse the linked list at the index
-    dictNode* current = table->keyValues[index].next;
-    while (current) {
-        if (strcmp(current->key, key) == 0) {
-            // Key found, return the corresponding value
-            return current->value;
-        }
-        current = current->next;
+    dict_t* hashPtr = malloc(sizeof(*hashPtr));
+    if (!hashPtr) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_dict_hash() function\n");
+        return NULL;
+    }
+    dictNode* arrPtr = malloc(hashSize * sizeof(*arrPtr));
+    if (!arrPtr) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_dict_hash() function\n");
+        free(hashPtr);
+        return NULL;
     }
-    fprintf(stderr, "Key: '%s' does not exist in dictionary\n", key);
-    return LONG_MAX; 
-}
-// --------------------------------------------------------------------------------
 
-void free_dict(dict_t* dict) {
-    for (size_t i = 0; i < dict->alloc; i++) {
-        dictNode* current = dict->keyValues[i].next; // Start from the head of the list
-        dictNode* next = NULL;
-        while (current) {      
-            next = current->next;
-            free(current->key);
-            free(current);
-            current = next;
-        }
+    // Initialize each index in the keyValues array with a designated head node
+    for (size_t i = 0; i < hashSize; i++) {
+        arrPtr[i].key = NULL; // Set the head node's key pointer to NULL
+        arrPtr[i].key_len = 0; // Head nodes carry no key
+        arrPtr[i].hash = 0;
+        arrPtr[i].key_cap = 0;
+        arrPtr[i].next = NULL; // Set the head node's next pointer to NULL
+        arrPtr[i].value = 0; // Initialize value
+    }
+    
+    hashPtr->keyValues = arrPtr;
+    hashPtr->hash_size = 0;
+    hashPtr->len = 0;
+    hashPtr->alloc = hashSize;
+    hashPtr->hash_kind = type;
+    hashPtr->slabs = NULL;
+    hashPtr->free_nodes = NULL;
+    hashPtr->slab_size = DICT_SLAB_MIN;
+    hashPtr->incremental = false;
+    hashPtr->old_values = NULL;
+    hashPtr->old_alloc = 0;
+    hashPtr->rehash_idx = 0;
+    hashPtr->order = NULL;
+    hashPtr->order_len = 0;
+    hashPtr->order_alloc = 0;
+    hashPtr->order_holes = 0;
+    hashPtr->hash_key[0] = 0;
+    hashPtr->hash_key[1] = 0;
+    if (type == SECURE_HASH) {
+        memcpy(hashPtr->hash_key, key, sizeof(hashPtr->hash_key));
+    }
+    return hashPtr;
+}
+// --------------------------------------------------------------------------------
+
+bool insert_dict(dict_t* dict, const char* key, size_t value) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t key_len = strlen(key);
+    return _dict_insert(dict, key, key_len, _dict_hash(dict, key, key_len), value, true);
+}
+// --------------------------------------------------------------------------------
+
+bool insert_dict_string(dict_t* dict, const string_t* key, size_t value) {
+    if (!dict || !key || !key->str) {
+        errno = EINVAL;
+        return false;
+    }
+    return _dict_insert(dict, key->str, key->len, _dict_string_hash(dict, key), value, true);
+}
+// --------------------------------------------------------------------------------
+
+size_t pop_dict(dict_t* dict, char* key) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t key_len = strlen(key);
+    size_t value;
+    if (_dict_pop(dict, key, key_len, _dict_hash(dict, key, key_len), &value)) {
+        return value;
+    }
+    return LONG_MAX;
+}
+// --------------------------------------------------------------------------------
+
+size_t pop_dict_string(dict_t* dict, const string_t* key) {
+    if (!dict || !key || !key->str) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t value;
+    if (_dict_pop(dict, key->str, key->len, _dict_string_hash(dict, key), &value)) {
+        return value;
+    }
+    return LONG_MAX;
+}
+// --------------------------------------------------------------------------------
+
+const size_t get_dict_value(const dict_t* table, char* key) {
+    if (!table || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t key_len = strlen(key);
+    dictNode* node = _dict_find(table, key, key_len, _dict_hash(table, key, key_len));
+    if (node) {
+        return node->value;
+    }
+    fprintf(stderr, "Key: '%s' does not exist in dictionary\n", key);
+    return LONG_MAX; 
+}
+// --------------------------------------------------------------------------------
+
+const size_t get_dict_value_string(const dict_t* table, const string_t* key) {
+    if (!table || !key || !key->str) {
+        errno = EINVAL;
+        return LONG_MAX;
     }
+    dictNode* node = _dict_find(table, key->str, key->len, _dict_string_hash(table, key));
+    if (node) {
+        return node->value;
+    }
+    fprintf(stderr, "Key: '%s' does not exist in dictionary\n", key->str);
+    return LONG_MAX; 
+}
+// --------------------------------------------------------------------------------
+
+void free_dict(dict_t* dict) {
+    // Nodes and keys live in the slabs, so no chain needs to be walked
+    dictSlab* slab = dict->slabs;
+    while (slab) {
+        dictSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    free(dict->old_values);
+    free(dict->order);
     free(dict->keyValues); 
     free(dict); 
 }
@@ -1879,14 +2589,11 @@ bool update_dict(dict_t* dict, char* key, size_t value) {
         errno = EINVAL;
         return false;
     }
-    size_t index = hash_function(key) % dict->alloc;
-    dictNode* current = dict->keyValues[index].next;
-    while (current) {
-        if (strcmp(current->key, key) == 0) {
-            current->value = value;
-            return true;
-        }
-        current = current->next;
+    size_t key_len = strlen(key);
+    dictNode* node = _dict_find(dict, key, key_len, _dict_hash(dict, key, key_len));
+    if (node) {
+        node->value = value;
+        return true;
     }
     errno = EINVAL;
     // If key is not found, no action is taken
@@ -1894,6 +2601,21 @@ bool update_dict(dict_t* dict, char* key, size_t value) {
 }
 // --------------------------------------------------------------------------------
 
+bool update_dict_string(dict_t* dict, const string_t* key, size_t value) {
+    if (!dict || !key || !key->str) {
+        errno = EINVAL;
+        return false;
+    }
+    dictNode* node = _dict_find(dict, key->str, key->len, _dict_string_hash(dict, key));
+    if (node) {
+        node->value = value;
+        return true;
+    }
+    errno = EINVAL;
+    return false;
+}
+// --------------------------------------------------------------------------------
+
 const size_t dict_size(const dict_t* dict) {
     if (!dict) {
         errno = EINVAL;
@@ -1926,18 +2648,218 @@ bool is_key_value(const dict_t* dict, const char* key) {
         errno = EINVAL;
         return false;
     }
-    
-    size_t index = hash_function(key) % dict->alloc;
-    dictNode* current = dict->keyValues[index].next;
-    
-    while (current) {
-        if (strcmp(current->key, key) == 0) {
-            return true;  // Key exists
+    size_t key_len = strlen(key);
+    return _dict_find(dict, key, key_len, _dict_hash(dict, key, key_len)) != NULL;
+}
+// --------------------------------------------------------------------------------
+
+bool is_key_value_string(const dict_t* dict, const string_t* key) {
+    if (!dict || !key || !key->str) {
+        errno = EINVAL;
+        return false;
+    }
+    return _dict_find(dict, key->str, key->len, _dict_string_hash(dict, key)) != NULL;
+}
+// --------------------------------------------------------------------------------
+
+bool set_dict_ordered(dict_t* dict, bool enable) {
+    if (!dict) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!enable) {
+        free(dict->order);
+        dict->order = NULL;
+        dict->order_len = 0;
+        dict->order_alloc = 0;
+        dict->order_holes = 0;
+        return true;
+    }
+    if (dict->order) {
+        return true;
+    }
+    size_t alloc = dict->len < hashSize ? hashSize : dict->len * 2;
+    dictNode** order = malloc(alloc * sizeof(dictNode*));
+    if (!order) {
+        errno = ENOMEM;
+        return false;
+    }
+    // Keys already present have no recorded order, take them in bucket order
+    size_t len = 0;
+    size_t slot = 0;
+    dictNode* node = NULL;
+    while ((node = _dict_walk(dict, &slot, node))) {
+        node->order_idx = len;
+        order[len++] = node;
+    }
+    dict->order = order;
+    dict->order_len = len;
+    dict->order_alloc = alloc;
+    dict->order_holes = 0;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+dict_iter_t init_dict_iter(const dict_t* dict) {
+    dict_iter_t iter = {dict, 0, NULL};
+    if (!dict) {
+        errno = EINVAL;
+    }
+    return iter;
+}
+// --------------------------------------------------------------------------------
+
+bool dict_iter_next(dict_iter_t* iter, const char** key, size_t* key_len, size_t* value) {
+    if (!iter) {
+        errno = EINVAL;
+        return false;
+    }
+    const dict_t* dict = iter->dict;
+    if (!dict) {
+        return false;
+    }
+    dictNode* node = NULL;
+    if (dict->order) {
+        // Walk the dense order array, stepping over popped entries
+        while (iter->index < dict->order_len && !dict->order[iter->index]) {
+            iter->index++;
         }
-        current = current->next;
+        if (iter->index < dict->order_len) {
+            node = dict->order[iter->index++];
+        }
+    } else {
+        node = _dict_walk(dict, &iter->index, (dictNode*)iter->node);
     }
-    
-    return false;  // Key doesn't exist
+    iter->node = node;
+    if (!node) {
+        return false;
+    }
+    if (key) *key = node->key;
+    if (key_len) *key_len = node->key_len;
+    if (value) *value = node->value;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+// True if a ranks below b: smaller value, or equal value and later key
+static bool _entry_below(const dict_entry_t* a, const dict_entry_t* b) {
+    if (a->value != b->value) {
+        return a->value < b->value;
+    }
+    return _compare_bytes(a->key, a->key_len, b->key, b->key_len) > 0;
+}
+// --------------------------------------------------------------------------------
+
+static void _entry_sift_down(dict_entry_t* heap, size_t len, size_t i) {
+    for (;;) {
+        size_t low = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < len && _entry_below(&heap[left], &heap[low])) low = left;
+        if (right < len && _entry_below(&heap[right], &heap[low])) low = right;
+        if (low == i) return;
+        dict_entry_t tmp = heap[i];
+        heap[i] = heap[low];
+        heap[low] = tmp;
+        i = low;
+    }
+}
+// --------------------------------------------------------------------------------
+
+size_t dict_top_k(const dict_t* dict, size_t k, dict_entry_t* out) {
+    if (!dict || (!out && k > 0)) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    // out doubles as a min-heap holding the best k entries seen so far
+    size_t len = 0;
+    dict_iter_t iter = init_dict_iter(dict);
+    dict_entry_t entry;
+    while (k > 0 && dict_iter_next(&iter, &entry.key, &entry.key_len, &entry.value)) {
+        if (len < k) {
+            out[len++] = entry;
+            // Sift up the new leaf
+            for (size_t i = len - 1; i > 0 && _entry_below(&out[i], &out[(i - 1) / 2]); 
+                 i = (i - 1) / 2) {
+                dict_entry_t tmp = out[i];
+                out[i] = out[(i - 1) / 2];
+                out[(i - 1) / 2] = tmp;
+            }
+        } else if (_entry_below(&out[0], &entry)) {
+            out[0] = entry;
+            _entry_sift_down(out, len, 0);
+        }
+    }
+    // Repeatedly move the weakest entry to the back, leaving the best first
+    for (size_t end = len; end > 1; end--) {
+        dict_entry_t tmp = out[0];
+        out[0] = out[end - 1];
+        out[end - 1] = tmp;
+        _entry_sift_down(out, end - 1, 0);
+    }
+    return len;
+}
+// --------------------------------------------------------------------------------
+
+bool set_dict_incremental(dict_t* dict, bool enable) {
+    if (!dict) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!enable) {
+        // Leave the table in a single piece when switching back
+        _dict_rehash_step(dict, SIZE_MAX);
+    }
+    dict->incremental = enable;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool shrink_dict(dict_t* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t size = _dict_capacity_for(dict->hash_size);
+    if (size >= dict->alloc) {
+        return true;
+    }
+    return resize_dict(dict, size);
+}
+// --------------------------------------------------------------------------------
+
+bool reserve_dict(dict_t* dict, size_t entries) {
+    if (!dict) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t size = _dict_capacity_for(entries);
+    if (size == 0) {
+        errno = ENOMEM;
+        return false;
+    }
+    if (size <= dict->alloc) {
+        return true;
+    }
+    return resize_dict(dict, size);
+}
+// --------------------------------------------------------------------------------
+
+double dict_load_factor(const dict_t* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return -1.0;
+    }
+    return (double)dict->hash_size / (double)dict->alloc;
+}
+// --------------------------------------------------------------------------------
+
+bool dict_is_rehashing(const dict_t* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return false;
+    }
+    return dict->old_values != NULL;
 }
 // --------------------------------------------------------------------------------
 
@@ -1953,16 +2875,14 @@ string_v* get_dict_keys(const dict_t* dict) {
         return NULL;  // errno set by init_str_vector
     }
     
-    // Iterate through all buckets
-    for (size_t i = 0; i < dict->alloc; i++) {
-        dictNode* current = dict->keyValues[i].next;
-        while (current) {
-            // Add key to vector
-            if (!push_back_str_vector(keys, current->key)) {
-                free_str_vector(keys);
-                return NULL;
-            }
-            current = current->next;
+    // Keys come out in insertion order when the dict keeps one
+    dict_iter_t iter = init_dict_iter(dict);
+    const char* key;
+    while (dict_iter_next(&iter, &key, NULL, NULL)) {
+        // Add key to vector
+        if (!push_back_str_vector(keys, key)) {
+            free_str_vector(keys);
+            return NULL;
         }
     }
     
@@ -1988,22 +2908,19 @@ dict_t* count_words(const string_t* str, const char* delim) {
         free_dict(word_count);
         return NULL;  // errno set by tokenize_string
     }
-    for (size_t i = 0; i < tokens->len; i++) {
-        printf("%s\n", get_string(str_vector_index(tokens, i)));
-    }
-    // Process each token
+    // Process each token, the token's cached hash serves all three lookups
     for (size_t i = 0; i < str_vector_size(tokens); i++) {
-        const char* word = get_string(str_vector_index(tokens, i));
-        if (is_key_value(word_count, word)) {
-            size_t current_count = get_dict_value(word_count, (char*)word);
-            if (!update_dict(word_count, (char*)word, current_count + 1)) {
+        const string_t* word = str_vector_index(tokens, i);
+        if (is_key_value_string(word_count, word)) {
+            size_t current_count = get_dict_value_string(word_count, word);
+            if (!update_dict_string(word_count, word, current_count + 1)) {
                 free_str_vector(tokens);
                 free_dict(word_count);
                 return NULL;
             }
         }
         else {
-            if(!insert_dict(word_count, word, 1)) {
+            if(!insert_dict_string(word_count, word, 1)) {
                 free_str_vector(tokens);
                 free_dict(word_count);
                 return NULL;
@@ -2016,6 +2933,85 @@ dict_t* count_words(const string_t* str, const char* delim) {
 }
 // -------------------------------------------------------------------------------- 
 
+// Drops the strings marked in drop, freeing them and sliding the rest down once
+static size_t _compact_str_vector(string_v* vec, const bool* drop) {
+    size_t kept = 0;
+    for (size_t i = 0; i < vec->len; i++) {
+        if (drop[i]) {
+            _release_str(&vec->data[i]);
+        } else {
+            vec->data[kept++] = vec->data[i];
+        }
+    }
+    size_t removed = vec->len - kept;
+    memset(vec->data + kept, 0, removed * sizeof(string_t));
+    vec->len = kept;
+    return removed;
+}
+// --------------------------------------------------------------------------------
+
+size_t unique_str_vector(string_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (vec->len < 2) return 0;
+    
+    sort_str_vector(vec, FORWARD);
+    // Compare each string with the last one kept, equal ones are adjacent now.
+    // Compacting here rather than through _compact_str_vector avoids a marks 
+    // array, so this dedupe never allocates and cannot fail on memory
+    size_t kept = 1;
+    size_t removed = 0;
+    for (size_t i = 1; i < vec->len; i++) {
+        string_t* last = &vec->data[kept - 1];
+        if (_equal_bytes(last->str, last->len, vec->data[i].str, vec->data[i].len)) {
+            _release_str(&vec->data[i]);
+            removed++;
+        } else {
+            vec->data[kept++] = vec->data[i];
+        }
+    }
+    memset(vec->data + kept, 0, removed * sizeof(string_t));
+    vec->len = kept;
+    return removed;
+}
+// --------------------------------------------------------------------------------
+
+size_t unique_ordered_str_vector(string_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (vec->len < 2) return 0;
+    
+    dict_t* seen = init_dict();
+    bool* drop = calloc(vec->len, sizeof(bool));
+    if (!seen || !drop || !reserve_dict(seen, vec->len)) {
+        if (seen) free_dict(seen);
+        free(drop);
+        errno = ENOMEM;
+        return LONG_MAX;
+    }
+    for (size_t i = 0; i < vec->len; i++) {
+        string_t* str = &vec->data[i];
+        size_t hash = string_hash(str);
+        if (_dict_find(seen, str->str, str->len, hash)) {
+            drop[i] = true;
+        } else if (!_dict_insert(seen, str->str, str->len, hash, i, false)) {
+            // Keys are borrowed from the vector, so this can only fail on memory
+            free_dict(seen);
+            free(drop);
+            return LONG_MAX;
+        }
+    }
+    free_dict(seen);
+    size_t removed = _compact_str_vector(vec, drop);
+    free(drop);
+    return removed;
+}
+// --------------------------------------------------------------------------------
+
 size_t binary_search_str_vector(string_v* vec, char* value, bool sort_first) {
    if (!vec || !vec->data || !value) {
        errno = EINVAL;
@@ -2027,7 +3023,7 @@ size_t binary_search_str_vector(string_v* vec, char* value, bool sort_first) {
        return LONG_MAX;
    }
    
-   // Sort if requested
+   // Sort if requested, a no-op when the vector is already known to be sorted
    if (sort_first) {
        sort_str_vector(vec, FORWARD);
    }
@@ -2055,6 +3051,4902 @@ size_t binary_search_str_vector(string_v* vec, char* value, bool sort_first) {
    
    return LONG_MAX;  // Value not found
 }
+// --------------------------------------------------------------------------------
+
+/*
+ * Binary search for the first element not less than key (upper == false) or 
+ * greater than key (upper == true).  With prefix set, elements are cut to the 
+ * key length before comparing, so every string starting with key compares 
+ * equal and the two bounds bracket them.
+ */
+static size_t _bound_str_vector(const string_v* vec, const char* key, size_t len, 
+                                bool upper, bool prefix) {
+    size_t lo = 0;
+    size_t hi = vec->len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const string_t* str = &vec->data[mid];
+        size_t str_len = (prefix && str->len > len) ? len : str->len;
+        int cmp = _compare_bytes(str->str, str_len, key, len);
+        if (cmp < 0 || (upper && cmp == 0)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+// --------------------------------------------------------------------------------
+
+size_t lower_bound_str_vector(string_v* vec, const char* value, bool sort_first) {
+    if (!vec || !vec->data || !value) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (sort_first) {
+        sort_str_vector(vec, FORWARD);
+    }
+    return _bound_str_vector(vec, value, strlen(value), false, false);
+}
+// --------------------------------------------------------------------------------
+
+size_t upper_bound_str_vector(string_v* vec, const char* value, bool sort_first) {
+    if (!vec || !vec->data || !value) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (sort_first) {
+        sort_str_vector(vec, FORWARD);
+    }
+    return _bound_str_vector(vec, value, strlen(value), true, false);
+}
+// --------------------------------------------------------------------------------
+
+bool prefix_range_str_vector(string_v* vec, const char* prefix, bool sort_first, 
+                             size_t* first, size_t* last) {
+    if (!vec || !vec->data || !prefix || !first || !last) {
+        errno = EINVAL;
+        return false;
+    }
+    if (sort_first) {
+        sort_str_vector(vec, FORWARD);
+    }
+    size_t len = strlen(prefix);
+    *first = _bound_str_vector(vec, prefix, len, false, true);
+    *last = _bound_str_vector(vec, prefix, len, true, true);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool is_str_vector_sorted(const string_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return false;
+    }
+    return vec->sorted;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the first index in [lo, hi) whose string is not less than key.  
+ * When gallop is set the probe distance doubles until it overshoots and a 
+ * binary search finishes the job, so skipping a run of length d costs 
+ * O(log d) compares instead of d.
+ */
+static size_t _advance_str(const string_t* data, size_t lo, size_t hi, 
+                           const string_t* key, bool gallop) {
+    if (!gallop) {
+        while (lo < hi && _cmp_str(&data[lo], key) < 0) lo++;
+        return lo;
+    }
+    size_t left = lo;
+    size_t right = lo;
+    size_t step = 1;
+    while (right < hi && _cmp_str(&data[right], key) < 0) {
+        left = right + 1;
+        right = lo + step;
+        step <<= 1;
+    }
+    if (right > hi) right = hi;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        if (_cmp_str(&data[mid], key) < 0) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    return left;
+}
+// --------------------------------------------------------------------------------
+
+static bool _skewed(size_t a, size_t b) {
+    if (a > b) return b == 0 || a / b >= SET_GALLOP_RATIO;
+    return a == 0 || b / a >= SET_GALLOP_RATIO;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Appends a selected element, collapsing repeats so the set operations 
+ * return each string once even when an input holds duplicates.
+ */
+static void _pick_str(const string_t** picks, size_t* count, const string_t* str) {
+    if (*count > 0) {
+        const string_t* last = picks[*count - 1];
+        if (_equal_bytes(last->str, last->len, str->str, str->len)) return;
+    }
+    picks[(*count)++] = str;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Builds the result of a set operation.  Every selected string is copied 
+ * into one arena owned by the vector, so the output costs two allocations 
+ * regardless of its length.  Elements borrow the arena (alloc == 0) and 
+ * keep the cached hash of their source.
+ */
+static string_v* _arena_str_vector(const string_t** picks, size_t count, bool sorted) {
+    string_v* vec = init_str_vector(count > 0 ? count : 1);
+    if (!vec) return NULL;
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        bytes += picks[i]->len + 1;
+    }
+    if (bytes == 0) {
+        vec->sorted = sorted;
+        return vec;
+    }
+    vec->arena = malloc(bytes);
+    if (!vec->arena) {
+        free_str_vector(vec);
+        errno = ENOMEM;
+        return NULL;
+    }
+    char* cursor = vec->arena;
+    for (size_t i = 0; i < count; i++) {
+        memcpy(cursor, picks[i]->str, picks[i]->len);
+        cursor[picks[i]->len] = '\0';
+        vec->data[i].str = cursor;
+        vec->data[i].len = picks[i]->len;
+        vec->data[i].alloc = 0;
+        vec->data[i].hash = picks[i]->hash;
+        cursor += picks[i]->len + 1;
+    }
+    vec->len = count;
+    vec->sorted = sorted;
+    return vec;
+}
+// --------------------------------------------------------------------------------
+
+typedef enum { SET_UNION, SET_INTERSECT, SET_DIFFERENCE } set_op;
+
+static string_v* _set_op_str_vector(const string_v* a, const string_v* b, set_op op) {
+    if (!a || !a->data || !b || !b->data) {
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t n = a->len;
+    size_t m = b->len;
+    size_t max = op == SET_UNION ? n + m : (op == SET_INTERSECT ? (n < m ? n : m) : n);
+    const string_t** picks = malloc((max > 0 ? max : 1) * sizeof(*picks));
+    if (!picks) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    bool gallop = _skewed(n, m);
+    size_t count = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < n && j < m) {
+        int cmp = _cmp_str(&a->data[i], &b->data[j]);
+        if (cmp < 0) {
+            // Every string in a[i, end) is absent from b
+            size_t end = _advance_str(a->data, i + 1, n, &b->data[j], gallop);
+            if (op != SET_INTERSECT) {
+                for (; i < end; i++) _pick_str(picks, &count, &a->data[i]);
+            }
+            i = end;
+        } else if (cmp > 0) {
+            size_t end = _advance_str(b->data, j + 1, m, &a->data[i], gallop);
+            if (op == SET_UNION) {
+                for (; j < end; j++) _pick_str(picks, &count, &b->data[j]);
+            }
+            j = end;
+        } else {
+            if (op != SET_DIFFERENCE) _pick_str(picks, &count, &a->data[i]);
+            i++;
+            // Leave b in place for the difference so repeats in a are dropped too
+            if (op != SET_DIFFERENCE) j++;
+        }
+    }
+    if (op != SET_INTERSECT) {
+        for (; i < n; i++) _pick_str(picks, &count, &a->data[i]);
+    }
+    if (op == SET_UNION) {
+        for (; j < m; j++) _pick_str(picks, &count, &b->data[j]);
+    }
+    string_v* result = _arena_str_vector(picks, count, a->sorted && b->sorted);
+    free(picks);
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+string_v* union_str_vector(const string_v* a, const string_v* b) {
+    return _set_op_str_vector(a, b, SET_UNION);
+}
+// --------------------------------------------------------------------------------
+
+string_v* intersect_str_vector(const string_v* a, const string_v* b) {
+    return _set_op_str_vector(a, b, SET_INTERSECT);
+}
+// --------------------------------------------------------------------------------
+
+string_v* difference_str_vector(const string_v* a, const string_v* b) {
+    return _set_op_str_vector(a, b, SET_DIFFERENCE);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Min-heap of input cursors keyed on each input's current head.  Ties fall 
+ * back to the input index so equal strings leave in input order.
+ */
+typedef struct {
+    const string_v* vec;
+    size_t pos;
+    size_t index;
+} mergeCursor;
+// --------------------------------------------------------------------------------
+
+static bool _cursor_less(const mergeCursor* x, const mergeCursor* y) {
+    int cmp = _cmp_str(&x->vec->data[x->pos], &y->vec->data[y->pos]);
+    return cmp < 0 || (cmp == 0 && x->index < y->index);
+}
+// --------------------------------------------------------------------------------
+
+static void _cursor_sift_down(mergeCursor* heap, size_t len, size_t i) {
+    for (;;) {
+        size_t smallest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < len && _cursor_less(&heap[left], &heap[smallest])) smallest = left;
+        if (right < len && _cursor_less(&heap[right], &heap[smallest])) smallest = right;
+        if (smallest == i) return;
+        mergeCursor tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+// --------------------------------------------------------------------------------
+
+string_v* k_way_merge_str_vector(const string_v* const* vecs, size_t k) {
+    if (!vecs || k == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t total = 0;
+    size_t shortest = SIZE_MAX;
+    size_t longest = 0;
+    for (size_t v = 0; v < k; v++) {
+        if (!vecs[v] || !vecs[v]->data) {
+            errno = EINVAL;
+            return NULL;
+        }
+        size_t len = vecs[v]->len;
+        total += len;
+        if (len > 0 && len < shortest) shortest = len;
+        if (len > longest) longest = len;
+    }
+    mergeCursor* heap = malloc(k * sizeof(*heap));
+    const string_t** picks = malloc((total > 0 ? total : 1) * sizeof(*picks));
+    if (!heap || !picks) {
+        free(heap);
+        free(picks);
+        errno = ENOMEM;
+        return NULL;
+    }
+    size_t heap_len = 0;
+    for (size_t v = 0; v < k; v++) {
+        if (vecs[v]->len > 0) {
+            heap[heap_len++] = (mergeCursor){vecs[v], 0, v};
+        }
+    }
+    for (size_t i = heap_len / 2; i-- > 0;) {
+        _cursor_sift_down(heap, heap_len, i);
+    }
+    bool gallop = total > 0 && _skewed(shortest, longest);
+    bool sorted = true;
+    for (size_t v = 0; v < k; v++) {
+        sorted = sorted && vecs[v]->sorted;
+    }
+    size_t count = 0;
+    while (heap_len > 0) {
+        mergeCursor* top = &heap[0];
+        const string_t* data = top->vec->data;
+        size_t len = top->vec->len;
+        size_t end = len;
+        if (heap_len > 1) {
+            // The run from the top input ends at the next smallest head
+            const mergeCursor* next = &heap[1];
+            if (heap_len > 2 && _cursor_less(&heap[2], next)) next = &heap[2];
+            end = _advance_str(data, top->pos + 1, len, 
+                               &next->vec->data[next->pos], gallop);
+        }
+        for (size_t i = top->pos; i < end; i++) {
+            picks[count++] = &data[i];
+        }
+        top->pos = end;
+        if (top->pos == len) {
+            heap[0] = heap[--heap_len];
+        }
+        _cursor_sift_down(heap, heap_len, 0);
+    }
+    string_v* result = _arena_str_vector(picks, count, sorted);
+    free(heap);
+    free(picks);
+    return result;
+}
+// ================================================================================
+// ================================================================================ 
+// INTERN POOL IMPLEMENTATION
+
+typedef struct internNode {
+    string_t str;             // Handle returned to callers, hash precomputed
+    struct internNode* next;
+} internNode;
+// --------------------------------------------------------------------------------
+
+struct intern_pool_t {
+    internNode** buckets;
+    size_t len;
+    size_t alloc;
+    rw_lock lock;
+};
+// --------------------------------------------------------------------------------
+
+static internNode* _intern_find(const intern_pool_t* pool, const char* str, 
+                                size_t len, size_t hash) {
+    internNode* current = pool->buckets[hash & (pool->alloc - 1)];
+    while (current) {
+        if (current->str.hash == hash && 
+            _equal_bytes(current->str.str, current->str.len, str, len)) {
+            return current;
+        }
+        current = current->next;
+    }
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+static bool _resize_intern_pool(intern_pool_t* pool, size_t new_size) {
+    internNode** new_table = calloc(new_size, sizeof(internNode*));
+    if (!new_table) {
+        errno = ENOMEM;
+        return false;
+    }
+    // Hashes are stored with each node, so nothing is rehashed
+    for (size_t i = 0; i < pool->alloc; i++) {
+        internNode* current = pool->buckets[i];
+        while (current) {
+            internNode* next = current->next;
+            size_t new_index = current->str.hash & (new_size - 1);
+            current->next = new_table[new_index];
+            new_table[new_index] = current;
+            current = next;
+        }
+    }
+    free(pool->buckets);
+    pool->buckets = new_table;
+    pool->alloc = new_size;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+intern_pool_t* init_intern_pool() {
+    intern_pool_t* pool = malloc(sizeof(*pool));
+    if (!pool) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_intern_pool() function\n");
+        return NULL;
+    }
+    pool->buckets = calloc(hashSize, sizeof(internNode*));
+    if (!pool->buckets) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_intern_pool() function\n");
+        free(pool);
+        return NULL;
+    }
+    pool->len = 0;
+    pool->alloc = hashSize;
+    _rw_init(&pool->lock);
+    return pool;
+}
+// --------------------------------------------------------------------------------
+
+const string_t* intern_string(intern_pool_t* pool, const char* str) {
+    if (!pool || !str) {
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t len = strlen(str);
+    size_t hash = hash_function(str, len);
+
+    // Fast path, the string is almost always interned already
+    _rw_read_lock(&pool->lock);
+    internNode* node = _intern_find(pool, str, len, hash);
+    _rw_read_unlock(&pool->lock);
+    if (node) return &node->str;
+
+    _rw_write_lock(&pool->lock);
+    // Another thread may have interned the string between the two locks
+    node = _intern_find(pool, str, len, hash);
+    if (node) {
+        _rw_write_unlock(&pool->lock);
+        return &node->str;
+    }
+    if (pool->len >= pool->alloc * LOAD_FACTOR_THRESHOLD) {
+        if (!_resize_intern_pool(pool, pool->alloc * 2)) {
+            _rw_write_unlock(&pool->lock);
+            return NULL;
+        }
+    }
+    node = malloc(sizeof(*node));
+    char* buffer = malloc(len + 1);
+    if (!node || !buffer) {
+        free(node);
+        free(buffer);
+        _rw_write_unlock(&pool->lock);
+        errno = ENOMEM;
+        return NULL;
+    }
+    memcpy(buffer, str, len + 1);
+    node->str.str = buffer;
+    node->str.len = len;
+    node->str.alloc = len + 1;
+    node->str.hash = hash;
+    size_t index = hash & (pool->alloc - 1);
+    node->next = pool->buckets[index];
+    pool->buckets[index] = node;
+    pool->len++;
+    _rw_write_unlock(&pool->lock);
+    return &node->str;
+}
+// --------------------------------------------------------------------------------
+
+const string_t* intern_lookup(intern_pool_t* pool, const char* str) {
+    if (!pool || !str) {
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t len = strlen(str);
+    size_t hash = hash_function(str, len);
+    _rw_read_lock(&pool->lock);
+    internNode* node = _intern_find(pool, str, len, hash);
+    _rw_read_unlock(&pool->lock);
+    return node ? &node->str : NULL;
+}
+// --------------------------------------------------------------------------------
+
+const size_t intern_pool_size(intern_pool_t* pool) {
+    if (!pool) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    _rw_read_lock(&pool->lock);
+    size_t len = pool->len;
+    _rw_read_unlock(&pool->lock);
+    return len;
+}
+// --------------------------------------------------------------------------------
+
+void free_intern_pool(intern_pool_t* pool) {
+    if (!pool) {
+        errno = EINVAL;
+        return;
+    }
+    for (size_t i = 0; i < pool->alloc; i++) {
+        internNode* current = pool->buckets[i];
+        while (current) {
+            internNode* next = current->next;
+            free(current->str.str);
+            free(current);
+            current = next;
+        }
+    }
+    _rw_destroy(&pool->lock);
+    free(pool->buckets);
+    free(pool);
+}
+// --------------------------------------------------------------------------------
+
+void _free_intern_pool(intern_pool_t** pool) {
+    if (pool && *pool) {
+        free_intern_pool(*pool);
+        *pool = NULL;
+    }
+}
+// --------------------------------------------------------------------------------
+
+bool insert_dict_interned(dict_t* dict, const string_t* handle, size_t value) {
+    if (!dict || !handle || !handle->str) {
+        errno = EINVAL;
+        return false;
+    }
+    // Borrow the pool's buffer and precomputed hash rather than copying
+    return _dict_insert(dict, handle->str, handle->len, _dict_string_hash(dict, handle), 
+                        value, false);
+}
+// --------------------------------------------------------------------------------
+
+bool push_back_interned_str_vector(string_v* vec, const string_t* handle) {
+    if (!vec || !vec->data || !handle || !handle->str) {
+        errno = EINVAL;
+        return false;
+    }
+    if (vec->len >= vec->alloc) {
+        size_t new_alloc = vec->alloc == 0 ? 1 : vec->alloc;
+        if (new_alloc < VEC_THRESHOLD) {
+            new_alloc *= 2;
+        } else {
+            new_alloc += VEC_FIXED_AMOUNT;
+        }
+        string_t* new_data = realloc(vec->data, new_alloc * sizeof(string_t));
+        if (!new_data) {
+            errno = ENOMEM;
+            return false;
+        }
+        memset(new_data + vec->alloc, 0, (new_alloc - vec->alloc) * sizeof(string_t));
+        vec->data = new_data;
+        vec->alloc = new_alloc;
+    }
+    // alloc == 0 marks the buffer as borrowed from the pool
+    vec->data[vec->len].str = handle->str;
+    vec->data[vec->len].len = handle->len;
+    vec->data[vec->len].alloc = 0;
+    vec->data[vec->len].hash = handle->hash;
+    vec->len++;
+    vec->sorted = vec->sorted && _in_order_at(vec, vec->len - 1);
+    return true;
+}
+// ================================================================================
+// ================================================================================
+// CONCURRENT DICTIONARY IMPLEMENTATION
+
+/*
+ * Each shard is an ordinary dict_t behind its own lock.  The key hash is 
+ * computed once: its high bits pick the shard and the full hash is handed to 
+ * the shard, whose buckets are indexed by the low bits.  Shards are padded so 
+ * two locks never share a cache line.
+ */
+typedef union {
+    struct {
+        rw_lock lock;
+        dict_t* dict;
+    } s;
+    unsigned char pad[128];
+} dictShard;
+// --------------------------------------------------------------------------------
+
+struct concurrent_dict_t {
+    dictShard* shards;
+    size_t count;          // Always a power of two
+    void* raw;             // Unaligned allocation behind shards
+};
+// --------------------------------------------------------------------------------
+
+static dictShard* _shard_for(const concurrent_dict_t* dict, size_t hash) {
+    size_t index = (hash >> (sizeof(size_t) * 4)) & (dict->count - 1);
+    return &dict->shards[index];
+}
+// --------------------------------------------------------------------------------
+
+concurrent_dict_t* init_concurrent_dict(size_t shards) {
+    if (shards == 0) {
+        shards = DICT_DEFAULT_SHARDS;
+    }
+    size_t count = 1;
+    while (count < shards) {
+        if (count > SIZE_MAX / 2 / sizeof(dictShard)) {
+            errno = EINVAL;
+            return NULL;
+        }
+        count *= 2;
+    }
+    concurrent_dict_t* dict = malloc(sizeof(*dict));
+    if (!dict) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_concurrent_dict() function\n");
+        return NULL;
+    }
+    // Over-allocate so the shard array can start on a cache line
+    dict->raw = malloc(count * sizeof(dictShard) + 64);
+    if (!dict->raw) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_concurrent_dict() function\n");
+        free(dict);
+        return NULL;
+    }
+    dict->shards = (dictShard*)(((uintptr_t)dict->raw + 63) & ~(uintptr_t)63);
+    dict->count = count;
+    for (size_t i = 0; i < count; i++) {
+        dict->shards[i].s.dict = init_dict();
+        if (!dict->shards[i].s.dict) {
+            for (size_t j = 0; j < i; j++) {
+                _rw_destroy(&dict->shards[j].s.lock);
+                free_dict(dict->shards[j].s.dict);
+            }
+            free(dict->raw);
+            free(dict);
+            errno = ENOMEM;
+            return NULL;
+        }
+        _rw_init(&dict->shards[i].s.lock);
+    }
+    return dict;
+}
+// --------------------------------------------------------------------------------
+
+bool insert_concurrent_dict(concurrent_dict_t* dict, const char* key, size_t value) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t key_len = strlen(key);
+    size_t hash = hash_function(key, key_len);
+    dictShard* shard = _shard_for(dict, hash);
+    _rw_write_lock(&shard->s.lock);
+    bool result = _dict_insert(shard->s.dict, key, key_len, hash, value, true);
+    _rw_write_unlock(&shard->s.lock);
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+size_t increment_concurrent_dict(concurrent_dict_t* dict, const char* key, size_t delta) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t key_len = strlen(key);
+    size_t hash = hash_function(key, key_len);
+    dictShard* shard = _shard_for(dict, hash);
+    size_t result = delta;
+    _rw_write_lock(&shard->s.lock);
+    dictNode* node = _dict_find(shard->s.dict, key, key_len, hash);
+    if (node) {
+        node->value += delta;
+        result = node->value;
+    } else if (!_dict_insert(shard->s.dict, key, key_len, hash, delta, true)) {
+        result = LONG_MAX;
+    }
+    _rw_write_unlock(&shard->s.lock);
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+size_t get_concurrent_dict_value(concurrent_dict_t* dict, const char* key) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t key_len = strlen(key);
+    size_t hash = hash_function(key, key_len);
+    dictShard* shard = _shard_for(dict, hash);
+    size_t result = LONG_MAX;
+    _rw_read_lock(&shard->s.lock);
+    dictNode* node = _dict_find(shard->s.dict, key, key_len, hash);
+    if (node) {
+        result = node->value;
+    }
+    _rw_read_unlock(&shard->s.lock);
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+size_t pop_concurrent_dict(concurrent_dict_t* dict, const char* key) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t key_len = strlen(key);
+    size_t hash = hash_function(key, key_len);
+    dictShard* shard = _shard_for(dict, hash);
+    size_t value;
+    _rw_write_lock(&shard->s.lock);
+    bool found = _dict_pop(shard->s.dict, key, key_len, hash, &value);
+    _rw_write_unlock(&shard->s.lock);
+    return found ? value : LONG_MAX;
+}
+// --------------------------------------------------------------------------------
+
+const size_t concurrent_dict_size(concurrent_dict_t* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t len = 0;
+    for (size_t i = 0; i < dict->count; i++) {
+        _rw_read_lock(&dict->shards[i].s.lock);
+        len += dict->shards[i].s.dict->len;
+        _rw_read_unlock(&dict->shards[i].s.lock);
+    }
+    return len;
+}
+// --------------------------------------------------------------------------------
+
+void free_concurrent_dict(concurrent_dict_t* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return;
+    }
+    for (size_t i = 0; i < dict->count; i++) {
+        _rw_destroy(&dict->shards[i].s.lock);
+        free_dict(dict->shards[i].s.dict);
+    }
+    free(dict->raw);
+    free(dict);
+}
+// --------------------------------------------------------------------------------
+
+void _free_concurrent_dict(concurrent_dict_t** dict) {
+    if (dict && *dict) {
+        free_concurrent_dict(*dict);
+        *dict = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// SNAPSHOT DICTIONARY IMPLEMENTATION
+
+/*
+ * Readers never lock.  A lookup records the current epoch in the reader's own 
+ * slot, loads the published dict, searches it, and clears the slot.  A writer 
+ * swaps in the new dict, advances the epoch, and frees the old dict only once 
+ * no slot still holds an epoch from before the swap.  Slots are padded so a 
+ * reader only ever writes to a cache line nobody else writes to.
+ */
+struct snapshot_reader_t {
+    atomic_size_t epoch;          // 0 while idle, otherwise the epoch entered
+    unsigned char pad[64];
+    snapshot_dict_t* owner;
+    struct snapshot_reader_t* next;
+};
+// --------------------------------------------------------------------------------
+
+struct snapshot_dict_t {
+    _Atomic(dict_t*) current;
+    atomic_size_t epoch;
+    rw_lock lock;                 // Serializes writers and reader registration
+    snapshot_reader_t* readers;
+};
+// --------------------------------------------------------------------------------
+
+snapshot_dict_t* init_snapshot_dict(dict_t* initial) {
+    snapshot_dict_t* snap = malloc(sizeof(*snap));
+    if (!snap) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_snapshot_dict() function\n");
+        return NULL;
+    }
+    if (!initial) {
+        initial = init_dict();
+        if (!initial) {
+            free(snap);
+            return NULL;
+        }
+    }
+    atomic_init(&snap->current, initial);
+    atomic_init(&snap->epoch, 1);
+    _rw_init(&snap->lock);
+    snap->readers = NULL;
+    return snap;
+}
+// --------------------------------------------------------------------------------
+
+snapshot_reader_t* register_snapshot_reader(snapshot_dict_t* snap) {
+    if (!snap) {
+        errno = EINVAL;
+        return NULL;
+    }
+    snapshot_reader_t* reader = malloc(sizeof(*reader));
+    if (!reader) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    atomic_init(&reader->epoch, 0);
+    reader->owner = snap;
+    _rw_write_lock(&snap->lock);
+    reader->next = snap->readers;
+    snap->readers = reader;
+    _rw_write_unlock(&snap->lock);
+    return reader;
+}
+// --------------------------------------------------------------------------------
+
+void unregister_snapshot_reader(snapshot_reader_t* reader) {
+    if (!reader) {
+        errno = EINVAL;
+        return;
+    }
+    snapshot_dict_t* snap = reader->owner;
+    _rw_write_lock(&snap->lock);
+    snapshot_reader_t** link = &snap->readers;
+    while (*link && *link != reader) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        *link = reader->next;
+    }
+    _rw_write_unlock(&snap->lock);
+    free(reader);
+}
+// --------------------------------------------------------------------------------
+
+size_t get_snapshot_dict_value(snapshot_reader_t* reader, const char* key) {
+    if (!reader || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    snapshot_dict_t* snap = reader->owner;
+    size_t key_len = strlen(key);
+    
+    // The slot must be visible before the pointer is read, hence seq_cst
+    atomic_store(&reader->epoch, atomic_load(&snap->epoch));
+    const dict_t* dict = atomic_load(&snap->current);
+    dictNode* node = _dict_find(dict, key, key_len, _dict_hash(dict, key, key_len));
+    size_t value = node ? node->value : LONG_MAX;
+    atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+    return value;
+}
+// --------------------------------------------------------------------------------
+
+bool publish_snapshot_dict(snapshot_dict_t* snap, dict_t* next) {
+    if (!snap || !next) {
+        errno = EINVAL;
+        return false;
+    }
+    _rw_write_lock(&snap->lock);
+    if (atomic_load(&snap->current) == next) {
+        _rw_write_unlock(&snap->lock);
+        errno = EINVAL;
+        return false;
+    }
+    dict_t* old = atomic_exchange(&snap->current, next);
+    size_t retired = atomic_fetch_add(&snap->epoch, 1);
+    
+    // Wait for readers that may have loaded the old pointer to leave
+    for (snapshot_reader_t* reader = snap->readers; reader; reader = reader->next) {
+        size_t seen = atomic_load(&reader->epoch);
+        while (seen != 0 && seen <= retired) {
+            _thread_yield();
+            seen = atomic_load(&reader->epoch);
+        }
+    }
+    _rw_write_unlock(&snap->lock);
+    free_dict(old);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+void free_snapshot_dict(snapshot_dict_t* snap) {
+    if (!snap) {
+        errno = EINVAL;
+        return;
+    }
+    snapshot_reader_t* reader = snap->readers;
+    while (reader) {
+        snapshot_reader_t* next = reader->next;
+        free(reader);
+        reader = next;
+    }
+    free_dict(atomic_load(&snap->current));
+    _rw_destroy(&snap->lock);
+    free(snap);
+}
+// --------------------------------------------------------------------------------
+
+void _free_snapshot_dict(snapshot_dict_t** snap) {
+    if (snap && *snap) {
+        free_snapshot_dict(*snap);
+        *snap = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// FROZEN DICTIONARY IMPLEMENTATION
+
+/*
+ * Minimal perfect hash in the CHD / hash-and-displace style.  One 64 bit hash 
+ * per key picks a bucket from its high half; each bucket stores a pilot chosen 
+ * at build time so that (hash ^ mix(pilot)) % len sends every key of the bucket 
+ * to a distinct free slot.  Buckets are placed largest first, while the table 
+ * is emptiest.  A lookup is one hash, one pilot load, one slot load and one 
+ * key compare.
+ */
+typedef struct {
+    size_t offset;      // Start of the key in keys
+    size_t key_len;
+    size_t value;
+} frozenSlot;
+// --------------------------------------------------------------------------------
+
+struct frozen_dict_t {
+    size_t len;
+    size_t buckets;
+    uint64_t seed;
+    uint32_t* pilots;
+    frozenSlot* slots;
+    char* keys;         // Every key, null terminated and packed in slot order
+};
+// --------------------------------------------------------------------------------
+
+static const size_t FROZEN_BUCKET_SIZE = 4;  // Average keys per bucket
+static const uint64_t FROZEN_PILOT_MIX = 0x9E3779B97F4A7C15ull;
+static const int FROZEN_MAX_SEEDS = 16;
+// --------------------------------------------------------------------------------
+
+static inline size_t _frozen_bucket(uint64_t hash, size_t buckets) {
+    return (size_t)(((hash >> 32) * (uint64_t)buckets) >> 32);
+}
+// --------------------------------------------------------------------------------
+
+static inline size_t _frozen_slot(uint64_t hash, uint32_t pilot, size_t len) {
+    // Multiply to spread the pilot into the high bits, then map without a divide
+    uint64_t mixed = (hash ^ ((uint64_t)pilot * FROZEN_PILOT_MIX)) * 0xBF58476D1CE4E5B9ull;
+    if (len <= UINT32_MAX) {
+        return (size_t)(((mixed >> 32) * (uint64_t)len) >> 32);
+    }
+    return (size_t)(mixed % len);
+}
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    uint64_t hash;
+    const dictNode* node;
+} frozenEntry;
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    size_t* start;          // Bucket b owns members[start[b], start[b + 1])
+    size_t* members;
+    size_t* order;          // Buckets, largest first
+    size_t* count;
+    unsigned char* taken;
+} frozenScratch;
+// --------------------------------------------------------------------------------
+
+// Chooses a pilot for every bucket.  False means this seed failed, try another
+static bool _frozen_place(frozen_dict_t* frozen, const frozenEntry* entries, 
+                          size_t* slot_of, frozenScratch* work) {
+    size_t n = frozen->len;
+    size_t nb = frozen->buckets;
+
+    // Group entries by bucket with a counting sort
+    memset(work->start, 0, (nb + 1) * sizeof(size_t));
+    for (size_t i = 0; i < n; i++) {
+        work->start[_frozen_bucket(entries[i].hash, nb) + 1]++;
+    }
+    size_t max_size = 0;
+    for (size_t b = 0; b < nb; b++) {
+        if (work->start[b + 1] > max_size) max_size = work->start[b + 1];
+        work->start[b + 1] += work->start[b];
+    }
+    memset(work->count, 0, nb * sizeof(size_t));
+    for (size_t i = 0; i < n; i++) {
+        size_t b = _frozen_bucket(entries[i].hash, nb);
+        work->members[work->start[b] + work->count[b]++] = i;
+    }
+
+    // Order buckets from largest to smallest, again by counting
+    memset(work->count, 0, (max_size + 2) * sizeof(size_t));
+    for (size_t b = 0; b < nb; b++) {
+        work->count[max_size - (work->start[b + 1] - work->start[b]) + 1]++;
+    }
+    for (size_t k = 0; k <= max_size; k++) {
+        work->count[k + 1] += work->count[k];
+    }
+    for (size_t b = 0; b < nb; b++) {
+        work->order[work->count[max_size - (work->start[b + 1] - work->start[b])]++] = b;
+    }
+
+    // The last singleton buckets need about n tries, allow several times that
+    uint64_t limit = (uint64_t)n * 8 + 1024;
+    if (limit > UINT32_MAX) limit = UINT32_MAX;
+
+    memset(work->taken, 0, n);
+    for (size_t k = 0; k < nb; k++) {
+        size_t b = work->order[k];
+        const size_t* first = work->members + work->start[b];
+        size_t size = work->start[b + 1] - work->start[b];
+        if (size == 0) break;
+        
+        uint32_t pilot = 0;
+        for (;;) {
+            size_t j = 0;
+            for (; j < size; j++) {
+                size_t slot = _frozen_slot(entries[first[j]].hash, pilot, n);
+                if (work->taken[slot]) break;
+                work->taken[slot] = 1;
+                slot_of[first[j]] = slot;
+            }
+            if (j == size) break;
+            // Release the slots claimed before the collision
+            while (j-- > 0) {
+                work->taken[slot_of[first[j]]] = 0;
+            }
+            if (++pilot >= limit) return false;
+        }
+        frozen->pilots[b] = pilot;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static const size_t* _frozen_find(const frozen_dict_t* frozen, const char* key, 
+                                  size_t key_len) {
+    if (frozen->len == 0) {
+        return NULL;
+    }
+    uint64_t hash = _wyhash(key, key_len, frozen->seed);
+    uint32_t pilot = frozen->pilots[_frozen_bucket(hash, frozen->buckets)];
+    const frozenSlot* slot = &frozen->slots[_frozen_slot(hash, pilot, frozen->len)];
+    if (_equal_bytes(frozen->keys + slot->offset, slot->key_len, key, key_len)) {
+        return &slot->value;
+    }
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+frozen_dict_t* freeze_dict(const dict_t* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return NULL;
+    }
+    frozen_dict_t* frozen = calloc(1, sizeof(*frozen));
+    if (!frozen) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in freeze_dict() function\n");
+        return NULL;
+    }
+    size_t n = dict->len;
+    size_t nb = n / FROZEN_BUCKET_SIZE + 1;
+    size_t key_bytes = 0;
+    size_t slot = 0;
+    dictNode* node = NULL;
+    while ((node = _dict_walk(dict, &slot, node))) {
+        key_bytes += node->key_len + 1;
+    }
+    frozen->len = n;
+    frozen->buckets = nb;
+    frozen->pilots = calloc(nb, sizeof(uint32_t));
+    frozen->slots = malloc((n + 1) * sizeof(frozenSlot));
+    frozen->keys = malloc(key_bytes + 1);
+    
+    frozenEntry* entries = malloc((n + 1) * sizeof(frozenEntry));
+    size_t* slot_of = malloc((n + 1) * sizeof(size_t));
+    frozenScratch work = {
+        .start = malloc((nb + 1) * sizeof(size_t)),
+        .members = malloc((n + 1) * sizeof(size_t)),
+        .order = malloc(nb * sizeof(size_t)),
+        .count = malloc((n > nb ? n + 2 : nb + 2) * sizeof(size_t)),
+        .taken = malloc(n + 1)
+    };
+    bool placed = false;
+    if (!frozen->pilots || !frozen->slots || !frozen->keys ||
+        !entries || !slot_of || !work.start || !work.members || !work.order || 
+        !work.count || !work.taken) {
+        errno = ENOMEM;
+        goto cleanup;
+    }
+
+    // A seed only fails when two keys of one bucket share a full 64 bit hash
+    for (int attempt = 0; attempt < FROZEN_MAX_SEEDS && !placed; attempt++) {
+        frozen->seed = (uint64_t)attempt * FROZEN_PILOT_MIX;
+        size_t i = 0;
+        slot = 0;
+        node = NULL;
+        while ((node = _dict_walk(dict, &slot, node))) {
+            entries[i].hash = _wyhash(node->key, node->key_len, frozen->seed);
+            entries[i].node = node;
+            i++;
+        }
+        memset(frozen->pilots, 0, nb * sizeof(uint32_t));
+        placed = _frozen_place(frozen, entries, slot_of, &work);
+    }
+    if (!placed) {
+        errno = EINVAL;
+        goto cleanup;
+    }
+
+    // Pack keys and values in slot order so a lookup touches one slot
+    for (size_t i = 0; i < n; i++) {
+        work.members[slot_of[i]] = i;
+    }
+    size_t offset = 0;
+    for (size_t pos = 0; pos < n; pos++) {
+        const dictNode* entry = entries[work.members[pos]].node;
+        frozen->slots[pos].offset = offset;
+        frozen->slots[pos].key_len = entry->key_len;
+        frozen->slots[pos].value = entry->value;
+        memcpy(frozen->keys + offset, entry->key, entry->key_len);
+        frozen->keys[offset + entry->key_len] = '\0';
+        offset += entry->key_len + 1;
+    }
+
+cleanup:
+    free(entries);
+    free(slot_of);
+    free(work.start);
+    free(work.members);
+    free(work.order);
+    free(work.count);
+    free(work.taken);
+    if (!placed) {
+        free_frozen_dict(frozen);
+        return NULL;
+    }
+    return frozen;
+}
+// --------------------------------------------------------------------------------
+
+size_t get_frozen_dict_value(const frozen_dict_t* frozen, const char* key) {
+    if (!frozen || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    const size_t* value = _frozen_find(frozen, key, strlen(key));
+    return value ? *value : LONG_MAX;
+}
+// --------------------------------------------------------------------------------
+
+bool is_frozen_key_value(const frozen_dict_t* frozen, const char* key) {
+    if (!frozen || !key) {
+        errno = EINVAL;
+        return false;
+    }
+    return _frozen_find(frozen, key, strlen(key)) != NULL;
+}
+// --------------------------------------------------------------------------------
+
+const size_t frozen_dict_size(const frozen_dict_t* frozen) {
+    if (!frozen) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return frozen->len;
+}
+// --------------------------------------------------------------------------------
+
+void free_frozen_dict(frozen_dict_t* frozen) {
+    if (!frozen) {
+        errno = EINVAL;
+        return;
+    }
+    free(frozen->pilots);
+    free(frozen->slots);
+    free(frozen->keys);
+    free(frozen);
+}
+// --------------------------------------------------------------------------------
+
+void _free_frozen_dict(frozen_dict_t** frozen) {
+    if (frozen && *frozen) {
+        free_frozen_dict(*frozen);
+        *frozen = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// WORD SKETCH IMPLEMENTATION
+
+/*
+ * Count-Min sketch for frequencies plus a bounded min-heap of the heaviest 
+ * words.  Each word is hashed once to 64 bits whatever the width of size_t; 
+ * rows are indexed by double hashing from the two halves of that hash, and 
+ * the same hash keys the private dict that maps a monitored word to its heap 
+ * slot.  In the Space-Saving manner a new 
+ * word displaces the smallest monitored one, but it enters with its sketch 
+ * estimate rather than the evicted count, so the overcount stays within the 
+ * sketch's epsilon bound whatever order the words arrive in.
+ */
+typedef struct {
+    dictNode* node;     // Key lives in the index dict, node->value is the heap slot
+    uint64_t hash;      // Full sketch hash, node->hash may be truncated to size_t
+    size_t count;
+} sketchItem;
+// --------------------------------------------------------------------------------
+
+struct word_sketch_t {
+    size_t width;       // Counters per row, a power of two
+    size_t depth;
+    size_t* counters;
+    size_t total;
+    size_t k;
+    size_t len;
+    sketchItem* heap;
+    dict_t* index;
+};
+// --------------------------------------------------------------------------------
+
+static const double SKETCH_E = 2.718281828459045;
+// --------------------------------------------------------------------------------
+
+static inline size_t _sketch_cell(const word_sketch_t* sketch, uint64_t hash, size_t row) {
+    uint64_t step = (hash >> 32) | 1;
+    return row * sketch->width + (size_t)((hash + row * step) & (sketch->width - 1));
+}
+// --------------------------------------------------------------------------------
+
+static size_t _sketch_estimate(const word_sketch_t* sketch, uint64_t hash) {
+    size_t estimate = SIZE_MAX;
+    for (size_t row = 0; row < sketch->depth; row++) {
+        size_t value = sketch->counters[_sketch_cell(sketch, hash, row)];
+        if (value < estimate) estimate = value;
+    }
+    return estimate;
+}
+// --------------------------------------------------------------------------------
+
+static void _sketch_swap(word_sketch_t* sketch, size_t a, size_t b) {
+    sketchItem tmp = sketch->heap[a];
+    sketch->heap[a] = sketch->heap[b];
+    sketch->heap[b] = tmp;
+    sketch->heap[a].node->value = a;
+    sketch->heap[b].node->value = b;
+}
+// --------------------------------------------------------------------------------
+
+static void _sketch_sift_down(word_sketch_t* sketch, size_t i) {
+    for (;;) {
+        size_t low = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < sketch->len && sketch->heap[left].count < sketch->heap[low].count) low = left;
+        if (right < sketch->len && sketch->heap[right].count < sketch->heap[low].count) low = right;
+        if (low == i) return;
+        _sketch_swap(sketch, i, low);
+        i = low;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static void _sketch_sift_up(word_sketch_t* sketch, size_t i) {
+    while (i > 0 && sketch->heap[i].count < sketch->heap[(i - 1) / 2].count) {
+        _sketch_swap(sketch, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+// --------------------------------------------------------------------------------
+
+// Keeps the k words with the largest sketch estimates in the heap
+static bool _sketch_track(word_sketch_t* sketch, const char* word, size_t len, 
+                          uint64_t hash, size_t estimate) {
+    dictNode* node = _dict_find(sketch->index, word, len, (size_t)hash);
+    if (node) {
+        // Estimates only grow, so the word can only move away from the root
+        sketch->heap[node->value].count = estimate;
+        _sketch_sift_down(sketch, node->value);
+        return true;
+    }
+    size_t slot = sketch->len;
+    if (sketch->len == sketch->k) {
+        if (estimate <= sketch->heap[0].count) {
+            return true;
+        }
+        dictNode* evicted = sketch->heap[0].node;
+        size_t unused;
+        _dict_pop(sketch->index, evicted->key, evicted->key_len, evicted->hash, &unused);
+        slot = 0;
+    }
+    if (!_dict_insert(sketch->index, word, len, (size_t)hash, slot, true)) {
+        if (slot == 0 && sketch->len > 0) {
+            // The evicted slot is gone, close the hole so the heap stays valid
+            sketch->len--;
+            if (sketch->len > 0) {
+                sketch->heap[0] = sketch->heap[sketch->len];
+                sketch->heap[0].node->value = 0;
+                _sketch_sift_down(sketch, 0);
+            }
+        }
+        return false;
+    }
+    if (slot == sketch->len) {
+        sketch->len++;
+    }
+    sketch->heap[slot].node = _dict_find(sketch->index, word, len, (size_t)hash);
+    sketch->heap[slot].hash = hash;
+    sketch->heap[slot].count = estimate;
+    if (slot == 0) {
+        _sketch_sift_down(sketch, 0);
+    } else {
+        _sketch_sift_up(sketch, slot);
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static bool _sketch_add(word_sketch_t* sketch, const char* word, size_t len, size_t count) {
+    uint64_t hash = _wyhash(word, len, 0);
+    size_t estimate = SIZE_MAX;
+    for (size_t row = 0; row < sketch->depth; row++) {
+        size_t* cell = &sketch->counters[_sketch_cell(sketch, hash, row)];
+        *cell += count;
+        if (*cell < estimate) estimate = *cell;
+    }
+    sketch->total += count;
+    return _sketch_track(sketch, word, len, hash, estimate);
+}
+// --------------------------------------------------------------------------------
+
+word_sketch_t* init_word_sketch(double epsilon, double delta, size_t k) {
+    if (!(epsilon > 0.0 && epsilon < 1.0) || !(delta > 0.0 && delta < 1.0) || k == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    // width >= e / epsilon and depth >= ln(1 / delta) give the Count-Min bounds
+    double target = SKETCH_E / epsilon;
+    if (target > (double)(SIZE_MAX / 2 + 1) || k > SIZE_MAX / sizeof(sketchItem)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t width = 1;
+    while ((double)width < target) {
+        width *= 2;
+    }
+    size_t depth = 1;
+    for (double miss = 1.0 / SKETCH_E; miss > delta; miss /= SKETCH_E) {
+        depth++;
+    }
+    if (width > SIZE_MAX / depth / sizeof(size_t)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    word_sketch_t* sketch = calloc(1, sizeof(*sketch));
+    if (!sketch) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_word_sketch() function\n");
+        return NULL;
+    }
+    sketch->width = width;
+    sketch->depth = depth;
+    sketch->k = k;
+    sketch->counters = calloc(width * depth, sizeof(size_t));
+    sketch->heap = malloc(k * sizeof(sketchItem));
+    sketch->index = init_dict();
+    if (!sketch->counters || !sketch->heap || !sketch->index || 
+        !reserve_dict(sketch->index, k)) {
+        free_word_sketch(sketch);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return sketch;
+}
+// --------------------------------------------------------------------------------
+
+bool add_word_sketch(word_sketch_t* sketch, const char* word, size_t count) {
+    if (!sketch || !word) {
+        errno = EINVAL;
+        return false;
+    }
+    return _sketch_add(sketch, word, strlen(word), count);
+}
+// --------------------------------------------------------------------------------
+
+bool count_words_sketch(word_sketch_t* sketch, const string_t* str, const char* delim) {
+    if (!sketch || !str || !str->str || !delim) {
+        errno = EINVAL;
+        return false;
+    }
+    bool delims[256];
+    _delim_table(delim, delims);
+    const char* cursor = str->str;
+    const char* end = str->str + str->len;
+    const char* word;
+    size_t len;
+    while ((word = _next_token(&cursor, end, delims, &len))) {
+        if (!_sketch_add(sketch, word, len, 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t word_sketch_estimate(const word_sketch_t* sketch, const char* word) {
+    if (!sketch || !word) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t len = strlen(word);
+    return _sketch_estimate(sketch, _wyhash(word, len, 0));
+}
+// --------------------------------------------------------------------------------
+
+const size_t word_sketch_total(const word_sketch_t* sketch) {
+    if (!sketch) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return sketch->total;
+}
+// --------------------------------------------------------------------------------
+
+static int _entry_rank(const void* a, const void* b) {
+    const dict_entry_t* x = a;
+    const dict_entry_t* y = b;
+    if (x->value != y->value) {
+        return x->value > y->value ? -1 : 1;
+    }
+    return _compare_bytes(x->key, x->key_len, y->key, y->key_len);
+}
+// --------------------------------------------------------------------------------
+
+size_t word_sketch_top_k(const word_sketch_t* sketch, size_t k, dict_entry_t* out) {
+    if (!sketch || (!out && k > 0)) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (k == 0) {
+        return 0;
+    }
+    // Both counts only over-estimate, so the smaller one is the better answer
+    dict_entry_t* all = malloc((sketch->len + 1) * sizeof(dict_entry_t));
+    if (!all) {
+        errno = ENOMEM;
+        return LONG_MAX;
+    }
+    for (size_t i = 0; i < sketch->len; i++) {
+        const dictNode* node = sketch->heap[i].node;
+        size_t estimate = _sketch_estimate(sketch, sketch->heap[i].hash);
+        all[i].key = node->key;
+        all[i].key_len = node->key_len;
+        all[i].value = estimate < sketch->heap[i].count ? estimate : sketch->heap[i].count;
+    }
+    qsort(all, sketch->len, sizeof(dict_entry_t), _entry_rank);
+    size_t found = k < sketch->len ? k : sketch->len;
+    memcpy(out, all, found * sizeof(dict_entry_t));
+    free(all);
+    return found;
+}
+// --------------------------------------------------------------------------------
+
+// Estimate under the sum of both sketches without modifying either
+static size_t _sketch_merged_estimate(const word_sketch_t* dst, const word_sketch_t* src, 
+                                      uint64_t hash) {
+    size_t estimate = SIZE_MAX;
+    for (size_t row = 0; row < dst->depth; row++) {
+        size_t cell = _sketch_cell(dst, hash, row);
+        size_t value = dst->counters[cell] + src->counters[cell];
+        if (value < estimate) estimate = value;
+    }
+    return estimate;
+}
+// --------------------------------------------------------------------------------
+
+static int _sketch_item_rank(const void* a, const void* b) {
+    const sketchItem* x = a;
+    const sketchItem* y = b;
+    if (x->count != y->count) {
+        return x->count > y->count ? -1 : 1;
+    }
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+bool merge_word_sketch(word_sketch_t* dst, const word_sketch_t* src) {
+    if (!dst || !src || dst == src || dst->width != src->width || dst->depth != src->depth) {
+        errno = EINVAL;
+        return false;
+    }
+    // Everything that can fail happens before dst is touched, so a failed 
+    // merge leaves it as it was and the caller may simply retry
+    size_t pool = dst->len + src->len;
+    sketchItem* candidates = malloc((pool + 1) * sizeof(sketchItem));
+    dict_t* index = init_dict();
+    if (!candidates || !index || !reserve_dict(index, dst->k)) {
+        free(candidates);
+        if (index) free_dict(index);
+        errno = ENOMEM;
+        return false;
+    }
+    size_t count = 0;
+    for (size_t s = 0; s < 2; s++) {
+        const word_sketch_t* from = s == 0 ? dst : src;
+        for (size_t i = 0; i < from->len; i++) {
+            const sketchItem* item = &from->heap[i];
+            dictNode* node = item->node;
+            if (s == 1 && _dict_find(dst->index, node->key, node->key_len, (size_t)item->hash)) {
+                continue;
+            }
+            candidates[count].node = node;
+            candidates[count].hash = item->hash;
+            candidates[count].count = _sketch_merged_estimate(dst, src, item->hash);
+            count++;
+        }
+    }
+    // Keep the k largest, sorting at most 2k candidates is cheap
+    qsort(candidates, count, sizeof(sketchItem), _sketch_item_rank);
+    size_t keep = count < dst->k ? count : dst->k;
+    for (size_t i = 0; i < keep; i++) {
+        dictNode* node = candidates[i].node;
+        size_t hash = (size_t)candidates[i].hash;
+        if (!_dict_insert(index, node->key, node->key_len, hash, i, true)) {
+            free(candidates);
+            free_dict(index);
+            return false;
+        }
+        candidates[i].node = _dict_find(index, node->key, node->key_len, hash);
+    }
+    for (size_t i = 0; i < dst->width * dst->depth; i++) {
+        dst->counters[i] += src->counters[i];
+    }
+    dst->total += src->total;
+    free_dict(dst->index);
+    dst->index = index;
+    dst->len = keep;
+    // Descending order is already a valid min-heap once reversed
+    for (size_t i = 0; i < keep; i++) {
+        dst->heap[i] = candidates[keep - 1 - i];
+        dst->heap[i].node->value = i;
+    }
+    free(candidates);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+void free_word_sketch(word_sketch_t* sketch) {
+    if (!sketch) {
+        errno = EINVAL;
+        return;
+    }
+    free(sketch->counters);
+    free(sketch->heap);
+    if (sketch->index) {
+        free_dict(sketch->index);
+    }
+    free(sketch);
+}
+// --------------------------------------------------------------------------------
+
+void _free_word_sketch(word_sketch_t** sketch) {
+    if (sketch && *sketch) {
+        free_word_sketch(*sketch);
+        *sketch = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// HYPERLOGLOG IMPLEMENTATION
+
+/*
+ * Classic HyperLogLog: the top p bits of a 64 bit token hash choose one of 
+ * 2^p byte registers, which keeps the longest run of leading zeros seen in the 
+ * remaining bits.  Registers are plain bytes so merging is a bytewise max.
+ */
+struct hll_t {
+    uint8_t precision;
+    size_t len;             // 2^precision registers
+    uint8_t* registers;
+};
+// --------------------------------------------------------------------------------
+
+static const unsigned int HLL_MIN_PRECISION = 4;
+static const unsigned int HLL_MAX_PRECISION = 18;
+static const unsigned char HLL_MAGIC[3] = {'H', 'L', 'L'};
+static const unsigned char HLL_VERSION = 1;
+static const size_t HLL_HEADER = 5;  // Magic, version and precision bytes
+// --------------------------------------------------------------------------------
+
+static inline void _hll_add_hash(hll_t* hll, uint64_t hash) {
+    size_t index = (size_t)(hash >> (64 - hll->precision));
+    // A sentinel bit caps the run so the count stays within the register
+    uint64_t rest = (hash << hll->precision) | ((uint64_t)1 << (hll->precision - 1));
+    uint8_t rank = 1;
+#if defined(__GNUC__) || defined(__clang__)
+    rank += (uint8_t)__builtin_clzll(rest);
+#else
+    while (!(rest & ((uint64_t)1 << 63))) {
+        rest <<= 1;
+        rank++;
+    }
+#endif
+    if (rank > hll->registers[index]) {
+        hll->registers[index] = rank;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static inline uint64_t _hll_hash(const char* token, size_t len) {
+    return _wyhash(token, len, 0);
+}
+// --------------------------------------------------------------------------------
+
+// Natural log without libm: scale into [1, 2) and sum the atanh series
+static double _hll_log(double x) {
+    static const double LN2 = 0.6931471805599453;
+    double k = 0.0;
+    while (x >= 2.0) {
+        x /= 2.0;
+        k += 1.0;
+    }
+    while (x < 1.0) {
+        x *= 2.0;
+        k -= 1.0;
+    }
+    double z = (x - 1.0) / (x + 1.0);
+    double z2 = z * z;
+    double term = z;
+    double sum = 0.0;
+    for (int n = 1; n < 40; n += 2) {
+        sum += term / n;
+        term *= z2;
+    }
+    return k * LN2 + 2.0 * sum;
+}
+// --------------------------------------------------------------------------------
+
+hll_t* init_hll(unsigned int precision) {
+    if (precision < HLL_MIN_PRECISION || precision > HLL_MAX_PRECISION) {
+        errno = EINVAL;
+        return NULL;
+    }
+    hll_t* hll = malloc(sizeof(*hll));
+    if (!hll) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_hll() function\n");
+        return NULL;
+    }
+    hll->precision = (uint8_t)precision;
+    hll->len = (size_t)1 << precision;
+    hll->registers = calloc(hll->len, 1);
+    if (!hll->registers) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Allocation failure in init_hll() function\n");
+        free(hll);
+        return NULL;
+    }
+    return hll;
+}
+// --------------------------------------------------------------------------------
+
+bool add_hll(hll_t* hll, const char* token) {
+    if (!hll || !token) {
+        errno = EINVAL;
+        return false;
+    }
+    _hll_add_hash(hll, _hll_hash(token, strlen(token)));
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool add_hll_string(hll_t* hll, const string_t* str, const char* delim) {
+    if (!hll || !str || !str->str || !delim) {
+        errno = EINVAL;
+        return false;
+    }
+    bool delims[256];
+    _delim_table(delim, delims);
+    const char* cursor = str->str;
+    const char* end = str->str + str->len;
+    const char* token;
+    size_t len;
+    while ((token = _next_token(&cursor, end, delims, &len))) {
+        _hll_add_hash(hll, _hll_hash(token, len));
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool add_hll_vector(hll_t* hll, const string_v* vec) {
+    if (!hll || !vec || !vec->data) {
+        errno = EINVAL;
+        return false;
+    }
+    for (size_t i = 0; i < vec->len; i++) {
+        const string_t* str = &vec->data[i];
+        if (!str->str) continue;
+        // A 64 bit cached string hash is the same hash, reuse it
+        uint64_t hash = sizeof(size_t) >= sizeof(uint64_t) ? 
+                        (uint64_t)_peek_string_hash(str) : _hll_hash(str->str, str->len);
+        _hll_add_hash(hll, hash);
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t hll_estimate(const hll_t* hll) {
+    if (!hll) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    double m = (double)hll->len;
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t i = 0; i < hll->len; i++) {
+        sum += 1.0 / (double)((uint64_t)1 << hll->registers[i]);
+        zeros += hll->registers[i] == 0;
+    }
+    double alpha;
+    switch (hll->len) {
+        case 16: alpha = 0.673; break;
+        case 32: alpha = 0.697; break;
+        case 64: alpha = 0.709; break;
+        default: alpha = 0.7213 / (1.0 + 1.079 / m); break;
+    }
+    double estimate = alpha * m * m / sum;
+    // Linear counting is more accurate while many registers are still empty
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * _hll_log(m / (double)zeros);
+    }
+    return (size_t)(estimate + 0.5);
+}
+// --------------------------------------------------------------------------------
+
+bool merge_hll(hll_t* dst, const hll_t* src) {
+    if (!dst || !src || dst->precision != src->precision) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t i = 0;
+    uint8_t* a = dst->registers;
+    const uint8_t* b = src->registers;
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
+    for (; i + 32 <= dst->len; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(a + i), _mm256_max_epu8(va, vb));
+    }
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+    for (; i + 16 <= dst->len; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(a + i), _mm_max_epu8(va, vb));
+    }
+#endif
+    for (; i < dst->len; i++) {
+        if (b[i] > a[i]) a[i] = b[i];
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t hll_serialize(const hll_t* hll, unsigned char* buffer, size_t size) {
+    if (!hll) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t needed = HLL_HEADER + hll->len;
+    if (!buffer) {
+        return needed;
+    }
+    if (size < needed) {
+        errno = ERANGE;
+        return LONG_MAX;
+    }
+    memcpy(buffer, HLL_MAGIC, sizeof(HLL_MAGIC));
+    buffer[3] = HLL_VERSION;
+    buffer[4] = hll->precision;
+    memcpy(buffer + HLL_HEADER, hll->registers, hll->len);
+    return needed;
+}
+// --------------------------------------------------------------------------------
+
+hll_t* hll_deserialize(const unsigned char* buffer, size_t size) {
+    if (!buffer || size < HLL_HEADER || memcmp(buffer, HLL_MAGIC, sizeof(HLL_MAGIC)) != 0 ||
+        buffer[3] != HLL_VERSION) {
+        errno = EINVAL;
+        return NULL;
+    }
+    unsigned int precision = buffer[4];
+    if (precision < HLL_MIN_PRECISION || precision > HLL_MAX_PRECISION ||
+        size != HLL_HEADER + ((size_t)1 << precision)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    hll_t* hll = init_hll(precision);
+    if (!hll) {
+        return NULL;
+    }
+    memcpy(hll->registers, buffer + HLL_HEADER, hll->len);
+    return hll;
+}
+// --------------------------------------------------------------------------------
+
+void free_hll(hll_t* hll) {
+    if (!hll) {
+        errno = EINVAL;
+        return;
+    }
+    free(hll->registers);
+    free(hll);
+}
+// --------------------------------------------------------------------------------
+
+void _free_hll(hll_t** hll) {
+    if (hll && *hll) {
+        free_hll(*hll);
+        *hll = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// SEARCH INDEX IMPLEMENTATION
+
+/*
+ * Static sorted keys laid out in Eytzinger (breadth first) order: node k has 
+ * children 2k and 2k + 1, so the top levels of every search share the same 
+ * few cache lines and the sixteen great-great-grandchildren of a node are 
+ * contiguous and can be prefetched four levels ahead.  The prefix shared by 
+ * every key is checked once per lookup; each node then holds the next eight 
+ * key bytes packed big endian, so most probes are one integer compare and 
+ * never touch the key bytes.
+ */
+struct search_index_t {
+    size_t len;
+    size_t lcp;           // Length of the prefix shared by every key
+    uint64_t* prefixes;   // Eytzinger order, 1 based, 64 byte aligned
+    size_t* ranks;        // Eytzinger order, position of each node in sorted order
+    size_t* offsets;      // Sorted order, len + 1 starts into keys
+    char* keys;           // Every key, null terminated and packed in sorted order
+    void* raw;            // Unaligned allocation behind prefixes
+};
+// --------------------------------------------------------------------------------
+
+static const size_t SEARCH_PREFETCH_NODES = 16;  // Descendants four levels down
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define _prefetch(addr) __builtin_prefetch(addr)
+#else
+    #define _prefetch(addr) ((void)(addr))
+#endif
+// --------------------------------------------------------------------------------
+
+static inline uint64_t _key_prefix(const char* key, size_t len) {
+    uint64_t prefix = 0;
+    size_t n = len < 8 ? len : 8;
+    for (size_t i = 0; i < n; i++) {
+        prefix |= (uint64_t)(unsigned char)key[i] << (56 - 8 * i);
+    }
+    return prefix;
+}
+// --------------------------------------------------------------------------------
+
+static void _eytzinger_fill(search_index_t* index, size_t* rank, size_t k) {
+    if (k > index->len) return;
+    _eytzinger_fill(index, rank, 2 * k);
+    const char* key = index->keys + index->offsets[*rank];
+    size_t len = index->offsets[*rank + 1] - index->offsets[*rank] - 1;
+    index->prefixes[k] = _key_prefix(key + index->lcp, len - index->lcp);
+    index->ranks[k] = (*rank)++;
+    _eytzinger_fill(index, rank, 2 * k + 1);
+}
+// --------------------------------------------------------------------------------
+
+search_index_t* init_search_index(const string_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t n = vec->len;
+    if (!vec->sorted) {
+        for (size_t i = 1; i < n; i++) {
+            if (_cmp_str(&vec->data[i - 1], &vec->data[i]) > 0) {
+                errno = EINVAL;
+                return NULL;
+            }
+        }
+    }
+    size_t bytes = 0;
+    for (size_t i = 0; i < n; i++) {
+        bytes += vec->data[i].len + 1;
+    }
+    search_index_t* index = calloc(1, sizeof(search_index_t));
+    if (!index) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    index->len = n;
+    index->raw = malloc((n + 1) * sizeof(uint64_t) + 64);
+    index->ranks = malloc((n + 1) * sizeof(size_t));
+    index->offsets = malloc((n + 1) * sizeof(size_t));
+    index->keys = malloc(bytes > 0 ? bytes : 1);
+    if (!index->raw || !index->ranks || !index->offsets || !index->keys) {
+        free_search_index(index);
+        errno = ENOMEM;
+        return NULL;
+    }
+    index->prefixes = (uint64_t*)(((uintptr_t)index->raw + 63) & ~(uintptr_t)63);
+    size_t offset = 0;
+    for (size_t i = 0; i < n; i++) {
+        index->offsets[i] = offset;
+        memcpy(index->keys + offset, vec->data[i].str, vec->data[i].len);
+        index->keys[offset + vec->data[i].len] = '\0';
+        offset += vec->data[i].len + 1;
+    }
+    index->offsets[n] = offset;
+    if (n > 0) {
+        // Sorted keys share whatever prefix the first and last keys share
+        const string_t* first = &vec->data[0];
+        const string_t* last = &vec->data[n - 1];
+        size_t shorter = first->len < last->len ? first->len : last->len;
+        index->lcp = _first_mismatch(first->str, last->str, shorter);
+    }
+    index->prefixes[0] = 0;
+    index->ranks[0] = n;
+    size_t rank = 0;
+    _eytzinger_fill(index, &rank, 1);
+    return index;
+}
+// --------------------------------------------------------------------------------
+
+// Compares the key of node k with a key, both without the shared prefix
+static inline int _search_index_cmp(const search_index_t* index, size_t k, 
+                                    const char* key, size_t len) {
+    size_t rank = index->ranks[k];
+    size_t start = index->offsets[rank] + index->lcp;
+    size_t node_len = index->offsets[rank + 1] - start - 1;
+    // Equal prefixes mean the leading bytes both keys hold already match
+    size_t skip = node_len < len ? node_len : len;
+    if (skip > 8) skip = 8;
+    return _compare_bytes(index->keys + start + skip, node_len - skip, key + skip, len - skip);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the Eytzinger node of the first key not less than key, or 0 when 
+ * every key is less or the key falls outside the shared prefix.
+ */
+static size_t _search_index_lower(const search_index_t* index, const char* key, size_t len) {
+    if (index->len == 0) return 0;
+    size_t lcp = index->lcp;
+    int shared = _compare_bytes(key, len < lcp ? len : lcp, index->keys, lcp);
+    if (shared != 0) return 0;
+    key += lcp;
+    len -= lcp;
+    uint64_t prefix = _key_prefix(key, len);
+    uintptr_t base = (uintptr_t)index->prefixes;
+    size_t k = 1;
+    while (k <= index->len) {
+        // May point past the array, prefetching never faults
+        _prefetch((const void*)(base + k * SEARCH_PREFETCH_NODES * sizeof(uint64_t)));
+        uint64_t node = index->prefixes[k];
+        bool less = node < prefix || 
+                    (node == prefix && _search_index_cmp(index, k, key, len) < 0);
+        k = 2 * k + less;
+    }
+    // Drop the trailing right turns and the final left turn to reach the answer
+#if defined(__GNUC__) || defined(__clang__)
+    k >>= __builtin_ctzll(~(unsigned long long)k) + 1;
+#else
+    while (k & 1) k >>= 1;
+    k >>= 1;
+#endif
+    return k;
+}
+// --------------------------------------------------------------------------------
+
+size_t search_index_lower_bound(const search_index_t* index, const char* value) {
+    if (!index || !value) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t len = strlen(value);
+    size_t k = _search_index_lower(index, value, len);
+    if (k == 0) {
+        // Below or above every key, decided by the shared prefix alone
+        size_t lcp = index->lcp;
+        bool below = index->len == 0 || 
+                     _compare_bytes(value, len < lcp ? len : lcp, index->keys, lcp) < 0;
+        return below ? 0 : index->len;
+    }
+    return index->ranks[k];
+}
+// --------------------------------------------------------------------------------
+
+size_t search_index_find(const search_index_t* index, const char* value) {
+    if (!index || !value) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t len = strlen(value);
+    size_t k = _search_index_lower(index, value, len);
+    if (k == 0) return LONG_MAX;
+    // Most misses are settled by the inline prefix without touching the keys
+    if (index->prefixes[k] != _key_prefix(value + index->lcp, len - index->lcp)) {
+        return LONG_MAX;
+    }
+    if (_search_index_cmp(index, k, value + index->lcp, len - index->lcp) != 0) {
+        return LONG_MAX;
+    }
+    return index->ranks[k];
+}
+// --------------------------------------------------------------------------------
+
+const char* search_index_key(const search_index_t* index, size_t rank) {
+    if (!index) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (rank >= index->len) {
+        errno = ERANGE;
+        return NULL;
+    }
+    return index->keys + index->offsets[rank];
+}
+// --------------------------------------------------------------------------------
+
+const size_t search_index_size(const search_index_t* index) {
+    if (!index) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return index->len;
+}
+// --------------------------------------------------------------------------------
+
+void free_search_index(search_index_t* index) {
+    if (!index) {
+        errno = EINVAL;
+        return;
+    }
+    free(index->raw);
+    free(index->ranks);
+    free(index->offsets);
+    free(index->keys);
+    free(index);
+}
+// --------------------------------------------------------------------------------
+
+void _free_search_index(search_index_t** index) {
+    if (index && *index) {
+        free_search_index(*index);
+        *index = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// RADIX TREE IMPLEMENTATION
+
+/*
+ * Adaptive radix tree.  Inner nodes branch on one key byte and come in four 
+ * sizes, grown as children are added: Node4 fills one cache line, Node16 
+ * keeps its keys in one SIMD register, Node48 maps bytes to 48 slots and 
+ * Node256 indexes children directly.  Chains of single-child nodes are 
+ * collapsed into a prefix of which the first ART_MAX_PREFIX bytes are kept 
+ * inline; longer prefixes are recovered from any leaf below the node.  Child 
+ * pointers to leaves are tagged in their low bit.  A key that ends exactly 
+ * at an inner node is held in that node's leaf field.
+ */
+#define ART_MAX_PREFIX 8
+
+typedef enum { ART_NODE4, ART_NODE16, ART_NODE48, ART_NODE256 } artType;
+
+typedef struct {
+    size_t value;
+    size_t key_len;
+    char key[];           // Null terminated
+} artLeaf;
+
+typedef struct {
+    uint8_t type;
+    uint16_t count;       // Number of children
+    uint32_t prefix_len;  // Full length of the compressed prefix
+    char prefix[ART_MAX_PREFIX];
+    artLeaf* leaf;        // Key ending at this node, NULL if none
+} artNode;
+
+typedef struct { artNode n; uint8_t keys[4]; void* children[4]; } artNode4;
+typedef struct { artNode n; uint8_t keys[16]; void* children[16]; } artNode16;
+typedef struct { artNode n; uint8_t index[256]; void* children[48]; } artNode48;
+typedef struct { artNode n; void* children[256]; } artNode256;
+
+struct radix_tree_t {
+    void* root;
+    size_t len;
+};
+// --------------------------------------------------------------------------------
+
+#define ART_IS_LEAF(x) (((uintptr_t)(x)) & 1)
+#define ART_LEAF(x) ((artLeaf*)((uintptr_t)(x) & ~(uintptr_t)1))
+#define ART_TAG(x) ((void*)((uintptr_t)(x) | 1))
+// --------------------------------------------------------------------------------
+
+static artLeaf* _art_leaf_new(const char* key, size_t len, size_t value) {
+    artLeaf* leaf = malloc(sizeof(artLeaf) + len + 1);
+    if (!leaf) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    leaf->value = value;
+    leaf->key_len = len;
+    memcpy(leaf->key, key, len);
+    leaf->key[len] = '\0';
+    return leaf;
+}
+// --------------------------------------------------------------------------------
+
+static artNode* _art_node_new(artType type) {
+    static const size_t sizes[4] = {sizeof(artNode4), sizeof(artNode16), 
+                                    sizeof(artNode48), sizeof(artNode256)};
+    artNode* node = calloc(1, sizes[type]);
+    if (!node) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    node->type = (uint8_t)type;
+    return node;
+}
+// --------------------------------------------------------------------------------
+
+static inline bool _art_leaf_matches(const artLeaf* leaf, const char* key, size_t len) {
+    return _equal_bytes(leaf->key, leaf->key_len, key, len);
+}
+// --------------------------------------------------------------------------------
+
+static void** _art_find_child(artNode* node, uint8_t byte) {
+    switch (node->type) {
+        case ART_NODE4: {
+            artNode4* n = (artNode4*)node;
+            for (uint16_t i = 0; i < node->count; i++) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return NULL;
+        }
+        case ART_NODE16: {
+            artNode16* n = (artNode16*)node;
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+            __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)byte), 
+                                         _mm_loadu_si128((const __m128i*)n->keys));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(cmp) & ((1u << node->count) - 1);
+            return mask ? &n->children[__builtin_ctz(mask)] : NULL;
+#else
+            for (uint16_t i = 0; i < node->count; i++) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return NULL;
+#endif
+        }
+        case ART_NODE48: {
+            artNode48* n = (artNode48*)node;
+            return n->index[byte] ? &n->children[n->index[byte] - 1] : NULL;
+        }
+        default: {
+            artNode256* n = (artNode256*)node;
+            return n->children[byte] ? &n->children[byte] : NULL;
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+// Inserts into a sorted Node4 or Node16 key array, the caller checked for room
+static void _art_insert_sorted(uint8_t* keys, void** children, uint16_t count, 
+                               uint8_t byte, void* child) {
+    uint16_t pos = 0;
+    while (pos < count && keys[pos] < byte) pos++;
+    memmove(keys + pos + 1, keys + pos, count - pos);
+    memmove(children + pos + 1, children + pos, (count - pos) * sizeof(void*));
+    keys[pos] = byte;
+    children[pos] = child;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Adds a child for a byte not yet present, growing the node into the next 
+ * size class when it is full.  *ref is updated when the node is replaced.
+ */
+static bool _art_add_child(void** ref, artNode* node, uint8_t byte, void* child) {
+    switch (node->type) {
+        case ART_NODE4: {
+            artNode4* n = (artNode4*)node;
+            if (node->count < 4) {
+                _art_insert_sorted(n->keys, n->children, node->count, byte, child);
+                node->count++;
+                return true;
+            }
+            artNode16* grown = (artNode16*)_art_node_new(ART_NODE16);
+            if (!grown) return false;
+            grown->n = *node;
+            grown->n.type = ART_NODE16;
+            memcpy(grown->keys, n->keys, sizeof(n->keys));
+            memcpy(grown->children, n->children, sizeof(n->children));
+            *ref = grown;
+            free(node);
+            return _art_add_child(ref, &grown->n, byte, child);
+        }
+        case ART_NODE16: {
+            artNode16* n = (artNode16*)node;
+            if (node->count < 16) {
+                _art_insert_sorted(n->keys, n->children, node->count, byte, child);
+                node->count++;
+                return true;
+            }
+            artNode48* grown = (artNode48*)_art_node_new(ART_NODE48);
+            if (!grown) return false;
+            grown->n = *node;
+            grown->n.type = ART_NODE48;
+            for (uint16_t i = 0; i < 16; i++) {
+                grown->index[n->keys[i]] = (uint8_t)(i + 1);
+                grown->children[i] = n->children[i];
+            }
+            *ref = grown;
+            free(node);
+            return _art_add_child(ref, &grown->n, byte, child);
+        }
+        case ART_NODE48: {
+            artNode48* n = (artNode48*)node;
+            if (node->count < 48) {
+                // Slots are never freed, so the next free slot is count
+                n->children[node->count] = child;
+                n->index[byte] = (uint8_t)(node->count + 1);
+                node->count++;
+                return true;
+            }
+            artNode256* grown = (artNode256*)_art_node_new(ART_NODE256);
+            if (!grown) return false;
+            grown->n = *node;
+            grown->n.type = ART_NODE256;
+            for (size_t b = 0; b < 256; b++) {
+                if (n->index[b]) grown->children[b] = n->children[n->index[b] - 1];
+            }
+            *ref = grown;
+            free(node);
+            return _art_add_child(ref, &grown->n, byte, child);
+        }
+        default: {
+            artNode256* n = (artNode256*)node;
+            n->children[byte] = child;
+            node->count++;
+            return true;
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+// Any leaf below a node carries the node's full prefix, the smallest is nearest
+static const artLeaf* _art_min_leaf(const void* ptr) {
+    while (ptr && !ART_IS_LEAF(ptr)) {
+        const artNode* node = ptr;
+        if (node->leaf) return node->leaf;
+        switch (node->type) {
+            case ART_NODE4: ptr = ((const artNode4*)node)->children[0]; break;
+            case ART_NODE16: ptr = ((const artNode16*)node)->children[0]; break;
+            case ART_NODE48: {
+                const artNode48* n = (const artNode48*)node;
+                size_t b = 0;
+                while (!n->index[b]) b++;
+                ptr = n->children[n->index[b] - 1];
+                break;
+            }
+            default: {
+                const artNode256* n = (const artNode256*)node;
+                size_t b = 0;
+                while (!n->children[b]) b++;
+                ptr = n->children[b];
+                break;
+            }
+        }
+    }
+    return ptr ? ART_LEAF(ptr) : NULL;
+}
+// --------------------------------------------------------------------------------
+
+// Number of prefix bytes of node that match key from depth, checked exactly
+static size_t _art_prefix_mismatch(const artNode* node, const char* key, size_t len, 
+                                   size_t depth) {
+    size_t limit = node->prefix_len < len - depth ? node->prefix_len : len - depth;
+    size_t inline_limit = limit < ART_MAX_PREFIX ? limit : ART_MAX_PREFIX;
+    size_t i = _first_mismatch(node->prefix, key + depth, inline_limit);
+    if (i < inline_limit || limit <= ART_MAX_PREFIX) return i;
+    const artLeaf* leaf = _art_min_leaf(node);
+    return i + _first_mismatch(leaf->key + depth + i, key + depth + i, limit - i);
+}
+// --------------------------------------------------------------------------------
+
+// Places a leaf below a fresh node, either as the node's own key or as a child
+static bool _art_attach(artNode* node, artLeaf* leaf, size_t depth, void** ref) {
+    if (leaf->key_len == depth) {
+        node->leaf = leaf;
+        return true;
+    }
+    return _art_add_child(ref, node, (uint8_t)leaf->key[depth], ART_TAG(leaf));
+}
+// --------------------------------------------------------------------------------
+
+static void _art_set_prefix(artNode* node, const char* bytes, size_t len) {
+    node->prefix_len = (uint32_t)len;
+    memcpy(node->prefix, bytes, len < ART_MAX_PREFIX ? len : ART_MAX_PREFIX);
+}
+// --------------------------------------------------------------------------------
+
+static bool _art_insert(radix_tree_t* tree, void** ref, const char* key, size_t len, 
+                        size_t depth, size_t value) {
+    void* ptr = *ref;
+    if (!ptr) {
+        artLeaf* leaf = _art_leaf_new(key, len, value);
+        if (!leaf) return false;
+        *ref = ART_TAG(leaf);
+        tree->len++;
+        return true;
+    }
+    if (ART_IS_LEAF(ptr)) {
+        artLeaf* existing = ART_LEAF(ptr);
+        if (_art_leaf_matches(existing, key, len)) {
+            existing->value = value;
+            return true;
+        }
+        // Split the leaf into a Node4 holding both keys below their common prefix
+        size_t limit = (existing->key_len < len ? existing->key_len : len) - depth;
+        size_t common = _first_mismatch(existing->key + depth, key + depth, limit);
+        artLeaf* leaf = _art_leaf_new(key, len, value);
+        artNode* node = _art_node_new(ART_NODE4);
+        if (!leaf || !node) {
+            free(leaf);
+            free(node);
+            return false;
+        }
+        _art_set_prefix(node, key + depth, common);
+        void* split = node;
+        _art_attach(node, existing, depth + common, &split);
+        _art_attach(node, leaf, depth + common, &split);
+        *ref = split;
+        tree->len++;
+        return true;
+    }
+    artNode* node = ptr;
+    if (node->prefix_len) {
+        size_t match = _art_prefix_mismatch(node, key, len, depth);
+        if (match < node->prefix_len) {
+            // The key leaves the prefix early, split the prefix at that byte
+            artLeaf* leaf = _art_leaf_new(key, len, value);
+            artNode* parent = _art_node_new(ART_NODE4);
+            if (!leaf || !parent) {
+                free(leaf);
+                free(parent);
+                return false;
+            }
+            const artLeaf* min = _art_min_leaf(node);
+            _art_set_prefix(parent, min->key + depth, match);
+            uint8_t byte = (uint8_t)min->key[depth + match];
+            size_t rest = node->prefix_len - match - 1;
+            node->prefix_len = (uint32_t)rest;
+            memmove(node->prefix, min->key + depth + match + 1, 
+                    rest < ART_MAX_PREFIX ? rest : ART_MAX_PREFIX);
+            void* split = parent;
+            _art_add_child(&split, parent, byte, node);
+            _art_attach(parent, leaf, depth + match, &split);
+            *ref = split;
+            tree->len++;
+            return true;
+        }
+        depth += node->prefix_len;
+    }
+    if (depth == len) {
+        if (node->leaf) {
+            node->leaf->value = value;
+            return true;
+        }
+        node->leaf = _art_leaf_new(key, len, value);
+        if (!node->leaf) return false;
+        tree->len++;
+        return true;
+    }
+    void** child = _art_find_child(node, (uint8_t)key[depth]);
+    if (child) {
+        return _art_insert(tree, child, key, len, depth + 1, value);
+    }
+    artLeaf* leaf = _art_leaf_new(key, len, value);
+    if (!leaf) return false;
+    if (!_art_add_child(ref, node, (uint8_t)key[depth], ART_TAG(leaf))) {
+        free(leaf);
+        return false;
+    }
+    tree->len++;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static void _art_free(void* ptr) {
+    if (!ptr) return;
+    if (ART_IS_LEAF(ptr)) {
+        free(ART_LEAF(ptr));
+        return;
+    }
+    artNode* node = ptr;
+    free(node->leaf);
+    switch (node->type) {
+        case ART_NODE4: {
+            artNode4* n = (artNode4*)node;
+            for (uint16_t i = 0; i < node->count; i++) _art_free(n->children[i]);
+            break;
+        }
+        case ART_NODE16: {
+            artNode16* n = (artNode16*)node;
+            for (uint16_t i = 0; i < node->count; i++) _art_free(n->children[i]);
+            break;
+        }
+        case ART_NODE48: {
+            artNode48* n = (artNode48*)node;
+            for (uint16_t i = 0; i < node->count; i++) _art_free(n->children[i]);
+            break;
+        }
+        default: {
+            artNode256* n = (artNode256*)node;
+            for (size_t b = 0; b < 256; b++) _art_free(n->children[b]);
+            break;
+        }
+    }
+    free(node);
+}
+// --------------------------------------------------------------------------------
+
+radix_tree_t* init_radix_tree(void) {
+    radix_tree_t* tree = calloc(1, sizeof(radix_tree_t));
+    if (!tree) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return tree;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Builds the subtree for keys[lo, hi), sorted, unique and sharing their first 
+ * depth bytes.  Each node is created at its final size, no node is grown.
+ */
+static void* _art_build(const string_t** keys, const string_t* base, size_t lo, 
+                        size_t hi, size_t depth) {
+    if (hi - lo == 1) {
+        artLeaf* leaf = _art_leaf_new(keys[lo]->str, keys[lo]->len, (size_t)(keys[lo] - base));
+        return leaf ? ART_TAG(leaf) : NULL;
+    }
+    const string_t* first = keys[lo];
+    const string_t* last = keys[hi - 1];
+    size_t limit = (first->len < last->len ? first->len : last->len) - depth;
+    size_t common = _first_mismatch(first->str + depth, last->str + depth, limit);
+    size_t split = depth + common;
+    size_t start = lo;
+    bool ends_here = first->len == split;
+    if (ends_here) start++;
+    size_t groups = 0;
+    for (size_t i = start; i < hi; i++) {
+        if (i == start || keys[i]->str[split] != keys[i - 1]->str[split]) groups++;
+    }
+    artType type = groups <= 4 ? ART_NODE4 : groups <= 16 ? ART_NODE16 : 
+                   groups <= 48 ? ART_NODE48 : ART_NODE256;
+    artNode* node = _art_node_new(type);
+    if (!node) return NULL;
+    _art_set_prefix(node, first->str + depth, common);
+    if (ends_here) {
+        node->leaf = _art_leaf_new(first->str, first->len, (size_t)(first - base));
+        if (!node->leaf) {
+            _art_free(node);
+            return NULL;
+        }
+    }
+    void* ref = node;
+    for (size_t i = start; i < hi;) {
+        size_t j = i + 1;
+        while (j < hi && keys[j]->str[split] == keys[i]->str[split]) j++;
+        void* child = _art_build(keys, base, i, j, split + 1);
+        if (!child) {
+            _art_free(node);
+            return NULL;
+        }
+        _art_add_child(&ref, node, (uint8_t)keys[i]->str[split], child);
+        i = j;
+    }
+    return ref;
+}
+// --------------------------------------------------------------------------------
+
+radix_tree_t* build_radix_tree(const string_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return NULL;
+    }
+    radix_tree_t* tree = init_radix_tree();
+    if (!tree) return NULL;
+    if (vec->len == 0) return tree;
+    if (!vec->sorted) {
+        // Sorting costs more than it saves, insert back to front so the first 
+        // occurrence of a repeated string writes its index last
+        for (size_t i = vec->len; i-- > 0;) {
+            const string_t* str = &vec->data[i];
+            if (!_art_insert(tree, &tree->root, str->str, str->len, 0, i)) {
+                free_radix_tree(tree);
+                return NULL;
+            }
+        }
+        return tree;
+    }
+    const string_t** keys = malloc(vec->len * sizeof(*keys));
+    if (!keys) {
+        free(tree);
+        errno = ENOMEM;
+        return NULL;
+    }
+    for (size_t i = 0; i < vec->len; i++) {
+        keys[i] = &vec->data[i];
+    }
+    // Drop repeated keys, keeping the first occurrence
+    size_t unique = 1;
+    for (size_t i = 1; i < vec->len; i++) {
+        const string_t* prev = keys[unique - 1];
+        if (!_equal_bytes(prev->str, prev->len, keys[i]->str, keys[i]->len)) {
+            keys[unique++] = keys[i];
+        }
+    }
+    tree->root = _art_build(keys, vec->data, 0, unique, 0);
+    free(keys);
+    if (!tree->root) {
+        free(tree);
+        return NULL;
+    }
+    tree->len = unique;
+    return tree;
+}
+// --------------------------------------------------------------------------------
+
+bool insert_radix_tree(radix_tree_t* tree, const char* key, size_t value) {
+    if (!tree || !key) {
+        errno = EINVAL;
+        return false;
+    }
+    return _art_insert(tree, &tree->root, key, strlen(key), 0, value);
+}
+// --------------------------------------------------------------------------------
+
+static const artLeaf* _art_search(const radix_tree_t* tree, const char* key, size_t len) {
+    void* ptr = tree->root;
+    size_t depth = 0;
+    while (ptr) {
+        if (ART_IS_LEAF(ptr)) {
+            const artLeaf* leaf = ART_LEAF(ptr);
+            return _art_leaf_matches(leaf, key, len) ? leaf : NULL;
+        }
+        artNode* node = ptr;
+        if (node->prefix_len) {
+            // Optimistic, bytes beyond the inline prefix are verified at the leaf
+            size_t check = node->prefix_len < ART_MAX_PREFIX ? node->prefix_len : ART_MAX_PREFIX;
+            if (len - depth < check) return NULL;
+            if (_first_mismatch(node->prefix, key + depth, check) != check) return NULL;
+            depth += node->prefix_len;
+        }
+        if (depth >= len) {
+            return depth == len && node->leaf && _art_leaf_matches(node->leaf, key, len) ? 
+                   node->leaf : NULL;
+        }
+        void** child = _art_find_child(node, (uint8_t)key[depth]);
+        ptr = child ? *child : NULL;
+        depth++;
+    }
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+size_t get_radix_tree_value(const radix_tree_t* tree, const char* key) {
+    if (!tree || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    const artLeaf* leaf = _art_search(tree, key, strlen(key));
+    return leaf ? leaf->value : LONG_MAX;
+}
+// --------------------------------------------------------------------------------
+
+bool is_radix_tree_key(const radix_tree_t* tree, const char* key) {
+    if (!tree || !key) {
+        errno = EINVAL;
+        return false;
+    }
+    return _art_search(tree, key, strlen(key)) != NULL;
+}
+// --------------------------------------------------------------------------------
+
+// Appends every key below ptr in ascending order
+static bool _art_collect(const void* ptr, string_v* out) {
+    if (!ptr) return true;
+    if (ART_IS_LEAF(ptr)) {
+        return push_back_str_vector(out, ART_LEAF(ptr)->key);
+    }
+    const artNode* node = ptr;
+    if (node->leaf && !push_back_str_vector(out, node->leaf->key)) return false;
+    switch (node->type) {
+        case ART_NODE4: {
+            const artNode4* n = (const artNode4*)node;
+            for (uint16_t i = 0; i < node->count; i++) {
+                if (!_art_collect(n->children[i], out)) return false;
+            }
+            return true;
+        }
+        case ART_NODE16: {
+            const artNode16* n = (const artNode16*)node;
+            for (uint16_t i = 0; i < node->count; i++) {
+                if (!_art_collect(n->children[i], out)) return false;
+            }
+            return true;
+        }
+        case ART_NODE48: {
+            const artNode48* n = (const artNode48*)node;
+            for (size_t b = 0; b < 256; b++) {
+                if (n->index[b] && !_art_collect(n->children[n->index[b] - 1], out)) return false;
+            }
+            return true;
+        }
+        default: {
+            const artNode256* n = (const artNode256*)node;
+            for (size_t b = 0; b < 256; b++) {
+                if (!_art_collect(n->children[b], out)) return false;
+            }
+            return true;
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+string_v* radix_tree_prefix_scan(const radix_tree_t* tree, const char* prefix) {
+    if (!tree || !prefix) {
+        errno = EINVAL;
+        return NULL;
+    }
+    string_v* out = init_str_vector(8);
+    if (!out) return NULL;
+    size_t len = strlen(prefix);
+    const void* ptr = tree->root;
+    size_t depth = 0;
+    while (ptr) {
+        if (ART_IS_LEAF(ptr)) {
+            const artLeaf* leaf = ART_LEAF(ptr);
+            if (leaf->key_len >= len && memcmp(leaf->key, prefix, len) == 0) break;
+            ptr = NULL;
+            break;
+        }
+        const artNode* node = ptr;
+        if (node->prefix_len) {
+            size_t match = _art_prefix_mismatch(node, prefix, len, depth);
+            // The prefix ends inside the node prefix, the whole subtree matches
+            if (depth + match == len) break;
+            if (match < node->prefix_len) {
+                ptr = NULL;
+                break;
+            }
+            depth += node->prefix_len;
+        }
+        if (depth == len) break;
+        void** child = _art_find_child((artNode*)node, (uint8_t)prefix[depth]);
+        ptr = child ? *child : NULL;
+        depth++;
+    }
+    if (!_art_collect(ptr, out)) {
+        free_str_vector(out);
+        return NULL;
+    }
+    return out;
+}
+// --------------------------------------------------------------------------------
+
+size_t radix_tree_longest_prefix(const radix_tree_t* tree, const char* key, 
+                                 size_t* match_len) {
+    if (!tree || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t len = strlen(key);
+    const artLeaf* best = NULL;
+    const void* ptr = tree->root;
+    size_t depth = 0;
+    while (ptr) {
+        if (ART_IS_LEAF(ptr)) {
+            const artLeaf* leaf = ART_LEAF(ptr);
+            if (leaf->key_len <= len && memcmp(leaf->key, key, leaf->key_len) == 0) {
+                best = leaf;
+            }
+            break;
+        }
+        const artNode* node = ptr;
+        if (node->prefix_len) {
+            if (_art_prefix_mismatch(node, key, len, depth) < node->prefix_len) break;
+            depth += node->prefix_len;
+        }
+        // Every byte on the path was matched exactly, so a key ending here is a prefix
+        if (node->leaf) best = node->leaf;
+        if (depth == len) break;
+        void** child = _art_find_child((artNode*)node, (uint8_t)key[depth]);
+        ptr = child ? *child : NULL;
+        depth++;
+    }
+    if (match_len) *match_len = best ? best->key_len : 0;
+    return best ? best->value : LONG_MAX;
+}
+// --------------------------------------------------------------------------------
+
+const size_t radix_tree_size(const radix_tree_t* tree) {
+    if (!tree) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return tree->len;
+}
+// --------------------------------------------------------------------------------
+
+void free_radix_tree(radix_tree_t* tree) {
+    if (!tree) {
+        errno = EINVAL;
+        return;
+    }
+    _art_free(tree->root);
+    free(tree);
+}
+// --------------------------------------------------------------------------------
+
+void _free_radix_tree(radix_tree_t** tree) {
+    if (tree && *tree) {
+        free_radix_tree(*tree);
+        *tree = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// FRONT CODED VECTOR IMPLEMENTATION
+
+/*
+ * Sorted strings split into buckets.  The first string of a bucket is stored 
+ * whole, so buckets can be binary searched and decoded independently; every 
+ * other string is stored as the number of bytes it shares with its 
+ * predecessor followed by the remaining suffix.  Lengths are LEB128 varints.
+ */
+struct front_coded_t {
+    size_t len;
+    size_t bucket_size;
+    size_t buckets;
+    size_t* offsets;      // Start of each bucket in data
+    unsigned char* data;
+    size_t data_len;
+};
+// --------------------------------------------------------------------------------
+
+static const size_t FRONT_CODED_BUCKET = 16;  // Strings per bucket when 0 is requested
+
+static size_t _put_varint(unsigned char* out, size_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (unsigned char)value;
+    return n;
+}
+// --------------------------------------------------------------------------------
+
+static inline size_t _get_varint(const unsigned char** in) {
+    const unsigned char* p = *in;
+    size_t value = *p & 0x7F;
+    unsigned int shift = 7;
+    while (*p++ & 0x80) {
+        value |= (size_t)(*p & 0x7F) << shift;
+        shift += 7;
+    }
+    *in = p;
+    return value;
+}
+// --------------------------------------------------------------------------------
+
+front_coded_t* init_front_coded(const string_v* vec, size_t bucket_size) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return NULL;
+    }
+    size_t n = vec->len;
+    if (!vec->sorted) {
+        for (size_t i = 1; i < n; i++) {
+            if (_cmp_str(&vec->data[i - 1], &vec->data[i]) > 0) {
+                errno = EINVAL;
+                return NULL;
+            }
+        }
+    }
+    if (bucket_size == 0) bucket_size = FRONT_CODED_BUCKET;
+    // Worst case: nothing shared, two ten byte varints per string
+    size_t bound = 0;
+    for (size_t i = 0; i < n; i++) {
+        bound += vec->data[i].len + 20;
+    }
+    front_coded_t* fc = calloc(1, sizeof(front_coded_t));
+    if (!fc) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    fc->len = n;
+    fc->bucket_size = bucket_size;
+    fc->buckets = (n + bucket_size - 1) / bucket_size;
+    fc->offsets = malloc((fc->buckets > 0 ? fc->buckets : 1) * sizeof(size_t));
+    fc->data = malloc(bound > 0 ? bound : 1);
+    if (!fc->offsets || !fc->data) {
+        free_front_coded(fc);
+        errno = ENOMEM;
+        return NULL;
+    }
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+        const string_t* str = &vec->data[i];
+        size_t shared = 0;
+        if (i % bucket_size == 0) {
+            fc->offsets[i / bucket_size] = pos;
+        } else {
+            const string_t* prev = &vec->data[i - 1];
+            size_t limit = prev->len < str->len ? prev->len : str->len;
+            shared = _first_mismatch(prev->str, str->str, limit);
+            pos += _put_varint(fc->data + pos, shared);
+        }
+        pos += _put_varint(fc->data + pos, str->len - shared);
+        memcpy(fc->data + pos, str->str + shared, str->len - shared);
+        pos += str->len - shared;
+    }
+    // Give back the worst case reserve
+    unsigned char* fitted = realloc(fc->data, pos > 0 ? pos : 1);
+    if (fitted) fc->data = fitted;
+    fc->data_len = pos;
+    return fc;
+}
+// --------------------------------------------------------------------------------
+
+size_t front_coded_get(const front_coded_t* fc, size_t index, char* buffer, size_t size) {
+    if (!fc) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    if (index >= fc->len) {
+        errno = ERANGE;
+        return LONG_MAX;
+    }
+    const unsigned char* p = fc->data + fc->offsets[index / fc->bucket_size];
+    size_t steps = index % fc->bucket_size;
+    // Bytes beyond the buffer are never needed by the requested string, 
+    // so each step only writes what fits
+    size_t room = (buffer && size > 0) ? size - 1 : 0;
+    size_t len = _get_varint(&p);
+    if (room > 0) memcpy(buffer, p, len < room ? len : room);
+    p += len;
+    for (size_t i = 0; i < steps; i++) {
+        size_t shared = _get_varint(&p);
+        size_t suffix = _get_varint(&p);
+        if (shared < room) {
+            size_t fit = suffix < room - shared ? suffix : room - shared;
+            memcpy(buffer + shared, p, fit);
+        }
+        p += suffix;
+        len = shared + suffix;
+    }
+    if (!buffer) return len;
+    if (len >= size) {
+        errno = ERANGE;
+        return LONG_MAX;
+    }
+    buffer[len] = '\0';
+    return len;
+}
+// --------------------------------------------------------------------------------
+
+static inline const char* _front_coded_head(const front_coded_t* fc, size_t bucket, 
+                                            size_t* len) {
+    const unsigned char* p = fc->data + fc->offsets[bucket];
+    *len = _get_varint(&p);
+    return (const char*)p;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Lower bound without decoding.  While the current string is less than the 
+ * query and matches its first match bytes, a successor sharing more than 
+ * match bytes with it is also less, one sharing fewer is greater, and only 
+ * one sharing exactly match bytes needs its suffix compared.
+ */
+static size_t _front_coded_lower(const front_coded_t* fc, const char* key, size_t len, 
+                                 bool* found) {
+    *found = false;
+    // First bucket whose first string is not less than the key
+    size_t lo = 0;
+    size_t hi = fc->buckets;
+    size_t head_len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const char* head = _front_coded_head(fc, mid, &head_len);
+        if (_compare_bytes(head, head_len, key, len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < fc->buckets) {
+        const char* head = _front_coded_head(fc, lo, &head_len);
+        *found = _equal_bytes(head, head_len, key, len);
+    }
+    // The answer is in the bucket before, or is the head of bucket lo
+    if (lo == 0) return 0;
+    size_t bucket = lo - 1;
+    size_t index = bucket * fc->bucket_size;
+    size_t end = index + fc->bucket_size < fc->len ? index + fc->bucket_size : fc->len;
+    const unsigned char* p = fc->data + fc->offsets[bucket];
+    size_t cur_len = _get_varint(&p);
+    size_t limit = cur_len < len ? cur_len : len;
+    size_t match = _first_mismatch((const char*)p, key, limit);
+    p += cur_len;
+    for (index++; index < end; index++) {
+        size_t shared = _get_varint(&p);
+        size_t suffix = _get_varint(&p);
+        const unsigned char* bytes = p;
+        p += suffix;
+        if (shared > match) continue;
+        if (shared < match) return index;
+        cur_len = shared + suffix;
+        limit = (cur_len < len ? cur_len : len) - shared;
+        match = shared + _first_mismatch((const char*)bytes, key + shared, limit);
+        if (match == len && cur_len == len) {
+            *found = true;
+            return index;
+        }
+        // Greater when the query ran out first or its byte is smaller
+        if (match == len || (match < cur_len && 
+            (unsigned char)bytes[match - shared] > (unsigned char)key[match])) {
+            return index;
+        }
+    }
+    return index;
+}
+// --------------------------------------------------------------------------------
+
+size_t front_coded_find(const front_coded_t* fc, const char* value) {
+    if (!fc || !value) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    bool found;
+    size_t index = _front_coded_lower(fc, value, strlen(value), &found);
+    return found ? index : LONG_MAX;
+}
+// --------------------------------------------------------------------------------
+
+size_t front_coded_lower_bound(const front_coded_t* fc, const char* value) {
+    if (!fc || !value) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    bool found;
+    return _front_coded_lower(fc, value, strlen(value), &found);
+}
+// --------------------------------------------------------------------------------
+
+const size_t front_coded_size(const front_coded_t* fc) {
+    if (!fc) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return fc->len;
+}
+// --------------------------------------------------------------------------------
+
+size_t front_coded_memory(const front_coded_t* fc) {
+    if (!fc) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return sizeof(front_coded_t) + fc->buckets * sizeof(size_t) + fc->data_len;
+}
+// --------------------------------------------------------------------------------
+
+void free_front_coded(front_coded_t* fc) {
+    if (!fc) {
+        errno = EINVAL;
+        return;
+    }
+    free(fc->offsets);
+    free(fc->data);
+    free(fc);
+}
+// --------------------------------------------------------------------------------
+
+void _free_front_coded(front_coded_t** fc) {
+    if (fc && *fc) {
+        free_front_coded(*fc);
+        *fc = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// BINARY IMAGE IMPLEMENTATION
+
+/*
+ * A binary image is a fixed header followed by a body that lookups use in 
+ * place.  A string vector body is count + 1 uint64 offsets followed by the 
+ * null terminated strings.  A dict body is the frozen dict of its entries: 
+ * uint32 pilots, padded to eight bytes, the slots and the packed keys, so an 
+ * opened image is searched by the frozen dict code with no decoding.  The 
+ * checksum chains a hash over 64 KiB blocks of the body so it can be 
+ * computed while streaming to disk.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;      // IMAGE_ENDIAN as written by the producer
+    uint32_t kind;
+    uint32_t word_size;   // sizeof(size_t) of the producer
+    uint64_t size;        // Total file size in bytes
+    uint64_t checksum;    // Chained hash of the body
+    uint64_t count;       // Strings or entries
+    uint64_t flags;
+    uint64_t buckets;     // Dict images only
+    uint64_t seed;        // Dict images only
+} imageHeader;
+
+typedef enum { IMAGE_STR_VECTOR = 1, IMAGE_DICT = 2 } imageKind;
+
+static const char IMAGE_MAGIC[8] = "CSTRIMG";
+static const uint32_t IMAGE_VERSION = 1;
+static const uint32_t IMAGE_ENDIAN = 0x01020304;
+static const uint64_t IMAGE_SORTED = 1;  // String vector was in ascending order
+#define IMAGE_BLOCK ((size_t)64 * 1024)
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    FILE* file;
+    uint64_t checksum;
+    uint64_t written;     // Body bytes written so far
+    size_t used;
+    bool ok;
+    unsigned char block[IMAGE_BLOCK];
+} imageWriter;
+// --------------------------------------------------------------------------------
+
+static void _image_flush(imageWriter* w) {
+    if (w->used == 0) return;
+    w->checksum = _wyhash((const char*)w->block, w->used, w->checksum);
+    if (w->ok && fwrite(w->block, 1, w->used, w->file) != w->used) {
+        w->ok = false;
+    }
+    w->used = 0;
+}
+// --------------------------------------------------------------------------------
+
+static void _image_write(imageWriter* w, const void* data, size_t len) {
+    const unsigned char* p = data;
+    while (len > 0) {
+        size_t n = IMAGE_BLOCK - w->used < len ? IMAGE_BLOCK - w->used : len;
+        memcpy(w->block + w->used, p, n);
+        w->used += n;
+        w->written += n;
+        p += n;
+        len -= n;
+        if (w->used == IMAGE_BLOCK) _image_flush(w);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static void _image_align(imageWriter* w) {
+    static const unsigned char zeros[8] = {0};
+    _image_write(w, zeros, (8 - w->written % 8) % 8);
+}
+// --------------------------------------------------------------------------------
+
+static imageWriter* _image_begin(const char* path) {
+    imageWriter* w = malloc(sizeof(imageWriter));
+    if (!w) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    w->file = fopen(path, "wb");
+    if (!w->file) {
+        free(w);
+        return NULL;  // fopen sets errno
+    }
+    w->checksum = 0;
+    w->written = 0;
+    w->used = 0;
+    imageHeader placeholder = {0};
+    w->ok = fwrite(&placeholder, sizeof(placeholder), 1, w->file) == 1;
+    return w;
+}
+// --------------------------------------------------------------------------------
+
+// Completes the header, closes the file and removes it if anything failed
+static bool _image_end(imageWriter* w, const char* path, imageHeader* header) {
+    _image_flush(w);
+    memcpy(header->magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    header->version = IMAGE_VERSION;
+    header->endian = IMAGE_ENDIAN;
+    header->word_size = (uint32_t)sizeof(size_t);
+    header->size = sizeof(imageHeader) + w->written;
+    header->checksum = w->checksum;
+    bool ok = w->ok && fseek(w->file, 0, SEEK_SET) == 0 && 
+              fwrite(header, sizeof(*header), 1, w->file) == 1;
+    ok = fclose(w->file) == 0 && ok;
+    free(w);
+    if (!ok) {
+        remove(path);
+        errno = EIO;
+    }
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+bool save_str_vector(const string_v* vec, const char* path) {
+    if (!vec || !vec->data || !path) {
+        errno = EINVAL;
+        return false;
+    }
+    imageWriter* w = _image_begin(path);
+    if (!w) return false;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < vec->len; i++) {
+        _image_write(w, &offset, sizeof(offset));
+        offset += vec->data[i].len + 1;
+    }
+    _image_write(w, &offset, sizeof(offset));
+    for (size_t i = 0; i < vec->len; i++) {
+        // Elements are always null terminated in memory
+        _image_write(w, vec->data[i].str, vec->data[i].len + 1);
+    }
+    imageHeader header = {0};
+    header.kind = IMAGE_STR_VECTOR;
+    header.count = vec->len;
+    header.flags = vec->sorted ? IMAGE_SORTED : 0;
+    return _image_end(w, path, &header);
+}
+// --------------------------------------------------------------------------------
+
+bool save_dict(const dict_t* dict, const char* path) {
+    if (!dict || !path) {
+        errno = EINVAL;
+        return false;
+    }
+    frozen_dict_t* frozen = freeze_dict(dict);
+    if (!frozen) return false;
+    imageWriter* w = _image_begin(path);
+    if (!w) {
+        free_frozen_dict(frozen);
+        return false;
+    }
+    _image_write(w, frozen->pilots, frozen->buckets * sizeof(uint32_t));
+    _image_align(w);
+    _image_write(w, frozen->slots, frozen->len * sizeof(frozenSlot));
+    size_t key_bytes = 0;
+    if (frozen->len > 0) {
+        const frozenSlot* last = &frozen->slots[frozen->len - 1];
+        key_bytes = last->offset + last->key_len + 1;
+    }
+    _image_write(w, frozen->keys, key_bytes);
+    imageHeader header = {0};
+    header.kind = IMAGE_DICT;
+    header.count = frozen->len;
+    header.buckets = frozen->buckets;
+    header.seed = frozen->seed;
+    free_frozen_dict(frozen);
+    return _image_end(w, path, &header);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Read-only view of a whole file.  POSIX and Windows map the file so pages 
+ * are loaded on first touch and evicted under memory pressure; other targets 
+ * read it into memory.  An empty file has a NULL base.
+ */
+typedef struct {
+    const unsigned char* base;
+    size_t size;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} fileMap;
+// --------------------------------------------------------------------------------
+
+// Maps a file of at least min_size bytes, setting errno to EINVAL if it is smaller
+static bool _map_file(const char* path, size_t min_size, fileMap* map) {
+    map->base = NULL;
+#if defined(_WIN32)
+    map->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+    if (map->file == INVALID_HANDLE_VALUE) {
+        errno = ENOENT;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(map->file, &size) || size.QuadPart < (LONGLONG)min_size) {
+        CloseHandle(map->file);
+        errno = EINVAL;
+        return false;
+    }
+    map->size = (size_t)size.QuadPart;
+    if (map->size == 0) {
+        // Windows cannot map an empty file
+        CloseHandle(map->file);
+        return true;
+    }
+    map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    map->base = map->mapping ? MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!map->base) {
+        if (map->mapping) CloseHandle(map->mapping);
+        CloseHandle(map->file);
+        errno = ENOMEM;
+        return false;
+    }
+    return true;
+#elif defined(__unix__) || defined(__APPLE__)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;  // open sets errno
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < min_size) {
+        close(fd);
+        errno = EINVAL;
+        return false;
+    }
+    map->size = (size_t)st.st_size;
+    if (map->size == 0) {
+        // mmap rejects a zero length
+        close(fd);
+        return true;
+    }
+    void* base = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file open
+    if (base == MAP_FAILED) return false;
+    map->base = base;
+    return true;
+#else
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    long size = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : -1;
+    if (size < 0 || (size_t)size < min_size || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        errno = EINVAL;
+        return false;
+    }
+    map->size = (size_t)size;
+    if (map->size == 0) {
+        fclose(file);
+        return true;
+    }
+    unsigned char* base = malloc(map->size);
+    if (!base || fread(base, 1, map->size, file) != map->size) {
+        free(base);
+        fclose(file);
+        errno = base ? EIO : ENOMEM;
+        return false;
+    }
+    fclose(file);
+    map->base = base;
+    return true;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static void _unmap_file(fileMap* map) {
+    if (!map->base) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(map->base);
+    CloseHandle(map->mapping);
+    CloseHandle(map->file);
+#elif defined(__unix__) || defined(__APPLE__)
+    munmap((void*)map->base, map->size);
+#else
+    free((void*)map->base);
+#endif
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Maps a file and checks its header.  The body checksum is only verified on 
+ * request, since it reads the whole file while lookups touch only the pages 
+ * they need.
+ */
+static const imageHeader* _image_open(const char* path, imageKind kind, bool verify, 
+                                      fileMap* map) {
+    if (!_map_file(path, sizeof(imageHeader), map)) return NULL;
+    const imageHeader* header = (const imageHeader*)map->base;
+    bool valid = memcmp(header->magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) == 0 && 
+                 header->version == IMAGE_VERSION && header->endian == IMAGE_ENDIAN && 
+                 header->kind == (uint32_t)kind && header->size == map->size;
+    // Dict slots hold size_t fields, so those images need a matching word size
+    if (valid && kind == IMAGE_DICT) {
+        valid = header->word_size == sizeof(size_t);
+    }
+    if (!valid) {
+        _unmap_file(map);
+        errno = EINVAL;
+        return NULL;
+    }
+    if (verify) {
+        uint64_t checksum = 0;
+        const unsigned char* body = map->base + sizeof(imageHeader);
+        size_t remaining = map->size - sizeof(imageHeader);
+        while (remaining > 0) {
+            size_t n = remaining < IMAGE_BLOCK ? remaining : IMAGE_BLOCK;
+            checksum = _wyhash((const char*)body, n, checksum);
+            body += n;
+            remaining -= n;
+        }
+        if (checksum != header->checksum) {
+            _unmap_file(map);
+            errno = EILSEQ;
+            return NULL;
+        }
+    }
+    return header;
+}
+// --------------------------------------------------------------------------------
+
+struct str_vector_image_t {
+    fileMap map;
+    size_t len;
+    bool sorted;
+    const uint64_t* offsets;
+    const char* strings;
+};
+// --------------------------------------------------------------------------------
+
+str_vector_image_t* open_str_vector_image(const char* path, bool verify) {
+    if (!path) {
+        errno = EINVAL;
+        return NULL;
+    }
+    str_vector_image_t* image = malloc(sizeof(str_vector_image_t));
+    if (!image) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    const imageHeader* header = _image_open(path, IMAGE_STR_VECTOR, verify, &image->map);
+    if (!header) {
+        free(image);
+        return NULL;
+    }
+    size_t body = image->map.size - sizeof(imageHeader);
+    uint64_t count = header->count;
+    // The offset table and the end of the last string must lie inside the file
+    bool valid = count < body / sizeof(uint64_t);
+    if (valid) {
+        image->offsets = (const uint64_t*)(image->map.base + sizeof(imageHeader));
+        image->strings = (const char*)(image->offsets + count + 1);
+        valid = image->offsets[0] == 0 && 
+                image->offsets[count] == body - (count + 1) * sizeof(uint64_t);
+    }
+    // Every string holds at least its terminator, so offsets strictly increase.  
+    // This reads only the offset table, lookups then need no bounds checks
+    for (uint64_t i = 0; valid && i < count; i++) {
+        valid = image->offsets[i] < image->offsets[i + 1];
+    }
+    if (!valid) {
+        _unmap_file(&image->map);
+        free(image);
+        errno = EINVAL;
+        return NULL;
+    }
+    image->len = (size_t)count;
+    image->sorted = (header->flags & IMAGE_SORTED) != 0;
+    return image;
+}
+// --------------------------------------------------------------------------------
+
+const char* str_vector_image_index(const str_vector_image_t* image, size_t index, 
+                                   size_t* len) {
+    if (!image) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (index >= image->len) {
+        errno = ERANGE;
+        return NULL;
+    }
+    if (len) *len = (size_t)(image->offsets[index + 1] - image->offsets[index] - 1);
+    return image->strings + image->offsets[index];
+}
+// --------------------------------------------------------------------------------
+
+size_t str_vector_image_find(const str_vector_image_t* image, const char* value) {
+    if (!image || !value) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t value_len = strlen(value);
+    if (!image->sorted) {
+        for (size_t i = 0; i < image->len; i++) {
+            size_t len = (size_t)(image->offsets[i + 1] - image->offsets[i] - 1);
+            if (_equal_bytes(image->strings + image->offsets[i], len, value, value_len)) {
+                return i;
+            }
+        }
+        return LONG_MAX;
+    }
+    size_t lo = 0;
+    size_t hi = image->len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        size_t len = (size_t)(image->offsets[mid + 1] - image->offsets[mid] - 1);
+        if (_compare_bytes(image->strings + image->offsets[mid], len, value, value_len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < image->len) {
+        size_t len = (size_t)(image->offsets[lo + 1] - image->offsets[lo] - 1);
+        if (_equal_bytes(image->strings + image->offsets[lo], len, value, value_len)) {
+            return lo;
+        }
+    }
+    return LONG_MAX;
+}
+// --------------------------------------------------------------------------------
+
+const size_t str_vector_image_size(const str_vector_image_t* image) {
+    if (!image) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return image->len;
+}
+// --------------------------------------------------------------------------------
+
+void close_str_vector_image(str_vector_image_t* image) {
+    if (!image) {
+        errno = EINVAL;
+        return;
+    }
+    _unmap_file(&image->map);
+    free(image);
+}
+// --------------------------------------------------------------------------------
+
+void _close_str_vector_image(str_vector_image_t** image) {
+    if (image && *image) {
+        close_str_vector_image(*image);
+        *image = NULL;
+    }
+}
+// --------------------------------------------------------------------------------
+
+struct dict_image_t {
+    fileMap map;
+    frozen_dict_t frozen;  // Arrays point into the mapping
+};
+// --------------------------------------------------------------------------------
+
+dict_image_t* open_dict_image(const char* path, bool verify) {
+    if (!path) {
+        errno = EINVAL;
+        return NULL;
+    }
+    dict_image_t* image = malloc(sizeof(dict_image_t));
+    if (!image) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    const imageHeader* header = _image_open(path, IMAGE_DICT, verify, &image->map);
+    if (!header) {
+        free(image);
+        return NULL;
+    }
+    size_t body = image->map.size - sizeof(imageHeader);
+    uint64_t count = header->count;
+    uint64_t buckets = header->buckets;
+    size_t pilot_bytes = (size_t)buckets * sizeof(uint32_t);
+    pilot_bytes += (8 - pilot_bytes % 8) % 8;
+    bool valid = buckets <= body / sizeof(uint32_t) && count <= body / sizeof(frozenSlot) && 
+                 pilot_bytes + count * sizeof(frozenSlot) <= body && buckets > 0;
+    if (valid) {
+        const unsigned char* base = image->map.base + sizeof(imageHeader);
+        image->frozen.len = (size_t)count;
+        image->frozen.buckets = (size_t)buckets;
+        image->frozen.seed = header->seed;
+        // The frozen dict API never writes through these pointers
+        image->frozen.pilots = (uint32_t*)base;
+        image->frozen.slots = (frozenSlot*)(base + pilot_bytes);
+        image->frozen.keys = (char*)(base + pilot_bytes + count * sizeof(frozenSlot));
+        // Keys are packed in slot order, so each slot must start where the 
+        // previous key's terminator ends and the last must end the file
+        size_t key_bytes = body - pilot_bytes - (size_t)count * sizeof(frozenSlot);
+        size_t expected = 0;
+        for (size_t i = 0; valid && i < (size_t)count; i++) {
+            const frozenSlot* slot = &image->frozen.slots[i];
+            valid = slot->offset == expected && slot->key_len < key_bytes - expected;
+            expected += slot->key_len + 1;
+        }
+        valid = valid && expected == key_bytes;
+    }
+    if (!valid) {
+        _unmap_file(&image->map);
+        free(image);
+        errno = EINVAL;
+        return NULL;
+    }
+    return image;
+}
+// --------------------------------------------------------------------------------
+
+size_t get_dict_image_value(const dict_image_t* image, const char* key) {
+    if (!image || !key) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return get_frozen_dict_value(&image->frozen, key);
+}
+// --------------------------------------------------------------------------------
+
+const frozen_dict_t* dict_image_frozen(const dict_image_t* image) {
+    if (!image) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return &image->frozen;
+}
+// --------------------------------------------------------------------------------
+
+const size_t dict_image_size(const dict_image_t* image) {
+    if (!image) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return image->frozen.len;
+}
+// --------------------------------------------------------------------------------
+
+void close_dict_image(dict_image_t* image) {
+    if (!image) {
+        errno = EINVAL;
+        return;
+    }
+    _unmap_file(&image->map);
+    free(image);
+}
+// --------------------------------------------------------------------------------
+
+void _close_dict_image(dict_image_t** image) {
+    if (image && *image) {
+        close_dict_image(*image);
+        *image = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// STRING BUILDER IMPLEMENTATION
+
+/*
+ * The builder functions append in place and grow the buffer geometrically, 
+ * like the vectors, so a line assembled from many pieces costs amortized 
+ * O(1) reallocations per append.  Numbers are written straight into the 
+ * spare capacity, two digits at a time.
+ */
+static const char DIGIT_PAIRS[201] = 
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+static const int FLOAT_FAST_PRECISION = 15;  // Digits after the point the fast path handles
+static const double FLOAT_FAST_LIMIT = 1e15;  // Scaled values below this fit the fast path
+// --------------------------------------------------------------------------------
+
+// Makes room for extra characters plus the null terminator
+static bool _grow_string(string_t* str, size_t extra) {
+    size_t needed = str->len + extra + 1;
+    if (needed <= str->alloc) return true;
+    size_t new_alloc = str->alloc == 0 ? 1 : str->alloc;
+    if (new_alloc < VEC_THRESHOLD) {
+        new_alloc *= 2;
+    } else {
+        new_alloc += VEC_FIXED_AMOUNT;
+    }
+    if (new_alloc < needed) new_alloc = needed;
+    char* ptr = realloc(str->str, new_alloc);
+    if (!ptr) {
+        errno = ENOMEM;
+        fprintf(stderr, "ERROR: Failed to reallocate memory for char* in string builder\n");
+        return false;
+    }
+    str->str = ptr;
+    str->alloc = new_alloc;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static size_t _count_digits(uint64_t value) {
+    size_t digits = 1;
+    while (value >= 10000) {
+        value /= 10000;
+        digits += 4;
+    }
+    if (value >= 10) digits++;
+    if (value >= 100) digits++;
+    if (value >= 1000) digits++;
+    return digits;
+}
+// --------------------------------------------------------------------------------
+
+// Writes exactly digits characters ending at end - 1, zero padding on the left
+static void _write_digits(char* end, uint64_t value, size_t digits) {
+    while (digits >= 2) {
+        size_t pair = (size_t)(value % 100) * 2;
+        value /= 100;
+        *--end = DIGIT_PAIRS[pair + 1];
+        *--end = DIGIT_PAIRS[pair];
+        digits -= 2;
+    }
+    if (digits == 1) *--end = (char)('0' + value % 10);
+}
+// --------------------------------------------------------------------------------
+
+static bool _append_uint(string_t* str, uint64_t value, bool negative) {
+    size_t digits = _count_digits(value);
+    if (!_grow_string(str, digits + negative)) return false;
+    char* out = str->str + str->len;
+    if (negative) *out++ = '-';
+    _write_digits(out + digits, value, digits);
+    str->len += digits + negative;
+    str->str[str->len] = '\0';
+    str->hash = 0;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool string_format_concat(string_t* str, const char* format, ...) {
+    if (!str || !str->str || !format) {
+        errno = EINVAL;
+        return false;
+    }
+    va_list args;
+    va_start(args, format);
+    va_list retry;
+    va_copy(retry, args);
+    // Format into the spare capacity; only a result that does not fit is 
+    // formatted a second time
+    size_t room = str->alloc - str->len;
+    int written = vsnprintf(str->str + str->len, room, format, args);
+    va_end(args);
+    bool ok = written >= 0;
+    if (!ok) {
+        errno = EINVAL;
+    } else if ((size_t)written >= room) {
+        ok = _grow_string(str, (size_t)written);
+        if (ok) vsnprintf(str->str + str->len, (size_t)written + 1, format, retry);
+    }
+    va_end(retry);
+    if (!ok) {
+        str->str[str->len] = '\0';
+        return false;
+    }
+    str->len += (size_t)written;
+    str->hash = 0;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool string_int_concat(string_t* str, long long value) {
+    if (!str || !str->str) {
+        errno = EINVAL;
+        return false;
+    }
+    // Negate in unsigned arithmetic so LLONG_MIN is handled
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    return _append_uint(str, magnitude, value < 0);
+}
+// --------------------------------------------------------------------------------
+
+bool string_uint_concat(string_t* str, unsigned long long value) {
+    if (!str || !str->str) {
+        errno = EINVAL;
+        return false;
+    }
+    return _append_uint(str, (uint64_t)value, false);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * The fast path scales the value by 10^precision and rounds to an integer.  
+ * The scaling is one correctly rounded multiplication, so its error is below 
+ * one ulp of the product; when the fractional part is closer than that to a 
+ * half the rounding direction is ambiguous and snprintf decides instead.  
+ * Output is therefore identical to "%.*f".
+ */
+bool string_float_concat(string_t* str, double value, int precision) {
+    if (!str || !str->str) {
+        errno = EINVAL;
+        return false;
+    }
+    static const double powers[16] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 
+                                      1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    if (precision < 0) precision = 6;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = (bits >> 63) != 0;
+    double magnitude = negative ? -value : value;
+    double scaled = magnitude * powers[precision <= FLOAT_FAST_PRECISION ? precision : 0];
+    // NaN fails this comparison and takes the snprintf path
+    if (precision <= FLOAT_FAST_PRECISION && scaled < FLOAT_FAST_LIMIT) {
+        uint64_t whole = (uint64_t)scaled;
+        double fraction = scaled - (double)whole;
+        double margin = scaled * DBL_EPSILON;
+        double distance = fraction > 0.5 ? fraction - 0.5 : 0.5 - fraction;
+        if (distance > margin) {
+            if (fraction > 0.5) whole++;
+            uint64_t unit = (uint64_t)powers[precision];
+            uint64_t int_part = whole / unit;
+            size_t int_digits = _count_digits(int_part);
+            size_t total = negative + int_digits + (precision > 0 ? (size_t)precision + 1 : 0);
+            if (!_grow_string(str, total)) return false;
+            char* out = str->str + str->len;
+            if (negative) *out++ = '-';
+            _write_digits(out + int_digits, int_part, int_digits);
+            if (precision > 0) {
+                out[int_digits] = '.';
+                _write_digits(out + int_digits + 1 + precision, whole % unit, (size_t)precision);
+            }
+            str->len += total;
+            str->str[str->len] = '\0';
+            str->hash = 0;
+            return true;
+        }
+    }
+    return string_format_concat(str, "%.*f", precision, value);
+}
+// --------------------------------------------------------------------------------
+
+void clear_string(string_t* str) {
+    if (!str || !str->str) {
+        errno = EINVAL;
+        return;
+    }
+    str->len = 0;
+    str->str[0] = '\0';
+    str->hash = 0;
+}
+// ================================================================================
+// ================================================================================
+// NUMBER PARSING IMPLEMENTATION
+
+/*
+ * Parsers for text that is already delimited, such as tokens and CSV fields.  
+ * They read exactly len bytes, accept only the C locale syntax and never 
+ * touch errno.  Doubles are converted with the Eisel-Lemire algorithm: the 
+ * up to 19 significant digits are multiplied by a 128 bit approximation of 
+ * the power of ten, which decides the correctly rounded result except in 
+ * rare near halfway cases.  Those, subnormals and overflow go to strtod.
+ */
+static const int POW10_MIN_EXP = -342;  // Smaller powers round every input to zero
+static const int POW10_MAX_EXP = 308;   // Larger powers overflow every input
+static const int MANTISSA_DIGITS = 19;  // Decimal digits that always fit in 64 bits
+static const uint64_t CLINGER_MAX_MANTISSA = (uint64_t)1 << 53;
+#define PARSE_STACK_BUFFER 128  // strtod copies of this size avoid malloc
+// --------------------------------------------------------------------------------
+
+// 10^e for e in [POW10_MIN_EXP, POW10_MAX_EXP] as {low, high} 64 bit words of 
+// a 128 bit mantissa, normalized so the top bit is set and rounded down
+static const uint64_t POW10_128[651][2] = {
+    {0x113FAA2906A13B3Full, 0xEEF453D6923BD65Aull}, {0x4AC7CA59A424C507ull, 0x9558B4661B6565F8ull},
+    {0x5D79BCF00D2DF649ull, 0xBAAEE17FA23EBF76ull}, {0xF4D82C2C107973DCull, 0xE95A99DF8ACE6F53ull},
+    {0x79071B9B8A4BE869ull, 0x91D8A02BB6C10594ull}, {0x9748E2826CDEE284ull, 0xB64EC836A47146F9ull},
+    {0xFD1B1B2308169B25ull, 0xE3E27A444D8D98B7ull}, {0xFE30F0F5E50E20F7ull, 0x8E6D8C6AB0787F72ull},
+    {0xBDBD2D335E51A935ull, 0xB208EF855C969F4Full}, {0xAD2C788035E61382ull, 0xDE8B2B66B3BC4723ull},
+    {0x4C3BCB5021AFCC31ull, 0x8B16FB203055AC76ull}, {0xDF4ABE242A1BBF3Dull, 0xADDCB9E83C6B1793ull},
+    {0xD71D6DAD34A2AF0Dull, 0xD953E8624B85DD78ull}, {0x8672648C40E5AD68ull, 0x87D4713D6F33AA6Bull},
+    {0x680EFDAF511F18C2ull, 0xA9C98D8CCB009506ull}, {0x0212BD1B2566DEF2ull, 0xD43BF0EFFDC0BA48ull},
+    {0x014BB630F7604B57ull, 0x84A57695FE98746Dull}, {0x419EA3BD35385E2Dull, 0xA5CED43B7E3E9188ull},
+    {0x52064CAC828675B9ull, 0xCF42894A5DCE35EAull}, {0x7343EFEBD1940993ull, 0x818995CE7AA0E1B2ull},
+    {0x1014EBE6C5F90BF8ull, 0xA1EBFB4219491A1Full}, {0xD41A26E077774EF6ull, 0xCA66FA129F9B60A6ull},
+    {0x8920B098955522B4ull, 0xFD00B897478238D0ull}, {0x55B46E5F5D5535B0ull, 0x9E20735E8CB16382ull},
+    {0xEB2189F734AA831Dull, 0xC5A890362FDDBC62ull}, {0xA5E9EC7501D523E4ull, 0xF712B443BBD52B7Bull},
+    {0x47B233C92125366Eull, 0x9A6BB0AA55653B2Dull}, {0x999EC0BB696E840Aull, 0xC1069CD4EABE89F8ull},
+    {0xC00670EA43CA250Dull, 0xF148440A256E2C76ull}, {0x380406926A5E5728ull, 0x96CD2A865764DBCAull},
+    {0xC605083704F5ECF2ull, 0xBC807527ED3E12BCull}, {0xF7864A44C633682Eull, 0xEBA09271E88D976Bull},
+    {0x7AB3EE6AFBE0211Dull, 0x93445B8731587EA3ull}, {0x5960EA05BAD82964ull, 0xB8157268FDAE9E4Cull},
+    {0x6FB92487298E33BDull, 0xE61ACF033D1A45DFull}, {0xA5D3B6D479F8E056ull, 0x8FD0C16206306BABull},
+    {0x8F48A4899877186Cull, 0xB3C4F1BA87BC8696ull}, {0x331ACDABFE94DE87ull, 0xE0B62E2929ABA83Cull},
+    {0x9FF0C08B7F1D0B14ull, 0x8C71DCD9BA0B4925ull}, {0x07ECF0AE5EE44DD9ull, 0xAF8E5410288E1B6Full},
+    {0xC9E82CD9F69D6150ull, 0xDB71E91432B1A24Aull}, {0xBE311C083A225CD2ull, 0x892731AC9FAF056Eull},
+    {0x6DBD630A48AAF406ull, 0xAB70FE17C79AC6CAull}, {0x092CBBCCDAD5B108ull, 0xD64D3D9DB981787Dull},
+    {0x25BBF56008C58EA5ull, 0x85F0468293F0EB4Eull}, {0xAF2AF2B80AF6F24Eull, 0xA76C582338ED2621ull},
+    {0x1AF5AF660DB4AEE1ull, 0xD1476E2C07286FAAull}, {0x50D98D9FC890ED4Dull, 0x82CCA4DB847945CAull},
+    {0xE50FF107BAB528A0ull, 0xA37FCE126597973Cull}, {0x1E53ED49A96272C8ull, 0xCC5FC196FEFD7D0Cull},
+    {0x25E8E89C13BB0F7Aull, 0xFF77B1FCBEBCDC4Full}, {0x77B191618C54E9ACull, 0x9FAACF3DF73609B1ull},
+    {0xD59DF5B9EF6A2417ull, 0xC795830D75038C1Dull}, {0x4B0573286B44AD1Dull, 0xF97AE3D0D2446F25ull},
+    {0x4EE367F9430AEC32ull, 0x9BECCE62836AC577ull}, {0x229C41F793CDA73Full, 0xC2E801FB244576D5ull},
+    {0x6B43527578C1110Full, 0xF3A20279ED56D48Aull}, {0x830A13896B78AAA9ull, 0x9845418C345644D6ull},
+    {0x23CC986BC656D553ull, 0xBE5691EF416BD60Cull}, {0x2CBFBE86B7EC8AA8ull, 0xEDEC366B11C6CB8Full},
+    {0x7BF7D71432F3D6A9ull, 0x94B3A202EB1C3F39ull}, {0xDAF5CCD93FB0CC53ull, 0xB9E08A83A5E34F07ull},
+    {0xD1B3400F8F9CFF68ull, 0xE858AD248F5C22C9ull}, {0x23100809B9C21FA1ull, 0x91376C36D99995BEull},
+    {0xABD40A0C2832A78Aull, 0xB58547448FFFFB2Dull}, {0x16C90C8F323F516Cull, 0xE2E69915B3FFF9F9ull},
+    {0xAE3DA7D97F6792E3ull, 0x8DD01FAD907FFC3Bull}, {0x99CD11CFDF41779Cull, 0xB1442798F49FFB4Aull},
+    {0x40405643D711D583ull, 0xDD95317F31C7FA1Dull}, {0x482835EA666B2572ull, 0x8A7D3EEF7F1CFC52ull},
+    {0xDA3243650005EECFull, 0xAD1C8EAB5EE43B66ull}, {0x90BED43E40076A82ull, 0xD863B256369D4A40ull},
+    {0x5A7744A6E804A291ull, 0x873E4F75E2224E68ull}, {0x711515D0A205CB36ull, 0xA90DE3535AAAE202ull},
+    {0x0D5A5B44CA873E03ull, 0xD3515C2831559A83ull}, {0xE858790AFE9486C2ull, 0x8412D9991ED58091ull},
+    {0x626E974DBE39A872ull, 0xA5178FFF668AE0B6ull}, {0xFB0A3D212DC8128Full, 0xCE5D73FF402D98E3ull},
+    {0x7CE66634BC9D0B99ull, 0x80FA687F881C7F8Eull}, {0x1C1FFFC1EBC44E80ull, 0xA139029F6A239F72ull},
+    {0xA327FFB266B56220ull, 0xC987434744AC874Eull}, {0x4BF1FF9F0062BAA8ull, 0xFBE9141915D7A922ull},
+    {0x6F773FC3603DB4A9ull, 0x9D71AC8FADA6C9B5ull}, {0xCB550FB4384D21D3ull, 0xC4CE17B399107C22ull},
+    {0x7E2A53A146606A48ull, 0xF6019DA07F549B2Bull}, {0x2EDA7444CBFC426Dull, 0x99C102844F94E0FBull},
+    {0xFA911155FEFB5308ull, 0xC0314325637A1939ull}, {0x793555AB7EBA27CAull, 0xF03D93EEBC589F88ull},
+    {0x4BC1558B2F3458DEull, 0x96267C7535B763B5ull}, {0x9EB1AAEDFB016F16ull, 0xBBB01B9283253CA2ull},
+    {0x465E15A979C1CADCull, 0xEA9C227723EE8BCBull}, {0x0BFACD89EC191EC9ull, 0x92A1958A7675175Full},
+    {0xCEF980EC671F667Bull, 0xB749FAED14125D36ull}, {0x82B7E12780E7401Aull, 0xE51C79A85916F484ull},
+    {0xD1B2ECB8B0908810ull, 0x8F31CC0937AE58D2ull}, {0x861FA7E6DCB4AA15ull, 0xB2FE3F0B8599EF07ull},
+    {0x67A791E093E1D49Aull, 0xDFBDCECE67006AC9ull}, {0xE0C8BB2C5C6D24E0ull, 0x8BD6A141006042BDull},
+    {0x58FAE9F773886E18ull, 0xAECC49914078536Dull}, {0xAF39A475506A899Eull, 0xDA7F5BF590966848ull},
+    {0x6D8406C952429603ull, 0x888F99797A5E012Dull}, {0xC8E5087BA6D33B83ull, 0xAAB37FD7D8F58178ull},
+    {0xFB1E4A9A90880A64ull, 0xD5605FCDCF32E1D6ull}, {0x5CF2EEA09A55067Full, 0x855C3BE0A17FCD26ull},
+    {0xF42FAA48C0EA481Eull, 0xA6B34AD8C9DFC06Full}, {0xF13B94DAF124DA26ull, 0xD0601D8EFC57B08Bull},
+    {0x76C53D08D6B70858ull, 0x823C12795DB6CE57ull}, {0x54768C4B0C64CA6Eull, 0xA2CB1717B52481EDull},
+    {0xA9942F5DCF7DFD09ull, 0xCB7DDCDDA26DA268ull}, {0xD3F93B35435D7C4Cull, 0xFE5D54150B090B02ull},
+    {0xC47BC5014A1A6DAFull, 0x9EFA548D26E5A6E1ull}, {0x359AB6419CA1091Bull, 0xC6B8E9B0709F109Aull},
+    {0xC30163D203C94B62ull, 0xF867241C8CC6D4C0ull}, {0x79E0DE63425DCF1Dull, 0x9B407691D7FC44F8ull},
+    {0x985915FC12F542E4ull, 0xC21094364DFB5636ull}, {0x3E6F5B7B17B2939Dull, 0xF294B943E17A2BC4ull},
+    {0xA705992CEECF9C42ull, 0x979CF3CA6CEC5B5Aull}, {0x50C6FF782A838353ull, 0xBD8430BD08277231ull},
+    {0xA4F8BF5635246428ull, 0xECE53CEC4A314EBDull}, {0x871B7795E136BE99ull, 0x940F4613AE5ED136ull},
+    {0x28E2557B59846E3Full, 0xB913179899F68584ull}, {0x331AEADA2FE589CFull, 0xE757DD7EC07426E5ull},
+    {0x3FF0D2C85DEF7621ull, 0x9096EA6F3848984Full}, {0x0FED077A756B53A9ull, 0xB4BCA50B065ABE63ull},
+    {0xD3E8495912C62894ull, 0xE1EBCE4DC7F16DFBull}, {0x64712DD7ABBBD95Cull, 0x8D3360F09CF6E4BDull},
+    {0xBD8D794D96AACFB3ull, 0xB080392CC4349DECull}, {0xECF0D7A0FC5583A0ull, 0xDCA04777F541C567ull},
+    {0xF41686C49DB57244ull, 0x89E42CAAF9491B60ull}, {0x311C2875C522CED5ull, 0xAC5D37D5B79B6239ull},
+    {0x7D633293366B828Bull, 0xD77485CB25823AC7ull}, {0xAE5DFF9C02033197ull, 0x86A8D39EF77164BCull},
+    {0xD9F57F830283FDFCull, 0xA8530886B54DBDEBull}, {0xD072DF63C324FD7Bull, 0xD267CAA862A12D66ull},
+    {0x4247CB9E59F71E6Dull, 0x8380DEA93DA4BC60ull}, {0x52D9BE85F074E608ull, 0xA46116538D0DEB78ull},
+    {0x67902E276C921F8Bull, 0xCD795BE870516656ull}, {0x00BA1CD8A3DB53B6ull, 0x806BD9714632DFF6ull},
+    {0x80E8A40ECCD228A4ull, 0xA086CFCD97BF97F3ull}, {0x6122CD128006B2CDull, 0xC8A883C0FDAF7DF0ull},
+    {0x796B805720085F81ull, 0xFAD2A4B13D1B5D6Cull}, {0xCBE3303674053BB0ull, 0x9CC3A6EEC6311A63ull},
+    {0xBEDBFC4411068A9Cull, 0xC3F490AA77BD60FCull}, {0xEE92FB5515482D44ull, 0xF4F1B4D515ACB93Bull},
+    {0x751BDD152D4D1C4Aull, 0x991711052D8BF3C5ull}, {0xD262D45A78A0635Dull, 0xBF5CD54678EEF0B6ull},
+    {0x86FB897116C87C34ull, 0xEF340A98172AACE4ull}, {0xD45D35E6AE3D4DA0ull, 0x9580869F0E7AAC0Eull},
+    {0x8974836059CCA109ull, 0xBAE0A846D2195712ull}, {0x2BD1A438703FC94Bull, 0xE998D258869FACD7ull},
+    {0x7B6306A34627DDCFull, 0x91FF83775423CC06ull}, {0x1A3BC84C17B1D542ull, 0xB67F6455292CBF08ull},
+    {0x20CABA5F1D9E4A93ull, 0xE41F3D6A7377EECAull}, {0x547EB47B7282EE9Cull, 0x8E938662882AF53Eull},
+    {0xE99E619A4F23AA43ull, 0xB23867FB2A35B28Dull}, {0x6405FA00E2EC94D4ull, 0xDEC681F9F4C31F31ull},
+    {0xDE83BC408DD3DD04ull, 0x8B3C113C38F9F37Eull}, {0x9624AB50B148D445ull, 0xAE0B158B4738705Eull},
+    {0x3BADD624DD9B0957ull, 0xD98DDAEE19068C76ull}, {0xE54CA5D70A80E5D6ull, 0x87F8A8D4CFA417C9ull},
+    {0x5E9FCF4CCD211F4Cull, 0xA9F6D30A038D1DBCull}, {0x7647C3200069671Full, 0xD47487CC8470652Bull},
+    {0x29ECD9F40041E073ull, 0x84C8D4DFD2C63F3Bull}, {0xF468107100525890ull, 0xA5FB0A17C777CF09ull},
+    {0x7182148D4066EEB4ull, 0xCF79CC9DB955C2CCull}, {0xC6F14CD848405530ull, 0x81AC1FE293D599BFull},
+    {0xB8ADA00E5A506A7Cull, 0xA21727DB38CB002Full}, {0xA6D90811F0E4851Cull, 0xCA9CF1D206FDC03Bull},
+    {0x908F4A166D1DA663ull, 0xFD442E4688BD304Aull}, {0x9A598E4E043287FEull, 0x9E4A9CEC15763E2Eull},
+    {0x40EFF1E1853F29FDull, 0xC5DD44271AD3CDBAull}, {0xD12BEE59E68EF47Cull, 0xF7549530E188C128ull},
+    {0x82BB74F8301958CEull, 0x9A94DD3E8CF578B9ull}, {0xE36A52363C1FAF01ull, 0xC13A148E3032D6E7ull},
+    {0xDC44E6C3CB279AC1ull, 0xF18899B1BC3F8CA1ull}, {0x29AB103A5EF8C0B9ull, 0x96F5600F15A7B7E5ull},
+    {0x7415D448F6B6F0E7ull, 0xBCB2B812DB11A5DEull}, {0x111B495B3464AD21ull, 0xEBDF661791D60F56ull},
+    {0xCAB10DD900BEEC34ull, 0x936B9FCEBB25C995ull}, {0x3D5D514F40EEA742ull, 0xB84687C269EF3BFBull},
+    {0x0CB4A5A3112A5112ull, 0xE65829B3046B0AFAull}, {0x47F0E785EABA72ABull, 0x8FF71A0FE2C2E6DCull},
+    {0x59ED216765690F56ull, 0xB3F4E093DB73A093ull}, {0x306869C13EC3532Cull, 0xE0F218B8D25088B8ull},
+    {0x1E414218C73A13FBull, 0x8C974F7383725573ull}, {0xE5D1929EF90898FAull, 0xAFBD2350644EEACFull},
+    {0xDF45F746B74ABF39ull, 0xDBAC6C247D62A583ull}, {0x6B8BBA8C328EB783ull, 0x894BC396CE5DA772ull},
+    {0x066EA92F3F326564ull, 0xAB9EB47C81F5114Full}, {0xC80A537B0EFEFEBDull, 0xD686619BA27255A2ull},
+    {0xBD06742CE95F5F36ull, 0x8613FD0145877585ull}, {0x2C48113823B73704ull, 0xA798FC4196E952E7ull},
+    {0xF75A15862CA504C5ull, 0xD17F3B51FCA3A7A0ull}, {0x9A984D73DBE722FBull, 0x82EF85133DE648C4ull},
+    {0xC13E60D0D2E0EBBAull, 0xA3AB66580D5FDAF5ull}, {0x318DF905079926A8ull, 0xCC963FEE10B7D1B3ull},
+    {0xFDF17746497F7052ull, 0xFFBBCFE994E5C61Full}, {0xFEB6EA8BEDEFA633ull, 0x9FD561F1FD0F9BD3ull},
+    {0xFE64A52EE96B8FC0ull, 0xC7CABA6E7C5382C8ull}, {0x3DFDCE7AA3C673B0ull, 0xF9BD690A1B68637Bull},
+    {0x06BEA10CA65C084Eull, 0x9C1661A651213E2Dull}, {0x486E494FCFF30A62ull, 0xC31BFA0FE5698DB8ull},
+    {0x5A89DBA3C3EFCCFAull, 0xF3E2F893DEC3F126ull}, {0xF89629465A75E01Cull, 0x986DDB5C6B3A76B7ull},
+    {0xF6BBB397F1135823ull, 0xBE89523386091465ull}, {0x746AA07DED582E2Cull, 0xEE2BA6C0678B597Full},
+    {0xA8C2A44EB4571CDCull, 0x94DB483840B717EFull}, {0x92F34D62616CE413ull, 0xBA121A4650E4DDEBull},
+    {0x77B020BAF9C81D17ull, 0xE896A0D7E51E1566ull}, {0x0ACE1474DC1D122Eull, 0x915E2486EF32CD60ull},
+    {0x0D819992132456BAull, 0xB5B5ADA8AAFF80B8ull}, {0x10E1FFF697ED6C69ull, 0xE3231912D5BF60E6ull},
+    {0xCA8D3FFA1EF463C1ull, 0x8DF5EFABC5979C8Full}, {0xBD308FF8A6B17CB2ull, 0xB1736B96B6FD83B3ull},
+    {0xAC7CB3F6D05DDBDEull, 0xDDD0467C64BCE4A0ull}, {0x6BCDF07A423AA96Bull, 0x8AA22C0DBEF60EE4ull},
+    {0x86C16C98D2C953C6ull, 0xAD4AB7112EB3929Dull}, {0xE871C7BF077BA8B7ull, 0xD89D64D57A607744ull},
+    {0x11471CD764AD4972ull, 0x87625F056C7C4A8Bull}, {0xD598E40D3DD89BCFull, 0xA93AF6C6C79B5D2Dull},
+    {0x4AFF1D108D4EC2C3ull, 0xD389B47879823479ull}, {0xCEDF722A585139BAull, 0x843610CB4BF160CBull},
+    {0xC2974EB4EE658828ull, 0xA54394FE1EEDB8FEull}, {0x733D226229FEEA32ull, 0xCE947A3DA6A9273Eull},
+    {0x0806357D5A3F525Full, 0x811CCC668829B887ull}, {0xCA07C2DCB0CF26F7ull, 0xA163FF802A3426A8ull},
+    {0xFC89B393DD02F0B5ull, 0xC9BCFF6034C13052ull}, {0xBBAC2078D443ACE2ull, 0xFC2C3F3841F17C67ull},
+    {0xD54B944B84AA4C0Dull, 0x9D9BA7832936EDC0ull}, {0x0A9E795E65D4DF11ull, 0xC5029163F384A931ull},
+    {0x4D4617B5FF4A16D5ull, 0xF64335BCF065D37Dull}, {0x504BCED1BF8E4E45ull, 0x99EA0196163FA42Eull},
+    {0xE45EC2862F71E1D6ull, 0xC06481FB9BCF8D39ull}, {0x5D767327BB4E5A4Cull, 0xF07DA27A82C37088ull},
+    {0x3A6A07F8D510F86Full, 0x964E858C91BA2655ull}, {0x890489F70A55368Bull, 0xBBE226EFB628AFEAull},
+    {0x2B45AC74CCEA842Eull, 0xEADAB0ABA3B2DBE5ull}, {0x3B0B8BC90012929Dull, 0x92C8AE6B464FC96Full},
+    {0x09CE6EBB40173744ull, 0xB77ADA0617E3BBCBull}, {0xCC420A6A101D0515ull, 0xE55990879DDCAABDull},
+    {0x9FA946824A12232Dull, 0x8F57FA54C2A9EAB6ull}, {0x47939822DC96ABF9ull, 0xB32DF8E9F3546564ull},
+    {0x59787E2B93BC56F7ull, 0xDFF9772470297EBDull}, {0x57EB4EDB3C55B65Aull, 0x8BFBEA76C619EF36ull},
+    {0xEDE622920B6B23F1ull, 0xAEFAE51477A06B03ull}, {0xE95FAB368E45ECEDull, 0xDAB99E59958885C4ull},
+    {0x11DBCB0218EBB414ull, 0x88B402F7FD75539Bull}, {0xD652BDC29F26A119ull, 0xAAE103B5FCD2A881ull},
+    {0x4BE76D3346F0495Full, 0xD59944A37C0752A2ull}, {0x6F70A4400C562DDBull, 0x857FCAE62D8493A5ull},
+    {0xCB4CCD500F6BB952ull, 0xA6DFBD9FB8E5B88Eull}, {0x7E2000A41346A7A7ull, 0xD097AD07A71F26B2ull},
+    {0x8ED400668C0C28C8ull, 0x825ECC24C873782Full}, {0x728900802F0F32FAull, 0xA2F67F2DFA90563Bull},
+    {0x4F2B40A03AD2FFB9ull, 0xCBB41EF979346BCAull}, {0xE2F610C84987BFA8ull, 0xFEA126B7D78186BCull},
+    {0x0DD9CA7D2DF4D7C9ull, 0x9F24B832E6B0F436ull}, {0x91503D1C79720DBBull, 0xC6EDE63FA05D3143ull},
+    {0x75A44C6397CE912Aull, 0xF8A95FCF88747D94ull}, {0xC986AFBE3EE11ABAull, 0x9B69DBE1B548CE7Cull},
+    {0xFBE85BADCE996168ull, 0xC24452DA229B021Bull}, {0xFAE27299423FB9C3ull, 0xF2D56790AB41C2A2ull},
+    {0xDCCD879FC967D41Aull, 0x97C560BA6B0919A5ull}, {0x5400E987BBC1C920ull, 0xBDB6B8E905CB600Full},
+    {0x290123E9AAB23B68ull, 0xED246723473E3813ull}, {0xF9A0B6720AAF6521ull, 0x9436C0760C86E30Bull},
+    {0xF808E40E8D5B3E69ull, 0xB94470938FA89BCEull}, {0xB60B1D1230B20E04ull, 0xE7958CB87392C2C2ull},
+    {0xB1C6F22B5E6F48C2ull, 0x90BD77F3483BB9B9ull}, {0x1E38AEB6360B1AF3ull, 0xB4ECD5F01A4AA828ull},
+    {0x25C6DA63C38DE1B0ull, 0xE2280B6C20DD5232ull}, {0x579C487E5A38AD0Eull, 0x8D590723948A535Full},
+    {0x2D835A9DF0C6D851ull, 0xB0AF48EC79ACE837ull}, {0xF8E431456CF88E65ull, 0xDCDB1B2798182244ull},
+    {0x1B8E9ECB641B58FFull, 0x8A08F0F8BF0F156Bull}, {0xE272467E3D222F3Full, 0xAC8B2D36EED2DAC5ull},
+    {0x5B0ED81DCC6ABB0Full, 0xD7ADF884AA879177ull}, {0x98E947129FC2B4E9ull, 0x86CCBB52EA94BAEAull},
+    {0x3F2398D747B36224ull, 0xA87FEA27A539E9A5ull}, {0x8EEC7F0D19A03AADull, 0xD29FE4B18E88640Eull},
+    {0x1953CF68300424ACull, 0x83A3EEEEF9153E89ull}, {0x5FA8C3423C052DD7ull, 0xA48CEAAAB75A8E2Bull},
+    {0x3792F412CB06794Dull, 0xCDB02555653131B6ull}, {0xE2BBD88BBEE40BD0ull, 0x808E17555F3EBF11ull},
+    {0x5B6ACEAEAE9D0EC4ull, 0xA0B19D2AB70E6ED6ull}, {0xF245825A5A445275ull, 0xC8DE047564D20A8Bull},
+    {0xEED6E2F0F0D56712ull, 0xFB158592BE068D2Eull}, {0x55464DD69685606Bull, 0x9CED737BB6C4183Dull},
+    {0xAA97E14C3C26B886ull, 0xC428D05AA4751E4Cull}, {0xD53DD99F4B3066A8ull, 0xF53304714D9265DFull},
+    {0xE546A8038EFE4029ull, 0x993FE2C6D07B7FABull}, {0xDE98520472BDD033ull, 0xBF8FDB78849A5F96ull},
+    {0x963E66858F6D4440ull, 0xEF73D256A5C0F77Cull}, {0xDDE7001379A44AA8ull, 0x95A8637627989AADull},
+    {0x5560C018580D5D52ull, 0xBB127C53B17EC159ull}, {0xAAB8F01E6E10B4A6ull, 0xE9D71B689DDE71AFull},
+    {0xCAB3961304CA70E8ull, 0x9226712162AB070Dull}, {0x3D607B97C5FD0D22ull, 0xB6B00D69BB55C8D1ull},
+    {0x8CB89A7DB77C506Aull, 0xE45C10C42A2B3B05ull}, {0x77F3608E92ADB242ull, 0x8EB98A7A9A5B04E3ull},
+    {0x55F038B237591ED3ull, 0xB267ED1940F1C61Cull}, {0x6B6C46DEC52F6688ull, 0xDF01E85F912E37A3ull},
+    {0x2323AC4B3B3DA015ull, 0x8B61313BBABCE2C6ull}, {0xABEC975E0A0D081Aull, 0xAE397D8AA96C1B77ull},
+    {0x96E7BD358C904A21ull, 0xD9C7DCED53C72255ull}, {0x7E50D64177DA2E54ull, 0x881CEA14545C7575ull},
+    {0xDDE50BD1D5D0B9E9ull, 0xAA242499697392D2ull}, {0x955E4EC64B44E864ull, 0xD4AD2DBFC3D07787ull},
+    {0xBD5AF13BEF0B113Eull, 0x84EC3C97DA624AB4ull}, {0xECB1AD8AEACDD58Eull, 0xA6274BBDD0FADD61ull},
+    {0x67DE18EDA5814AF2ull, 0xCFB11EAD453994BAull}, {0x80EACF948770CED7ull, 0x81CEB32C4B43FCF4ull},
+    {0xA1258379A94D028Dull, 0xA2425FF75E14FC31ull}, {0x096EE45813A04330ull, 0xCAD2F7F5359A3B3Eull},
+    {0x8BCA9D6E188853FCull, 0xFD87B5F28300CA0Dull}, {0x775EA264CF55347Dull, 0x9E74D1B791E07E48ull},
+    {0x95364AFE032A819Dull, 0xC612062576589DDAull}, {0x3A83DDBD83F52204ull, 0xF79687AED3EEC551ull},
+    {0xC4926A9672793542ull, 0x9ABE14CD44753B52ull}, {0x75B7053C0F178293ull, 0xC16D9A0095928A27ull},
+    {0x5324C68B12DD6338ull, 0xF1C90080BAF72CB1ull}, {0xD3F6FC16EBCA5E03ull, 0x971DA05074DA7BEEull},
+    {0x88F4BB1CA6BCF584ull, 0xBCE5086492111AEAull}, {0x2B31E9E3D06C32E5ull, 0xEC1E4A7DB69561A5ull},
+    {0x3AFF322E62439FCFull, 0x9392EE8E921D5D07ull}, {0x09BEFEB9FAD487C2ull, 0xB877AA3236A4B449ull},
+    {0x4C2EBE687989A9B3ull, 0xE69594BEC44DE15Bull}, {0x0F9D37014BF60A10ull, 0x901D7CF73AB0ACD9ull},
+    {0x538484C19EF38C94ull, 0xB424DC35095CD80Full}, {0x2865A5F206B06FB9ull, 0xE12E13424BB40E13ull},
+    {0xF93F87B7442E45D3ull, 0x8CBCCC096F5088CBull}, {0xF78F69A51539D748ull, 0xAFEBFF0BCB24AAFEull},
+    {0xB573440E5A884D1Bull, 0xDBE6FECEBDEDD5BEull}, {0x31680A88F8953030ull, 0x89705F4136B4A597ull},
+    {0xFDC20D2B36BA7C3Dull, 0xABCC77118461CEFCull}, {0x3D32907604691B4Cull, 0xD6BF94D5E57A42BCull},
+    {0xA63F9A49C2C1B10Full, 0x8637BD05AF6C69B5ull}, {0x0FCF80DC33721D53ull, 0xA7C5AC471B478423ull},
+    {0xD3C36113404EA4A8ull, 0xD1B71758E219652Bull}, {0x645A1CAC083126E9ull, 0x83126E978D4FDF3Bull},
+    {0x3D70A3D70A3D70A3ull, 0xA3D70A3D70A3D70Aull}, {0xCCCCCCCCCCCCCCCCull, 0xCCCCCCCCCCCCCCCCull},
+    {0x0000000000000000ull, 0x8000000000000000ull}, {0x0000000000000000ull, 0xA000000000000000ull},
+    {0x0000000000000000ull, 0xC800000000000000ull}, {0x0000000000000000ull, 0xFA00000000000000ull},
+    {0x0000000000000000ull, 0x9C40000000000000ull}, {0x0000000000000000ull, 0xC350000000000000ull},
+    {0x0000000000000000ull, 0xF424000000000000ull}, {0x0000000000000000ull, 0x9896800000000000ull},
+    {0x0000000000000000ull, 0xBEBC200000000000ull}, {0x0000000000000000ull, 0xEE6B280000000000ull},
+    {0x0000000000000000ull, 0x9502F90000000000ull}, {0x0000000000000000ull, 0xBA43B74000000000ull},
+    {0x0000000000000000ull, 0xE8D4A51000000000ull}, {0x0000000000000000ull, 0x9184E72A00000000ull},
+    {0x0000000000000000ull, 0xB5E620F480000000ull}, {0x0000000000000000ull, 0xE35FA931A0000000ull},
+    {0x0000000000000000ull, 0x8E1BC9BF04000000ull}, {0x0000000000000000ull, 0xB1A2BC2EC5000000ull},
+    {0x0000000000000000ull, 0xDE0B6B3A76400000ull}, {0x0000000000000000ull, 0x8AC7230489E80000ull},
+    {0x0000000000000000ull, 0xAD78EBC5AC620000ull}, {0x0000000000000000ull, 0xD8D726B7177A8000ull},
+    {0x0000000000000000ull, 0x878678326EAC9000ull}, {0x0000000000000000ull, 0xA968163F0A57B400ull},
+    {0x0000000000000000ull, 0xD3C21BCECCEDA100ull}, {0x0000000000000000ull, 0x84595161401484A0ull},
+    {0x0000000000000000ull, 0xA56FA5B99019A5C8ull}, {0x0000000000000000ull, 0xCECB8F27F4200F3Aull},
+    {0x4000000000000000ull, 0x813F3978F8940984ull}, {0x5000000000000000ull, 0xA18F07D736B90BE5ull},
+    {0xA400000000000000ull, 0xC9F2C9CD04674EDEull}, {0x4D00000000000000ull, 0xFC6F7C4045812296ull},
+    {0xF020000000000000ull, 0x9DC5ADA82B70B59Dull}, {0x6C28000000000000ull, 0xC5371912364CE305ull},
+    {0xC732000000000000ull, 0xF684DF56C3E01BC6ull}, {0x3C7F400000000000ull, 0x9A130B963A6C115Cull},
+    {0x4B9F100000000000ull, 0xC097CE7BC90715B3ull}, {0x1E86D40000000000ull, 0xF0BDC21ABB48DB20ull},
+    {0x1314448000000000ull, 0x96769950B50D88F4ull}, {0x17D955A000000000ull, 0xBC143FA4E250EB31ull},
+    {0x5DCFAB0800000000ull, 0xEB194F8E1AE525FDull}, {0x5AA1CAE500000000ull, 0x92EFD1B8D0CF37BEull},
+    {0xF14A3D9E40000000ull, 0xB7ABC627050305ADull}, {0x6D9CCD05D0000000ull, 0xE596B7B0C643C719ull},
+    {0xE4820023A2000000ull, 0x8F7E32CE7BEA5C6Full}, {0xDDA2802C8A800000ull, 0xB35DBF821AE4F38Bull},
+    {0xD50B2037AD200000ull, 0xE0352F62A19E306Eull}, {0x4526F422CC340000ull, 0x8C213D9DA502DE45ull},
+    {0x9670B12B7F410000ull, 0xAF298D050E4395D6ull}, {0x3C0CDD765F114000ull, 0xDAF3F04651D47B4Cull},
+    {0xA5880A69FB6AC800ull, 0x88D8762BF324CD0Full}, {0x8EEA0D047A457A00ull, 0xAB0E93B6EFEE0053ull},
+    {0x72A4904598D6D880ull, 0xD5D238A4ABE98068ull}, {0x47A6DA2B7F864750ull, 0x85A36366EB71F041ull},
+    {0x999090B65F67D924ull, 0xA70C3C40A64E6C51ull}, {0xFFF4B4E3F741CF6Dull, 0xD0CF4B50CFE20765ull},
+    {0xBFF8F10E7A8921A4ull, 0x82818F1281ED449Full}, {0xAFF72D52192B6A0Dull, 0xA321F2D7226895C7ull},
+    {0x9BF4F8A69F764490ull, 0xCBEA6F8CEB02BB39ull}, {0x02F236D04753D5B4ull, 0xFEE50B7025C36A08ull},
+    {0x01D762422C946590ull, 0x9F4F2726179A2245ull}, {0x424D3AD2B7B97EF5ull, 0xC722F0EF9D80AAD6ull},
+    {0xD2E0898765A7DEB2ull, 0xF8EBAD2B84E0D58Bull}, {0x63CC55F49F88EB2Full, 0x9B934C3B330C8577ull},
+    {0x3CBF6B71C76B25FBull, 0xC2781F49FFCFA6D5ull}, {0x8BEF464E3945EF7Aull, 0xF316271C7FC3908Aull},
+    {0x97758BF0E3CBB5ACull, 0x97EDD871CFDA3A56ull}, {0x3D52EEED1CBEA317ull, 0xBDE94E8E43D0C8ECull},
+    {0x4CA7AAA863EE4BDDull, 0xED63A231D4C4FB27ull}, {0x8FE8CAA93E74EF6Aull, 0x945E455F24FB1CF8ull},
+    {0xB3E2FD538E122B44ull, 0xB975D6B6EE39E436ull}, {0x60DBBCA87196B616ull, 0xE7D34C64A9C85D44ull},
+    {0xBC8955E946FE31CDull, 0x90E40FBEEA1D3A4Aull}, {0x6BABAB6398BDBE41ull, 0xB51D13AEA4A488DDull},
+    {0xC696963C7EED2DD1ull, 0xE264589A4DCDAB14ull}, {0xFC1E1DE5CF543CA2ull, 0x8D7EB76070A08AECull},
+    {0x3B25A55F43294BCBull, 0xB0DE65388CC8ADA8ull}, {0x49EF0EB713F39EBEull, 0xDD15FE86AFFAD912ull},
+    {0x6E3569326C784337ull, 0x8A2DBF142DFCC7ABull}, {0x49C2C37F07965404ull, 0xACB92ED9397BF996ull},
+    {0xDC33745EC97BE906ull, 0xD7E77A8F87DAF7FBull}, {0x69A028BB3DED71A3ull, 0x86F0AC99B4E8DAFDull},
+    {0xC40832EA0D68CE0Cull, 0xA8ACD7C0222311BCull}, {0xF50A3FA490C30190ull, 0xD2D80DB02AABD62Bull},
+    {0x792667C6DA79E0FAull, 0x83C7088E1AAB65DBull}, {0x577001B891185938ull, 0xA4B8CAB1A1563F52ull},
+    {0xED4C0226B55E6F86ull, 0xCDE6FD5E09ABCF26ull}, {0x544F8158315B05B4ull, 0x80B05E5AC60B6178ull},
+    {0x696361AE3DB1C721ull, 0xA0DC75F1778E39D6ull}, {0x03BC3A19CD1E38E9ull, 0xC913936DD571C84Cull},
+    {0x04AB48A04065C723ull, 0xFB5878494ACE3A5Full}, {0x62EB0D64283F9C76ull, 0x9D174B2DCEC0E47Bull},
+    {0x3BA5D0BD324F8394ull, 0xC45D1DF942711D9Aull}, {0xCA8F44EC7EE36479ull, 0xF5746577930D6500ull},
+    {0x7E998B13CF4E1ECBull, 0x9968BF6ABBE85F20ull}, {0x9E3FEDD8C321A67Eull, 0xBFC2EF456AE276E8ull},
+    {0xC5CFE94EF3EA101Eull, 0xEFB3AB16C59B14A2ull}, {0xBBA1F1D158724A12ull, 0x95D04AEE3B80ECE5ull},
+    {0x2A8A6E45AE8EDC97ull, 0xBB445DA9CA61281Full}, {0xF52D09D71A3293BDull, 0xEA1575143CF97226ull},
+    {0x593C2626705F9C56ull, 0x924D692CA61BE758ull}, {0x6F8B2FB00C77836Cull, 0xB6E0C377CFA2E12Eull},
+    {0x0B6DFB9C0F956447ull, 0xE498F455C38B997Aull}, {0x4724BD4189BD5EACull, 0x8EDF98B59A373FECull},
+    {0x58EDEC91EC2CB657ull, 0xB2977EE300C50FE7ull}, {0x2F2967B66737E3EDull, 0xDF3D5E9BC0F653E1ull},
+    {0xBD79E0D20082EE74ull, 0x8B865B215899F46Cull}, {0xECD8590680A3AA11ull, 0xAE67F1E9AEC07187ull},
+    {0xE80E6F4820CC9495ull, 0xDA01EE641A708DE9ull}, {0x3109058D147FDCDDull, 0x884134FE908658B2ull},
+    {0xBD4B46F0599FD415ull, 0xAA51823E34A7EEDEull}, {0x6C9E18AC7007C91Aull, 0xD4E5E2CDC1D1EA96ull},
+    {0x03E2CF6BC604DDB0ull, 0x850FADC09923329Eull}, {0x84DB8346B786151Cull, 0xA6539930BF6BFF45ull},
+    {0xE612641865679A63ull, 0xCFE87F7CEF46FF16ull}, {0x4FCB7E8F3F60C07Eull, 0x81F14FAE158C5F6Eull},
+    {0xE3BE5E330F38F09Dull, 0xA26DA3999AEF7749ull}, {0x5CADF5BFD3072CC5ull, 0xCB090C8001AB551Cull},
+    {0x73D9732FC7C8F7F6ull, 0xFDCB4FA002162A63ull}, {0x2867E7FDDCDD9AFAull, 0x9E9F11C4014DDA7Eull},
+    {0xB281E1FD541501B8ull, 0xC646D63501A1511Dull}, {0x1F225A7CA91A4226ull, 0xF7D88BC24209A565ull},
+    {0x3375788DE9B06958ull, 0x9AE757596946075Full}, {0x0052D6B1641C83AEull, 0xC1A12D2FC3978937ull},
+    {0xC0678C5DBD23A49Aull, 0xF209787BB47D6B84ull}, {0xF840B7BA963646E0ull, 0x9745EB4D50CE6332ull},
+    {0xB650E5A93BC3D898ull, 0xBD176620A501FBFFull}, {0xA3E51F138AB4CEBEull, 0xEC5D3FA8CE427AFFull},
+    {0xC66F336C36B10137ull, 0x93BA47C980E98CDFull}, {0xB80B0047445D4184ull, 0xB8A8D9BBE123F017ull},
+    {0xA60DC059157491E5ull, 0xE6D3102AD96CEC1Dull}, {0x87C89837AD68DB2Full, 0x9043EA1AC7E41392ull},
+    {0x29BABE4598C311FBull, 0xB454E4A179DD1877ull}, {0xF4296DD6FEF3D67Aull, 0xE16A1DC9D8545E94ull},
+    {0x1899E4A65F58660Cull, 0x8CE2529E2734BB1Dull}, {0x5EC05DCFF72E7F8Full, 0xB01AE745B101E9E4ull},
+    {0x76707543F4FA1F73ull, 0xDC21A1171D42645Dull}, {0x6A06494A791C53A8ull, 0x899504AE72497EBAull},
+    {0x0487DB9D17636892ull, 0xABFA45DA0EDBDE69ull}, {0x45A9D2845D3C42B6ull, 0xD6F8D7509292D603ull},
+    {0x0B8A2392BA45A9B2ull, 0x865B86925B9BC5C2ull}, {0x8E6CAC7768D7141Eull, 0xA7F26836F282B732ull},
+    {0x3207D795430CD926ull, 0xD1EF0244AF2364FFull}, {0x7F44E6BD49E807B8ull, 0x8335616AED761F1Full},
+    {0x5F16206C9C6209A6ull, 0xA402B9C5A8D3A6E7ull}, {0x36DBA887C37A8C0Full, 0xCD036837130890A1ull},
+    {0xC2494954DA2C9789ull, 0x802221226BE55A64ull}, {0xF2DB9BAA10B7BD6Cull, 0xA02AA96B06DEB0FDull},
+    {0x6F92829494E5ACC7ull, 0xC83553C5C8965D3Dull}, {0xCB772339BA1F17F9ull, 0xFA42A8B73ABBF48Cull},
+    {0xFF2A760414536EFBull, 0x9C69A97284B578D7ull}, {0xFEF5138519684ABAull, 0xC38413CF25E2D70Dull},
+    {0x7EB258665FC25D69ull, 0xF46518C2EF5B8CD1ull}, {0xEF2F773FFBD97A61ull, 0x98BF2F79D5993802ull},
+    {0xAAFB550FFACFD8FAull, 0xBEEEFB584AFF8603ull}, {0x95BA2A53F983CF38ull, 0xEEAABA2E5DBF6784ull},
+    {0xDD945A747BF26183ull, 0x952AB45CFA97A0B2ull}, {0x94F971119AEEF9E4ull, 0xBA756174393D88DFull},
+    {0x7A37CD5601AAB85Dull, 0xE912B9D1478CEB17ull}, {0xAC62E055C10AB33Aull, 0x91ABB422CCB812EEull},
+    {0x577B986B314D6009ull, 0xB616A12B7FE617AAull}, {0xED5A7E85FDA0B80Bull, 0xE39C49765FDF9D94ull},
+    {0x14588F13BE847307ull, 0x8E41ADE9FBEBC27Dull}, {0x596EB2D8AE258FC8ull, 0xB1D219647AE6B31Cull},
+    {0x6FCA5F8ED9AEF3BBull, 0xDE469FBD99A05FE3ull}, {0x25DE7BB9480D5854ull, 0x8AEC23D680043BEEull},
+    {0xAF561AA79A10AE6Aull, 0xADA72CCC20054AE9ull}, {0x1B2BA1518094DA04ull, 0xD910F7FF28069DA4ull},
+    {0x90FB44D2F05D0842ull, 0x87AA9AFF79042286ull}, {0x353A1607AC744A53ull, 0xA99541BF57452B28ull},
+    {0x42889B8997915CE8ull, 0xD3FA922F2D1675F2ull}, {0x69956135FEBADA11ull, 0x847C9B5D7C2E09B7ull},
+    {0x43FAB9837E699095ull, 0xA59BC234DB398C25ull}, {0x94F967E45E03F4BBull, 0xCF02B2C21207EF2Eull},
+    {0x1D1BE0EEBAC278F5ull, 0x8161AFB94B44F57Dull}, {0x6462D92A69731732ull, 0xA1BA1BA79E1632DCull},
+    {0x7D7B8F7503CFDCFEull, 0xCA28A291859BBF93ull}, {0x5CDA735244C3D43Eull, 0xFCB2CB35E702AF78ull},
+    {0x3A0888136AFA64A7ull, 0x9DEFBF01B061ADABull}, {0x088AAA1845B8FDD0ull, 0xC56BAEC21C7A1916ull},
+    {0x8AAD549E57273D45ull, 0xF6C69A72A3989F5Bull}, {0x36AC54E2F678864Bull, 0x9A3C2087A63F6399ull},
+    {0x84576A1BB416A7DDull, 0xC0CB28A98FCF3C7Full}, {0x656D44A2A11C51D5ull, 0xF0FDF2D3F3C30B9Full},
+    {0x9F644AE5A4B1B325ull, 0x969EB7C47859E743ull}, {0x873D5D9F0DDE1FEEull, 0xBC4665B596706114ull},
+    {0xA90CB506D155A7EAull, 0xEB57FF22FC0C7959ull}, {0x09A7F12442D588F2ull, 0x9316FF75DD87CBD8ull},
+    {0x0C11ED6D538AEB2Full, 0xB7DCBF5354E9BECEull}, {0x8F1668C8A86DA5FAull, 0xE5D3EF282A242E81ull},
+    {0xF96E017D694487BCull, 0x8FA475791A569D10ull}, {0x37C981DCC395A9ACull, 0xB38D92D760EC4455ull},
+    {0x85BBE253F47B1417ull, 0xE070F78D3927556Aull}, {0x93956D7478CCEC8Eull, 0x8C469AB843B89562ull},
+    {0x387AC8D1970027B2ull, 0xAF58416654A6BABBull}, {0x06997B05FCC0319Eull, 0xDB2E51BFE9D0696Aull},
+    {0x441FECE3BDF81F03ull, 0x88FCF317F22241E2ull}, {0xD527E81CAD7626C3ull, 0xAB3C2FDDEEAAD25Aull},
+    {0x8A71E223D8D3B074ull, 0xD60B3BD56A5586F1ull}, {0xF6872D5667844E49ull, 0x85C7056562757456ull},
+    {0xB428F8AC016561DBull, 0xA738C6BEBB12D16Cull}, {0xE13336D701BEBA52ull, 0xD106F86E69D785C7ull},
+    {0xECC0024661173473ull, 0x82A45B450226B39Cull}, {0x27F002D7F95D0190ull, 0xA34D721642B06084ull},
+    {0x31EC038DF7B441F4ull, 0xCC20CE9BD35C78A5ull}, {0x7E67047175A15271ull, 0xFF290242C83396CEull},
+    {0x0F0062C6E984D386ull, 0x9F79A169BD203E41ull}, {0x52C07B78A3E60868ull, 0xC75809C42C684DD1ull},
+    {0xA7709A56CCDF8A82ull, 0xF92E0C3537826145ull}, {0x88A66076400BB691ull, 0x9BBCC7A142B17CCBull},
+    {0x6ACFF893D00EA435ull, 0xC2ABF989935DDBFEull}, {0x0583F6B8C4124D43ull, 0xF356F7EBF83552FEull},
+    {0xC3727A337A8B704Aull, 0x98165AF37B2153DEull}, {0x744F18C0592E4C5Cull, 0xBE1BF1B059E9A8D6ull},
+    {0x1162DEF06F79DF73ull, 0xEDA2EE1C7064130Cull}, {0x8ADDCB5645AC2BA8ull, 0x9485D4D1C63E8BE7ull},
+    {0x6D953E2BD7173692ull, 0xB9A74A0637CE2EE1ull}, {0xC8FA8DB6CCDD0437ull, 0xE8111C87C5C1BA99ull},
+    {0x1D9C9892400A22A2ull, 0x910AB1D4DB9914A0ull}, {0x2503BEB6D00CAB4Bull, 0xB54D5E4A127F59C8ull},
+    {0x2E44AE64840FD61Dull, 0xE2A0B5DC971F303Aull}, {0x5CEAECFED289E5D2ull, 0x8DA471A9DE737E24ull},
+    {0x7425A83E872C5F47ull, 0xB10D8E1456105DADull}, {0xD12F124E28F77719ull, 0xDD50F1996B947518ull},
+    {0x82BD6B70D99AAA6Full, 0x8A5296FFE33CC92Full}, {0x636CC64D1001550Bull, 0xACE73CBFDC0BFB7Bull},
+    {0x3C47F7E05401AA4Eull, 0xD8210BEFD30EFA5Aull}, {0x65ACFAEC34810A71ull, 0x8714A775E3E95C78ull},
+    {0x7F1839A741A14D0Dull, 0xA8D9D1535CE3B396ull}, {0x1EDE48111209A050ull, 0xD31045A8341CA07Cull},
+    {0x934AED0AAB460432ull, 0x83EA2B892091E44Dull}, {0xF81DA84D5617853Full, 0xA4E4B66B68B65D60ull},
+    {0x36251260AB9D668Eull, 0xCE1DE40642E3F4B9ull}, {0xC1D72B7C6B426019ull, 0x80D2AE83E9CE78F3ull},
+    {0xB24CF65B8612F81Full, 0xA1075A24E4421730ull}, {0xDEE033F26797B627ull, 0xC94930AE1D529CFCull},
+    {0x169840EF017DA3B1ull, 0xFB9B7CD9A4A7443Cull}, {0x8E1F289560EE864Eull, 0x9D412E0806E88AA5ull},
+    {0xF1A6F2BAB92A27E2ull, 0xC491798A08A2AD4Eull}, {0xAE10AF696774B1DBull, 0xF5B5D7EC8ACB58A2ull},
+    {0xACCA6DA1E0A8EF29ull, 0x9991A6F3D6BF1765ull}, {0x17FD090A58D32AF3ull, 0xBFF610B0CC6EDD3Full},
+    {0xDDFC4B4CEF07F5B0ull, 0xEFF394DCFF8A948Eull}, {0x4ABDAF101564F98Eull, 0x95F83D0A1FB69CD9ull},
+    {0x9D6D1AD41ABE37F1ull, 0xBB764C4CA7A4440Full}, {0x84C86189216DC5EDull, 0xEA53DF5FD18D5513ull},
+    {0x32FD3CF5B4E49BB4ull, 0x92746B9BE2F8552Cull}, {0x3FBC8C33221DC2A1ull, 0xB7118682DBB66A77ull},
+    {0x0FABAF3FEAA5334Aull, 0xE4D5E82392A40515ull}, {0x29CB4D87F2A7400Eull, 0x8F05B1163BA6832Dull},
+    {0x743E20E9EF511012ull, 0xB2C71D5BCA9023F8ull}, {0x914DA9246B255416ull, 0xDF78E4B2BD342CF6ull},
+    {0x1AD089B6C2F7548Eull, 0x8BAB8EEFB6409C1Aull}, {0xA184AC2473B529B1ull, 0xAE9672ABA3D0C320ull},
+    {0xC9E5D72D90A2741Eull, 0xDA3C0F568CC4F3E8ull}, {0x7E2FA67C7A658892ull, 0x8865899617FB1871ull},
+    {0xDDBB901B98FEEAB7ull, 0xAA7EEBFB9DF9DE8Dull}, {0x552A74227F3EA565ull, 0xD51EA6FA85785631ull},
+    {0xD53A88958F87275Full, 0x8533285C936B35DEull}, {0x8A892ABAF368F137ull, 0xA67FF273B8460356ull},
+    {0x2D2B7569B0432D85ull, 0xD01FEF10A657842Cull}, {0x9C3B29620E29FC73ull, 0x8213F56A67F6B29Bull},
+    {0x8349F3BA91B47B8Full, 0xA298F2C501F45F42ull}, {0x241C70A936219A73ull, 0xCB3F2F7642717713ull},
+    {0xED238CD383AA0110ull, 0xFE0EFB53D30DD4D7ull}, {0xF4363804324A40AAull, 0x9EC95D1463E8A506ull},
+    {0xB143C6053EDCD0D5ull, 0xC67BB4597CE2CE48ull}, {0xDD94B7868E94050Aull, 0xF81AA16FDC1B81DAull},
+    {0xCA7CF2B4191C8326ull, 0x9B10A4E5E9913128ull}, {0xFD1C2F611F63A3F0ull, 0xC1D4CE1F63F57D72ull},
+    {0xBC633B39673C8CECull, 0xF24A01A73CF2DCCFull}, {0xD5BE0503E085D813ull, 0x976E41088617CA01ull},
+    {0x4B2D8644D8A74E18ull, 0xBD49D14AA79DBC82ull}, {0xDDF8E7D60ED1219Eull, 0xEC9C459D51852BA2ull},
+    {0xCABB90E5C942B503ull, 0x93E1AB8252F33B45ull}, {0x3D6A751F3B936243ull, 0xB8DA1662E7B00A17ull},
+    {0x0CC512670A783AD4ull, 0xE7109BFBA19C0C9Dull}, {0x27FB2B80668B24C5ull, 0x906A617D450187E2ull},
+    {0xB1F9F660802DEDF6ull, 0xB484F9DC9641E9DAull}, {0x5E7873F8A0396973ull, 0xE1A63853BBD26451ull},
+    {0xDB0B487B6423E1E8ull, 0x8D07E33455637EB2ull}, {0x91CE1A9A3D2CDA62ull, 0xB049DC016ABC5E5Full},
+    {0x7641A140CC7810FBull, 0xDC5C5301C56B75F7ull}, {0xA9E904C87FCB0A9Dull, 0x89B9B3E11B6329BAull},
+    {0x546345FA9FBDCD44ull, 0xAC2820D9623BF429ull}, {0xA97C177947AD4095ull, 0xD732290FBACAF133ull},
+    {0x49ED8EABCCCC485Dull, 0x867F59A9D4BED6C0ull}, {0x5C68F256BFFF5A74ull, 0xA81F301449EE8C70ull},
+    {0x73832EEC6FFF3111ull, 0xD226FC195C6A2F8Cull}, {0xC831FD53C5FF7EABull, 0x83585D8FD9C25DB7ull},
+    {0xBA3E7CA8B77F5E55ull, 0xA42E74F3D032F525ull}, {0x28CE1BD2E55F35EBull, 0xCD3A1230C43FB26Full},
+    {0x7980D163CF5B81B3ull, 0x80444B5E7AA7CF85ull}, {0xD7E105BCC332621Full, 0xA0555E361951C366ull},
+    {0x8DD9472BF3FEFAA7ull, 0xC86AB5C39FA63440ull}, {0xB14F98F6F0FEB951ull, 0xFA856334878FC150ull},
+    {0x6ED1BF9A569F33D3ull, 0x9C935E00D4B9D8D2ull}, {0x0A862F80EC4700C8ull, 0xC3B8358109E84F07ull},
+    {0xCD27BB612758C0FAull, 0xF4A642E14C6262C8ull}, {0x8038D51CB897789Cull, 0x98E7E9CCCFBD7DBDull},
+    {0xE0470A63E6BD56C3ull, 0xBF21E44003ACDD2Cull}, {0x1858CCFCE06CAC74ull, 0xEEEA5D5004981478ull},
+    {0x0F37801E0C43EBC8ull, 0x95527A5202DF0CCBull}, {0xD30560258F54E6BAull, 0xBAA718E68396CFFDull},
+    {0x47C6B82EF32A2069ull, 0xE950DF20247C83FDull}, {0x4CDC331D57FA5441ull, 0x91D28B7416CDD27Eull},
+    {0xE0133FE4ADF8E952ull, 0xB6472E511C81471Dull}, {0x58180FDDD97723A6ull, 0xE3D8F9E563A198E5ull},
+    {0x570F09EAA7EA7648ull, 0x8E679C2F5E44FF8Full}
+};
+// --------------------------------------------------------------------------------
+
+// Powers of ten that doubles represent exactly
+static const double EXACT_POW10[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+// --------------------------------------------------------------------------------
+
+static inline bool _is_digit(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+// --------------------------------------------------------------------------------
+
+static inline double _bits_to_double(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+// --------------------------------------------------------------------------------
+
+static inline int _leading_zeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x & 0x8000000000000000ull)) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+// Parses [+-]digits into a magnitude, saturating at limit
+static parse_status _parse_magnitude(const char* str, size_t len, uint64_t limit_pos, 
+                                     uint64_t limit_neg, uint64_t* magnitude, 
+                                     bool* negative) {
+    if (len == 0) return PARSE_EMPTY;
+    const char* p = str;
+    const char* end = str + len;
+    *negative = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    if (p == end) return PARSE_INVALID;
+    uint64_t limit = *negative ? limit_neg : limit_pos;
+    uint64_t value = 0;
+    bool overflow = false;
+    // Up to 19 digits cannot wrap 64 bits, so only the total is checked
+    if ((size_t)(end - p) <= (size_t)MANTISSA_DIGITS) {
+        for (; p < end; p++) {
+            if (!_is_digit(*p)) return PARSE_INVALID;
+            value = value * 10 + (uint64_t)(*p - '0');
+        }
+        overflow = value > limit;
+    } else {
+        for (; p < end; p++) {
+            if (!_is_digit(*p)) return PARSE_INVALID;
+            uint64_t digit = (uint64_t)(*p - '0');
+            if (digit > limit || value > (limit - digit) / 10) {
+                overflow = true;
+            } else {
+                value = value * 10 + digit;
+            }
+        }
+    }
+    *magnitude = overflow ? limit : value;
+    return overflow ? PARSE_OVERFLOW : PARSE_OK;
+}
+// --------------------------------------------------------------------------------
+
+parse_status parse_int(const char* str, size_t len, long long* value) {
+    if (!str || !value) return PARSE_INVALID;
+    uint64_t magnitude = 0;
+    bool negative = false;
+    parse_status status = _parse_magnitude(str, len, (uint64_t)LLONG_MAX, 
+                                           (uint64_t)LLONG_MAX + 1, &magnitude, &negative);
+    if (status == PARSE_OK || status == PARSE_OVERFLOW) {
+        // Negating in unsigned arithmetic reaches LLONG_MIN without overflow
+        *value = negative ? (long long)(0 - magnitude) : (long long)magnitude;
+    }
+    return status;
+}
+// --------------------------------------------------------------------------------
+
+parse_status parse_uint(const char* str, size_t len, unsigned long long* value) {
+    if (!str || !value) return PARSE_INVALID;
+    uint64_t magnitude = 0;
+    bool negative = false;
+    parse_status status = _parse_magnitude(str, len, UINT64_MAX, 0, &magnitude, &negative);
+    if (status == PARSE_OK || status == PARSE_OVERFLOW) {
+        // A minus sign only admits zero
+        *value = (unsigned long long)magnitude;
+    }
+    return status;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Eisel-Lemire conversion of mantissa * 10^exp10, with mantissa non-zero and 
+ * exp10 within the table.  Returns false when the product is too close to a 
+ * halfway point to decide, or when the result is subnormal or infinite.
+ */
+static bool _eisel_lemire(uint64_t mantissa, int exp10, bool negative, double* out) {
+    const uint64_t* pow10 = POW10_128[exp10 - POW10_MIN_EXP];
+    int clz = _leading_zeros(mantissa);
+    mantissa <<= clz;
+    // 217706 / 65536 approximates log2(10)
+    uint64_t exp2 = (uint64_t)(((217706 * exp10) >> 16) + 64 + 1023) - (uint64_t)clz;
+    uint64_t lo = mantissa;
+    uint64_t hi = pow10[1];
+    _mum(&lo, &hi);
+    // The low bits may still change the result, so widen with the low word
+    if ((hi & 0x1FF) == 0x1FF && lo + mantissa < mantissa) {
+        uint64_t wide_lo = mantissa;
+        uint64_t wide_hi = pow10[0];
+        _mum(&wide_lo, &wide_hi);
+        uint64_t merged_hi = hi;
+        uint64_t merged_lo = lo + wide_hi;
+        if (merged_lo < lo) merged_hi++;
+        if ((merged_hi & 0x1FF) == 0x1FF && merged_lo + 1 == 0 && wide_lo + mantissa < mantissa) {
+            return false;
+        }
+        hi = merged_hi;
+        lo = merged_lo;
+    }
+    uint64_t msb = hi >> 63;
+    uint64_t bits = hi >> (msb + 9);
+    exp2 -= 1 ^ msb;
+    // An exact halfway product needs the remaining digits to round
+    if (lo == 0 && (hi & 0x1FF) == 0 && (bits & 3) == 1) return false;
+    bits += bits & 1;
+    bits >>= 1;
+    if (bits >> 53) {
+        bits >>= 1;
+        exp2++;
+    }
+    if (exp2 - 1 >= 0x7FF - 1) return false;
+    bits = exp2 << 52 | (bits & 0x000FFFFFFFFFFFFFull);
+    if (negative) bits |= 0x8000000000000000ull;
+    *out = _bits_to_double(bits);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+// Locale independent strtod of a validated number, used for the rare inputs 
+// Eisel-Lemire cannot decide
+static double _strtod_fallback(const char* str, size_t len) {
+    char stack[PARSE_STACK_BUFFER];
+    const char* point = localeconv()->decimal_point;
+    size_t point_len = strlen(point);
+    size_t size = len * (point_len > 0 ? point_len : 1) + 1;
+    char* copy = size <= sizeof(stack) ? stack : malloc(size);
+    if (!copy) return _bits_to_double(0x7FF8000000000000ull);
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (str[i] == '.') {
+            memcpy(copy + n, point, point_len);
+            n += point_len;
+        } else {
+            copy[n++] = str[i];
+        }
+    }
+    copy[n] = '\0';
+    int saved = errno;
+    double value = strtod(copy, NULL);
+    errno = saved;
+    if (copy != stack) free(copy);
+    return value;
+}
+// --------------------------------------------------------------------------------
+
+static bool _match_word(const char* p, const char* end, const char* word) {
+    size_t n = strlen(word);
+    if ((size_t)(end - p) != n) return false;
+    for (size_t i = 0; i < n; i++) {
+        if ((p[i] | 0x20) != word[i]) return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+parse_status parse_double(const char* str, size_t len, double* value) {
+    if (!str || !value) return PARSE_INVALID;
+    if (len == 0) return PARSE_EMPTY;
+    const char* p = str;
+    const char* end = str + len;
+    bool negative = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    uint64_t sign = negative ? 0x8000000000000000ull : 0;
+    if (p < end && !_is_digit(*p) && *p != '.') {
+        if (_match_word(p, end, "inf") || _match_word(p, end, "infinity")) {
+            *value = _bits_to_double(sign | 0x7FF0000000000000ull);
+            return PARSE_OK;
+        }
+        if (_match_word(p, end, "nan")) {
+            *value = _bits_to_double(sign | 0x7FF8000000000000ull);
+            return PARSE_OK;
+        }
+        return PARSE_INVALID;
+    }
+
+    // Keep the first 19 significant digits, the rest only shift the exponent
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int64_t exp10 = 0;
+    bool truncated = false;
+    bool any_digit = false;
+    const char* start = p;
+    while (p < end && *p == '0') p++;
+    for (; p < end && _is_digit(*p); p++) {
+        if (digits < MANTISSA_DIGITS) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            digits++;
+        } else {
+            exp10++;
+            truncated |= *p != '0';
+        }
+    }
+    any_digit = p > start;
+    if (p < end && *p == '.') {
+        p++;
+        const char* fraction = p;
+        // Zeros before the first significant digit only scale the value
+        if (digits == 0) {
+            while (p < end && *p == '0') p++;
+            exp10 -= p - fraction;
+        }
+        for (; p < end && _is_digit(*p); p++) {
+            if (digits < MANTISSA_DIGITS) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                digits++;
+                exp10--;
+            } else {
+                truncated |= *p != '0';
+            }
+        }
+        any_digit |= p > fraction;
+    }
+    if (!any_digit) return PARSE_INVALID;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_negative = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) p++;
+        if (p == end) return PARSE_INVALID;
+        int64_t exponent = 0;
+        for (; p < end && _is_digit(*p); p++) {
+            // Far beyond any finite result, stop before the sum can overflow
+            if (exponent < 100000) exponent = exponent * 10 + (*p - '0');
+        }
+        exp10 += exp_negative ? -exponent : exponent;
+    }
+    if (p != end) return PARSE_INVALID;
+
+    if (mantissa == 0) {
+        *value = _bits_to_double(sign);
+        return PARSE_OK;
+    }
+    // Clinger: both operands are exact, so one rounding gives the exact result
+    if (FLT_EVAL_METHOD == 0 && !truncated && mantissa <= CLINGER_MAX_MANTISSA && 
+        exp10 >= -22 && exp10 <= 22) {
+        double result = (double)mantissa;
+        result = exp10 < 0 ? result / EXACT_POW10[-exp10] : result * EXACT_POW10[exp10];
+        *value = negative ? -result : result;
+        return PARSE_OK;
+    }
+    if (exp10 < POW10_MIN_EXP) {
+        *value = _bits_to_double(sign);
+        return PARSE_OK;
+    }
+    if (exp10 > POW10_MAX_EXP) {
+        *value = _bits_to_double(sign | 0x7FF0000000000000ull);
+        return PARSE_OVERFLOW;
+    }
+    double result = 0.0;
+    double upper = 0.0;
+    // A truncated mantissa lies between mantissa and mantissa + 1; both ends 
+    // must round to the same double
+    if (_eisel_lemire(mantissa, (int)exp10, negative, &result) && 
+        (!truncated || (_eisel_lemire(mantissa + 1, (int)exp10, negative, &upper) && 
+                        upper == result))) {
+        *value = result;
+        return PARSE_OK;
+    }
+    result = _strtod_fallback(str, len);
+    *value = result;
+    uint64_t bits;
+    memcpy(&bits, &result, sizeof(bits));
+    return (bits & 0x7FFFFFFFFFFFFFFFull) == 0x7FF0000000000000ull ? PARSE_OVERFLOW : PARSE_OK;
+}
+// --------------------------------------------------------------------------------
+
+parse_status string_to_int(const string_t* str, long long* value) {
+    if (!str || !str->str) return PARSE_INVALID;
+    return parse_int(str->str, str->len, value);
+}
+// --------------------------------------------------------------------------------
+
+parse_status string_to_uint(const string_t* str, unsigned long long* value) {
+    if (!str || !str->str) return PARSE_INVALID;
+    return parse_uint(str->str, str->len, value);
+}
+// --------------------------------------------------------------------------------
+
+parse_status string_to_double(const string_t* str, double* value) {
+    if (!str || !str->str) return PARSE_INVALID;
+    return parse_double(str->str, str->len, value);
+}
+// ================================================================================
+// ================================================================================
+// CSV READER IMPLEMENTATION
+
+/*
+ * RFC 4180 style records: fields are separated by a delimiter, rows end in 
+ * \n or \r\n, and a field that starts with a double quote runs to the 
+ * matching quote, may hold delimiters and line breaks, and writes a quote as 
+ * "".  A quote inside an unquoted field is an ordinary character.  Blank 
+ * lines are skipped.
+ *
+ * Fields are views into the input.  Only quoted fields holding "" are 
+ * rewritten, into a per-row scratch buffer.  Unquoted fields are scanned 16 
+ * or 32 bytes at a time for the delimiter and line breaks, and quoted fields 
+ * with memchr for the closing quote.  A row that runs past the end of the 
+ * stream buffer is parsed again once more input has been read.
+ */
+static const size_t CSV_STREAM_CHUNK = 64 * 1024;  // Bytes read per refill
+static const size_t CSV_MIN_FIELDS = 16;
+// --------------------------------------------------------------------------------
+
+typedef enum { CSV_ROW, CSV_END, CSV_NEED_MORE, CSV_MALFORMED, CSV_NO_MEMORY } csvStatus;
+// --------------------------------------------------------------------------------
+
+struct csv_reader_t {
+    const char* data;          // Current window of input
+    size_t len;
+    size_t pos;                // Start of the next row in data
+    bool final;                // No input beyond data + len
+    char delim;
+    size_t rows;               // Rows returned so far
+    csv_field_t* fields;
+    size_t* scratch_at;        // Scratch offset of each unescaped field
+    size_t count;
+    size_t field_alloc;
+    char* scratch;             // Unescaped quoted fields of the current row
+    size_t scratch_len;
+    size_t scratch_alloc;
+    FILE* file;                // Streaming source, or NULL
+    bool owns_file;
+    char* buffer;              // Stream window storage
+    size_t buffer_alloc;
+    fileMap map;               // Mapped source
+    bool mapped;
+};
+// --------------------------------------------------------------------------------
+
+// Returns the first delimiter, \n or \r at or after p, or end
+static const char* _csv_scan(const char* p, const char* end, char delim) {
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
+    const __m256i d32 = _mm256_set1_epi8(delim);
+    const __m256i n32 = _mm256_set1_epi8('\n');
+    const __m256i r32 = _mm256_set1_epi8('\r');
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, d32), 
+                      _mm256_or_si256(_mm256_cmpeq_epi8(v, n32), _mm256_cmpeq_epi8(v, r32)));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(hit);
+        if (mask) return p + __builtin_ctz(mask);
+    }
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+    const __m128i d16 = _mm_set1_epi8(delim);
+    const __m128i n16 = _mm_set1_epi8('\n');
+    const __m128i r16 = _mm_set1_epi8('\r');
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, d16), 
+                      _mm_or_si128(_mm_cmpeq_epi8(v, n16), _mm_cmpeq_epi8(v, r16)));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(hit);
+        if (mask) return p + __builtin_ctz(mask);
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == delim || *p == '\n' || *p == '\r') return p;
+    }
+    return end;
+}
+// --------------------------------------------------------------------------------
+
+static bool _csv_add_field(csv_reader_t* reader, const char* str, size_t len, 
+                           size_t scratch_at) {
+    if (reader->count == reader->field_alloc) {
+        size_t new_alloc = reader->field_alloc * 2;
+        csv_field_t* fields = realloc(reader->fields, new_alloc * sizeof(csv_field_t));
+        if (!fields) return false;
+        reader->fields = fields;
+        size_t* offsets = realloc(reader->scratch_at, new_alloc * sizeof(size_t));
+        if (!offsets) return false;
+        reader->scratch_at = offsets;
+        reader->field_alloc = new_alloc;
+    }
+    reader->fields[reader->count].str = str;
+    reader->fields[reader->count].len = len;
+    reader->scratch_at[reader->count] = scratch_at;
+    reader->count++;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static bool _csv_scratch(csv_reader_t* reader, const char* str, size_t len) {
+    if (reader->scratch_len + len > reader->scratch_alloc) {
+        size_t new_alloc = reader->scratch_alloc * 2;
+        if (new_alloc < reader->scratch_len + len) new_alloc = reader->scratch_len + len;
+        char* scratch = realloc(reader->scratch, new_alloc);
+        if (!scratch) return false;
+        reader->scratch = scratch;
+        reader->scratch_alloc = new_alloc;
+    }
+    memcpy(reader->scratch + reader->scratch_len, str, len);
+    reader->scratch_len += len;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Reads the quoted field whose opening quote is at p.  On success *next is 
+ * the byte after the closing quote.
+ */
+static csvStatus _csv_quoted(csv_reader_t* reader, const char* p, const char* end, 
+                             const char** next) {
+    const char* start = p + 1;
+    const char* run = start;
+    bool escaped = false;
+    size_t scratch_start = reader->scratch_len;
+    for (;;) {
+        const char* quote = memchr(run, '"', (size_t)(end - run));
+        if (!quote) return reader->final ? CSV_MALFORMED : CSV_NEED_MORE;
+        if (quote + 1 == end && !reader->final) return CSV_NEED_MORE;
+        if (quote + 1 < end && quote[1] == '"') {
+            // Keep one quote of the pair
+            if (!_csv_scratch(reader, run, (size_t)(quote + 1 - run))) return CSV_NO_MEMORY;
+            escaped = true;
+            run = quote + 2;
+            continue;
+        }
+        bool added;
+        if (escaped) {
+            added = _csv_scratch(reader, run, (size_t)(quote - run)) && 
+                    _csv_add_field(reader, NULL, reader->scratch_len - scratch_start, 
+                                   scratch_start);
+        } else {
+            added = _csv_add_field(reader, start, (size_t)(quote - start), 0);
+        }
+        if (!added) return CSV_NO_MEMORY;
+        *next = quote + 1;
+        return CSV_ROW;
+    }
+}
+// --------------------------------------------------------------------------------
+
+// Parses the row at reader->pos into reader->fields
+static csvStatus _csv_parse_row(csv_reader_t* reader) {
+    const char* p = reader->data + reader->pos;
+    const char* end = reader->data + reader->len;
+    const char delim = reader->delim;
+    while (p < end && (*p == '\n' || *p == '\r')) {
+        if (*p == '\r' && p + 1 < end && p[1] != '\n') break;  // A lone \r starts a field
+        if (*p == '\r' && p + 1 == end && !reader->final) return CSV_NEED_MORE;
+        p++;
+    }
+    if (p == end) {
+        if (!reader->final) return CSV_NEED_MORE;
+        reader->pos = reader->len;
+        return CSV_END;
+    }
+    reader->count = 0;
+    reader->scratch_len = 0;
+    for (;;) {
+        if (p == end) {
+            // The row ended with a delimiter
+            if (!reader->final) return CSV_NEED_MORE;
+            if (!_csv_add_field(reader, p, 0, 0)) return CSV_NO_MEMORY;
+            break;
+        }
+        if (*p == '"') {
+            csvStatus status = _csv_quoted(reader, p, end, &p);
+            if (status != CSV_ROW) return status;
+            if (p == end) {
+                if (!reader->final) return CSV_NEED_MORE;
+                break;
+            }
+            if (*p == delim) {
+                p++;
+                continue;
+            }
+            if (*p == '\n') {
+                p++;
+                break;
+            }
+            if (*p == '\r' && p + 1 < end && p[1] == '\n') {
+                p += 2;
+                break;
+            }
+            if (*p == '\r' && p + 1 == end) {
+                // At the end of the input a final \r still ends the row
+                if (!reader->final) return CSV_NEED_MORE;
+                p = end;
+                break;
+            }
+            return CSV_MALFORMED;  // Text after a closing quote
+        }
+        const char* start = p;
+        const char* stop = _csv_scan(p, end, delim);
+        // A \r that does not end the line belongs to the field
+        while (stop < end && *stop == '\r' && stop + 1 < end && stop[1] != '\n') {
+            stop = _csv_scan(stop + 1, end, delim);
+        }
+        if (stop == end || (*stop == '\r' && stop + 1 == end)) {
+            // At the end of the input a final \r still ends the row
+            if (!reader->final) return CSV_NEED_MORE;
+            if (!_csv_add_field(reader, start, (size_t)(stop - start), 0)) return CSV_NO_MEMORY;
+            p = end;
+            break;
+        }
+        if (!_csv_add_field(reader, start, (size_t)(stop - start), 0)) return CSV_NO_MEMORY;
+        if (*stop == delim) {
+            p = stop + 1;
+            continue;
+        }
+        p = stop + (*stop == '\r' ? 2 : 1);
+        break;
+    }
+    // Scratch may have moved while the row was parsed, so point fields at it last
+    for (size_t i = 0; i < reader->count; i++) {
+        if (!reader->fields[i].str) reader->fields[i].str = reader->scratch + reader->scratch_at[i];
+    }
+    reader->pos = (size_t)(p - reader->data);
+    return CSV_ROW;
+}
+// --------------------------------------------------------------------------------
+
+// Moves the unparsed tail to the front of the stream buffer and reads more
+static bool _csv_refill(csv_reader_t* reader) {
+    size_t tail = reader->len - reader->pos;
+    memmove(reader->buffer, reader->buffer + reader->pos, tail);
+    reader->pos = 0;
+    reader->len = tail;
+    // A row longer than the buffer doubles it
+    if (reader->buffer_alloc - tail < CSV_STREAM_CHUNK / 2) {
+        char* buffer = realloc(reader->buffer, reader->buffer_alloc * 2);
+        if (!buffer) {
+            errno = ENOMEM;
+            return false;
+        }
+        reader->buffer = buffer;
+        reader->buffer_alloc *= 2;
+    }
+    size_t got = fread(reader->buffer + tail, 1, reader->buffer_alloc - tail, reader->file);
+    reader->len += got;
+    reader->data = reader->buffer;
+    if (got < reader->buffer_alloc - tail) {
+        if (ferror(reader->file)) {
+            errno = EIO;
+            return false;
+        }
+        reader->final = true;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static csv_reader_t* _csv_alloc(char delim) {
+    if (delim == '"' || delim == '\n' || delim == '\r') {
+        errno = EINVAL;
+        return NULL;
+    }
+    csv_reader_t* reader = calloc(1, sizeof(csv_reader_t));
+    if (!reader) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    reader->delim = delim;
+    reader->field_alloc = CSV_MIN_FIELDS;
+    reader->fields = malloc(CSV_MIN_FIELDS * sizeof(csv_field_t));
+    reader->scratch_at = malloc(CSV_MIN_FIELDS * sizeof(size_t));
+    if (!reader->fields || !reader->scratch_at) {
+        free(reader->fields);
+        free(reader->scratch_at);
+        free(reader);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return reader;
+}
+// --------------------------------------------------------------------------------
+
+csv_reader_t* init_csv_reader(const char* data, size_t len, char delim) {
+    if (!data) {
+        errno = EINVAL;
+        return NULL;
+    }
+    csv_reader_t* reader = _csv_alloc(delim);
+    if (!reader) return NULL;
+    reader->data = data;
+    reader->len = len;
+    reader->final = true;
+    return reader;
+}
+// --------------------------------------------------------------------------------
+
+csv_reader_t* init_csv_stream(FILE* file, char delim) {
+    if (!file) {
+        errno = EINVAL;
+        return NULL;
+    }
+    csv_reader_t* reader = _csv_alloc(delim);
+    if (!reader) return NULL;
+    reader->buffer = malloc(CSV_STREAM_CHUNK);
+    if (!reader->buffer) {
+        free_csv_reader(reader);
+        errno = ENOMEM;
+        return NULL;
+    }
+    reader->buffer_alloc = CSV_STREAM_CHUNK;
+    reader->data = reader->buffer;
+    reader->file = file;
+    return reader;
+}
+// --------------------------------------------------------------------------------
+
+csv_reader_t* open_csv_reader(const char* path, char delim) {
+    if (!path) {
+        errno = EINVAL;
+        return NULL;
+    }
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+    csv_reader_t* reader = _csv_alloc(delim);
+    if (!reader) return NULL;
+    if (!_map_file(path, 0, &reader->map)) {
+        free_csv_reader(reader);
+        return NULL;
+    }
+    reader->mapped = true;
+    // An empty file maps to NULL, which still makes a valid empty window
+    reader->data = reader->map.base ? (const char*)reader->map.base : "";
+    reader->len = reader->map.size;
+    reader->final = true;
+#if defined(POSIX_MADV_SEQUENTIAL)
+    if (reader->map.base) {
+        posix_madvise((void*)reader->map.base, reader->map.size, POSIX_MADV_SEQUENTIAL);
+    }
+#endif
+    return reader;
+#else
+    // Without memory mapping stream the file so it need not fit in memory
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    csv_reader_t* reader = init_csv_stream(file, delim);
+    if (!reader) {
+        fclose(file);
+        return NULL;
+    }
+    reader->owns_file = true;
+    return reader;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+bool csv_next_row(csv_reader_t* reader, const csv_field_t** fields, size_t* count) {
+    if (!reader || !fields || !count) {
+        errno = EINVAL;
+        return false;
+    }
+    for (;;) {
+        switch (_csv_parse_row(reader)) {
+            case CSV_ROW:
+                reader->rows++;
+                *fields = reader->fields;
+                *count = reader->count;
+                return true;
+            case CSV_END:
+                return false;
+            case CSV_MALFORMED:
+                errno = EILSEQ;
+                return false;
+            case CSV_NO_MEMORY:
+                errno = ENOMEM;
+                return false;
+            case CSV_NEED_MORE:
+                // Only a stream that has not reached its end asks for more
+                if (!_csv_refill(reader)) return false;
+                break;
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+const size_t csv_reader_rows(const csv_reader_t* reader) {
+    if (!reader) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return reader->rows;
+}
+// --------------------------------------------------------------------------------
+
+void free_csv_reader(csv_reader_t* reader) {
+    if (!reader) {
+        errno = EINVAL;
+        return;
+    }
+    if (reader->mapped) _unmap_file(&reader->map);
+    if (reader->owns_file) fclose(reader->file);
+    free(reader->buffer);
+    free(reader->fields);
+    free(reader->scratch_at);
+    free(reader->scratch);
+    free(reader);
+}
+// --------------------------------------------------------------------------------
+
+void _free_csv_reader(csv_reader_t** reader) {
+    if (reader && *reader) {
+        free_csv_reader(*reader);
+        *reader = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// LINE ITERATOR IMPLEMENTATION
+
+static const size_t LINE_READ_MIN = 128;  // Spare bytes offered to each fgets call
+// --------------------------------------------------------------------------------
+
+line_iter_t init_line_iter_lit(const char* data, size_t len) {
+    line_iter_t iter = {data, data ? data + len : NULL};
+    if (!data) {
+        errno = EINVAL;
+    }
+    return iter;
+}
+// --------------------------------------------------------------------------------
+
+line_iter_t init_line_iter(const string_t* str) {
+    if (!str || !str->str) {
+        errno = EINVAL;
+        return init_line_iter_lit(NULL, 0);
+    }
+    return init_line_iter_lit(str->str, str->len);
+}
+// --------------------------------------------------------------------------------
+
+bool line_iter_next(line_iter_t* iter, const char** line, size_t* len) {
+    if (!iter || !line || !len) {
+        errno = EINVAL;
+        return false;
+    }
+    // Text after the last line break is a line only if it is not empty
+    if (!iter->next || iter->next == iter->end) {
+        return false;
+    }
+    const char* start = iter->next;
+    const char* newline = memchr(start, '\n', (size_t)(iter->end - start));
+    const char* stop = newline ? newline : iter->end;
+    iter->next = newline ? newline + 1 : iter->end;
+    if (newline && stop > start && stop[-1] == '\r') stop--;
+    *line = start;
+    *len = (size_t)(stop - start);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool read_line_string(string_t* line, FILE* file) {
+    if (!line || !line->str || !file) {
+        errno = EINVAL;
+        return false;
+    }
+    line->len = 0;
+    line->str[0] = '\0';
+    line->hash = 0;
+    bool complete = false;
+    while (!complete) {
+        if (!_grow_string(line, LINE_READ_MIN)) return false;
+        size_t room = line->alloc - line->len;
+        int chunk = room > (size_t)INT_MAX ? INT_MAX : (int)room;
+        if (!fgets(line->str + line->len, chunk, file)) {
+            line->str[line->len] = '\0';
+            if (ferror(file)) {
+                errno = EIO;
+                return false;
+            }
+            break;  // End of file
+        }
+        size_t got = strlen(line->str + line->len);
+        line->len += got;
+        complete = got > 0 && line->str[line->len - 1] == '\n';
+    }
+    if (!complete) {
+        return line->len > 0;  // A last line without a line break
+    }
+    line->len--;
+    if (line->len > 0 && line->str[line->len - 1] == '\r') line->len--;
+    line->str[line->len] = '\0';
+    return true;
+}
 // ================================================================================
 // ================================================================================
 // eof
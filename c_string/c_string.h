@@ -32,6 +32,7 @@ extern "C" {
  *  - chart* str: Pointer to a string literal
  *  - size_t len: The current number of elements in the arrays.
  *  - size_t alloc: The total allocated capacity of the arrays.
+ *  - size_t hash: Lazily computed hash of str, reset by every mutating function.
  */
 typedef struct string_t string_t;
 // --------------------------------------------------------------------------------
@@ -199,6 +200,72 @@ int compare_strings_string(const string_t* str_struct_one, string_t* str_struct_
     default: compare_strings_string) (str_one, str_two)
 // --------------------------------------------------------------------------------
 
+/**
+ * @function equal_strings_lit
+ * @brief Tests a string_t object and a string literal for equality.
+ *
+ * Faster than compare_strings_lit when only equality matters, since strings
+ * of different length are rejected before any characters are read.
+ *
+ * @param str_struct A pointer to the string_t object.
+ * @param string A null-terminated C string to compare with.
+ * @return true if both strings hold the same characters, false otherwise.
+ *         Returns false and sets errno to EINVAL on NULL input.
+ */
+bool equal_strings_lit(const string_t* str_struct, const char* string);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function equal_strings_string
+ * @brief Tests two string_t objects for equality.
+ *
+ * Lengths are compared first, so unequal strings of different length are
+ * rejected in constant time.
+ *
+ * @param str_struct_one A pointer to the first string_t object.
+ * @param str_struct_two A pointer to the second string_t object.
+ * @return true if both strings hold the same characters, false otherwise.
+ *         Returns false and sets errno to EINVAL on NULL input.
+ */
+bool equal_strings_string(const string_t* str_struct_one, const string_t* str_struct_two);
+// --------------------------------------------------------------------------------
+
+/**
+ * @macro equal_strings
+ * @brief A generic macro that selects the appropriate equality function
+ *        based on the type of the second argument.
+ *
+ * If the second argument is a `char*`, it calls `equal_strings_lit`.
+ * Otherwise, it calls `equal_strings_string`.
+ */
+#define equal_strings(str_one, str_two) _Generic((str_two), \
+    char*: equal_strings_lit, \
+    default: equal_strings_string) (str_one, str_two)
+// --------------------------------------------------------------------------------
+
+/**
+ * @function string_hash
+ * @brief Returns the hash of a string_t object, computing it only once.
+ *
+ * The hash is cached inside the string_t and reset by every library function 
+ * that modifies the string, so repeated dictionary lookups with the same key 
+ * do not rehash it.  Writing through a pointer obtained from first_char() or
+ * the string iterator bypasses the invalidation and must be avoided on 
+ * strings whose hash has been taken.
+ *
+ * The first call after a modification stores the hash into str, so str is not 
+ * const and concurrent calls on a shared string must be serialized.  Library 
+ * functions that receive a const string_t, such as the dict functions taking 
+ * string_t keys and add_hll_vector(), reuse a hash already cached here but 
+ * never store one, so calling this once before sharing a key lets them skip 
+ * the rehash while staying safe to call from several threads.
+ *
+ * @param str A pointer to the string_t object.
+ * @return The hash value, or 0 on error (sets errno to EINVAL).
+ */
+size_t string_hash(string_t* str);
+// --------------------------------------------------------------------------------
+
 /**
  * @function copy_string
  * @brief Creates a deep copy of a string data type
@@ -901,6 +968,71 @@ void swap_string(string_t* a, string_t* b);
 *         not populated
 */
 size_t binary_search_str_vector(string_v* vec, char* value, bool sort_first);
+// --------------------------------------------------------------------------------
+
+/**
+* @function lower_bound_str_vector
+* @brief Returns the index of the first string not less than value.
+*
+* The vector remembers whether it is in ascending order, so passing 
+* sort_first only costs a sort when the vector has changed out of order.
+*
+* @param vec string vector object, sorted in ascending order
+* @param value The value to search for
+* @param sort_first true to sort the vector first if it is not already sorted
+* @return An index in [0, size], equal to size when every string is less than 
+*         value.  Returns LONG_MAX and sets errno to EINVAL if vec or value is 
+*         NULL or invalid
+*/
+size_t lower_bound_str_vector(string_v* vec, const char* value, bool sort_first);
+// --------------------------------------------------------------------------------
+
+/**
+* @function upper_bound_str_vector
+* @brief Returns the index of the first string greater than value.
+*
+* @param vec string vector object, sorted in ascending order
+* @param value The value to search for
+* @param sort_first true to sort the vector first if it is not already sorted
+* @return An index in [0, size].  Returns LONG_MAX and sets errno to EINVAL if 
+*         vec or value is NULL or invalid
+*/
+size_t upper_bound_str_vector(string_v* vec, const char* value, bool sort_first);
+// --------------------------------------------------------------------------------
+
+/**
+* @function prefix_range_str_vector
+* @brief Finds the half-open range [first, last) of strings starting with prefix.
+*
+* Two binary searches bracket the matches, so autocomplete lookups cost 
+* O(log n) regardless of how many strings share the prefix.  An empty range 
+* is reported as first == last.
+*
+* @param vec string vector object, sorted in ascending order
+* @param prefix The prefix to match, an empty prefix matches every string
+* @param sort_first true to sort the vector first if it is not already sorted
+* @param first Receives the index of the first match
+* @param last Receives the index one past the last match
+* @return true on success, false with errno set to EINVAL if any pointer is 
+*         NULL or vec is invalid
+*/
+bool prefix_range_str_vector(string_v* vec, const char* prefix, bool sort_first, 
+                             size_t* first, size_t* last);
+// --------------------------------------------------------------------------------
+
+/**
+* @function is_str_vector_sorted
+* @brief Reports whether a string vector is known to be in ascending order.
+*
+* The flag is set by sort_str_vector in FORWARD order and kept up to date by 
+* every insertion, which checks the new string against its neighbours.  
+* Removals never clear it.
+*
+* @param vec string vector object
+* @return true if the vector is in ascending order, false otherwise or with 
+*         errno set to EINVAL if vec is NULL or invalid
+*/
+bool is_str_vector_sorted(const string_v* vec);
 // ================================================================================
 // ================================================================================ 
 // DICTIONARY PROTOTYPES
@@ -918,13 +1050,45 @@ typedef struct dict_t dict_t;
 /**
  * @brief Initializes a new dictionary.
  *
- * Allocates and initializes a dictionary object with a default size for the hash table.
+ * Allocates and initializes a dictionary object with a default size for the hash table,
+ * hashed with FAST_HASH.
  *
  * @return A pointer to the newly created dictionary, or NULL if allocation fails.
  */
 dict_t* init_dict();
 // -------------------------------------------------------------------------------- 
 
+/**
+ * @brief An enum selecting the hash function used by a dictionary
+ *
+ * @attribute FAST_HASH A word-at-a-time wyhash style hash, the default.  Its
+ *            values match string_hash(), so cached string_t hashes are reused.
+ * @attribute SECURE_HASH SipHash-1-3 keyed with a 16 byte secret.  Use for 
+ *            tables fed by untrusted input, where an attacker could otherwise
+ *            choose keys that collide.
+ */
+typedef enum {
+    FAST_HASH,
+    SECURE_HASH
+} hash_type;
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes a new dictionary with a chosen hash function.
+ *
+ * The bucket count is kept at a power of two so a bucket is selected with a 
+ * mask instead of a division.
+ *
+ * @param type FAST_HASH or SECURE_HASH.
+ * @param key A 16 byte secret for SECURE_HASH, ignored (may be NULL) for FAST_HASH.
+ *            It should come from a random source, e.g. /dev/urandom.
+ * @return A pointer to the newly created dictionary, or NULL on failure.
+ *         Sets errno to EINVAL for an unknown type or a missing SECURE_HASH key,
+ *         ENOMEM if allocation fails.
+ */
+dict_t* init_dict_hash(hash_type type, const unsigned char* key);
+// -------------------------------------------------------------------------------- 
+
 /**
  * @brief Inserts a key-value pair into the dictionary.
  *
@@ -940,6 +1104,20 @@ dict_t* init_dict();
 bool insert_dict(dict_t* dict, const char* key, size_t value);
 // --------------------------------------------------------------------------------
 
+/**
+ * @brief Inserts a key-value pair using a string_t key.
+ *
+ * Uses the key's stored length and any hash cached by string_hash(), 
+ * avoiding strlen and, for a hashed key, rehashing.  The key is not modified.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param key The key to insert.
+ * @param value The value associated with the key.
+ * @return true if the key-value pair was inserted successfully, false otherwise.
+ */
+bool insert_dict_string(dict_t* dict, const string_t* key, size_t value);
+// --------------------------------------------------------------------------------
+
 /**
  * @brief Removes a key-value pair from the dictionary.
  *
@@ -953,6 +1131,16 @@ bool insert_dict(dict_t* dict, const char* key, size_t value);
 size_t pop_dict(dict_t* dict,  char* key);
 // --------------------------------------------------------------------------------
 
+/**
+ * @brief Removes a key-value pair using a string_t key.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param key The key to remove.
+ * @return The value associated with the key if it was found and removed; LONG_MAX otherwise.
+ */
+size_t pop_dict_string(dict_t* dict, const string_t* key);
+// --------------------------------------------------------------------------------
+
 /**
  * @brief Retrieves the value associated with a key.
  *
@@ -965,6 +1153,16 @@ size_t pop_dict(dict_t* dict,  char* key);
 const size_t get_dict_value(const dict_t* dict, char* key);
 // --------------------------------------------------------------------------------
 
+/**
+ * @brief Retrieves the value associated with a string_t key.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param key The key to search for.
+ * @return The value associated with the key, or LONG_MAX if the key is not found.
+ */
+const size_t get_dict_value_string(const dict_t* dict, const string_t* key);
+// --------------------------------------------------------------------------------
+
 /**
  * @brief Frees the memory associated with the dictionary.
  *
@@ -1011,6 +1209,17 @@ void _free_dict(dict_t** dict);
 bool update_dict(dict_t* dict, char* key, size_t value);
 // --------------------------------------------------------------------------------
 
+/**
+ * @brief Updates the value associated with a string_t key.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param key The key to update.
+ * @param value The new value to associate with the key.
+ * @return true if the key was found and updated, false otherwise.
+ */
+bool update_dict_string(dict_t* dict, const string_t* key, size_t value);
+// --------------------------------------------------------------------------------
+
 /**
  * @brief Gets the number of non-empty buckets in the dictionary.
  *
@@ -1055,65 +1264,1946 @@ const size_t dict_hash_size(const dict_t* dict);
 *         to ENOMEM and return false
 */
 bool is_key_value(const dict_t* dict, const char* key);
-// ================================================================================ 
-// ================================================================================ 
-// GENERIC MACROS 
+// --------------------------------------------------------------------------------
 
 /**
-* @macro s_size
-* @brief Generic macro to return the populated length of a string data type such as
-*        string_t and string_v
+* @function is_key_value_string
+* @brief returns true if a string_t key exists in dictionary
 *
-* @param dat A pointer to a string_t or strinv_v data type
-* @return The populated length of a string data type
+* @param dict dict_t object to search
+* @param key A string_t key, its cached hash is reused
+* @return returns true of key value pair exists, false otherwise.  Sets errno 
+*         to EINVAL and returns false on NULL input
 */
-#define s_size(dat) _Generic((dat), \
-    string_t*: string_size, \
-    string_v*: str_vector_size, \
-    dict_t*: dict_size) (dat)
+bool is_key_value_string(const dict_t* dict, const string_t* key);
 // --------------------------------------------------------------------------------
 
 /**
-* @macro s_alloc
-* @brief Generic macro to return the allocated size of a string data type such as
-*        string_t and string_v
-*
-* @param dat A pointer to a string_t or strinv_v data type
-* @return The allocated length of a string data type
-*/
-#define s_alloc(dat) _Generic((dat), \
-    string_t*: string_alloc, \
-    string_v*: str_vector_alloc, \
-    dict_t*: dict_alloc) (dat)
-// ================================================================================
-// ================================================================================
+ * @typedef dict_iter_t
+ * @brief Cursor over the entries of a dictionary.
+ *
+ * Lives on the caller's stack, so walking a dictionary allocates nothing.  The 
+ * fields are private to the library.  Inserting into or popping from the 
+ * dictionary invalidates the cursor; updating values does not.
+ */
+typedef struct {
+    const dict_t* dict;
+    size_t index;
+    const void* node;
+} dict_iter_t;
+// --------------------------------------------------------------------------------
 
-#ifndef ITER_DIR_H
-#define ITER_DIR_H
+/**
+ * @function init_dict_iter
+ * @brief Returns a cursor positioned before the first entry of a dictionary.
+ *
+ * @param dict Pointer to the dictionary.
+ * @return A cursor.  If dict is NULL errno is set to EINVAL and the cursor 
+ *         yields no entries.
+ */
+dict_iter_t init_dict_iter(const dict_t* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function dict_iter_next
+ * @brief Advances a cursor and returns the next entry.
+ *
+ * Entries come in insertion order if set_dict_ordered was enabled, and in 
+ * bucket order otherwise.  The key pointer stays valid until that key is popped 
+ * or the dictionary is freed.  Any output pointer may be NULL.
+ *
+ * @param iter Cursor from init_dict_iter.
+ * @param key Receives the null-terminated key.
+ * @param key_len Receives the key length.
+ * @param value Receives the value.
+ * @return true if an entry was produced, false once the dictionary is exhausted.
+ *         Sets errno to EINVAL if iter is NULL.
+ */
+bool dict_iter_next(dict_iter_t* iter, const char** key, size_t* key_len, size_t* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function set_dict_ordered
+ * @brief Makes a dictionary remember and iterate in insertion order.
+ *
+ * The order is kept in a compact array of entries, which costs one pointer per 
+ * key.  Keys already in the dictionary when this is enabled are ordered as 
+ * they sit in the table.  Disabling frees the array.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param enable true to keep insertion order, false to stop.
+ * @return true on success, false with errno set to EINVAL for a NULL dict or 
+ *         ENOMEM on allocation failure.
+ */
+bool set_dict_ordered(dict_t* dict, bool enable);
+// --------------------------------------------------------------------------------
+
+/**
+ * @typedef dict_entry_t
+ * @brief A key and its value, borrowed from a dictionary.
+ *
+ * key points into the dictionary and stays valid until that key is popped or 
+ * the dictionary is freed.
+ */
+typedef struct {
+    const char* key;
+    size_t key_len;
+    size_t value;
+} dict_entry_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function dict_top_k
+ * @brief Finds the k entries with the largest values, e.g. the most frequent 
+ *        words in a count_words result.
+ *
+ * Keeps a bounded min-heap in the caller's array, so the cost is O(n log k) 
+ * and the full dictionary is never sorted or copied.  Entries with equal 
+ * values are ordered by key.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param k The number of entries wanted.
+ * @param out Array of at least k entries, filled from the largest value down.
+ * @return The number of entries written, min(k, dict_size(dict)), or LONG_MAX 
+ *         with errno set to EINVAL if dict is NULL or out is NULL with k > 0.
+ */
+size_t dict_top_k(const dict_t* dict, size_t k, dict_entry_t* out);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function set_dict_incremental
+ * @brief Selects between stop-the-world and incremental resizing.
+ *
+ * In incremental mode a resize allocates the larger table but leaves the 
+ * entries where they are.  Each later insert or pop migrates a few buckets 
+ * from the old table, so no single operation pays for rehashing the whole 
+ * dictionary.  Turning the mode off finishes any migration in progress.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param enable true for incremental resizing, false for a single full pass.
+ * @return true on success, false with errno set to EINVAL if dict is NULL.
+ */
+bool set_dict_incremental(dict_t* dict, bool enable);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function shrink_dict
+ * @brief Shrinks the bucket array to the smallest size that fits the current keys.
+ *
+ * Pops already shrink a dictionary once its load factor falls below 0.1; this 
+ * compacts it immediately, for example after a bulk delete.
+ *
+ * @param dict Pointer to the dictionary.
+ * @return true on success, false on failure with errno set to EINVAL for a NULL 
+ *         dict or ENOMEM if the smaller table could not be allocated.
+ */
+bool shrink_dict(dict_t* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function reserve_dict
+ * @brief Grows the bucket array so that entries keys fit without a resize.
+ *
+ * Use this to size a dictionary up front for a known cardinality.  The table is 
+ * never shrunk by this call.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param entries The number of keys the dictionary should hold.
+ * @return true on success, false on failure with errno set to EINVAL for a NULL 
+ *         dict or ENOMEM if the table could not be allocated.
+ */
+bool reserve_dict(dict_t* dict, size_t entries);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function dict_load_factor
+ * @brief Returns the number of keys per bucket.
+ *
+ * The dictionary grows when this reaches 0.7 and shrinks when it drops below 0.1.
+ *
+ * @param dict Pointer to the dictionary.
+ * @return The load factor, or -1.0 with errno set to EINVAL if dict is NULL.
+ */
+double dict_load_factor(const dict_t* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function dict_is_rehashing
+ * @brief Reports whether an incremental resize is still migrating entries.
+ *
+ * @param dict Pointer to the dictionary.
+ * @return true while entries remain in the old table, false otherwise.  Sets 
+ *         errno to EINVAL and returns false if dict is NULL.
+ */
+bool dict_is_rehashing(const dict_t* dict);
+// ================================================================================ 
+// ================================================================================ 
+// INTERN POOL PROTOTYPES
+
+/**
+ * @typedef intern_pool_t
+ * @brief Opaque struct representing a string intern pool.
+ *
+ * The pool maps string contents to a single immutable string_t handle, so two
+ * handles obtained for the same contents are the same pointer and equality
+ * reduces to a pointer compare.  Each handle carries a precomputed hash.
+ * Lookups and insertions may be issued from several threads at once.
+ */
+typedef struct intern_pool_t intern_pool_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_intern_pool
+ * @brief Initializes a new, empty intern pool.
+ *
+ * @return A pointer to the new pool, or NULL on failure.
+ *         Sets errno to ENOMEM if memory allocation fails.
+ */
+intern_pool_t* init_intern_pool();
+// --------------------------------------------------------------------------------
+
+/**
+ * @function intern_string
+ * @brief Returns the unique handle for a string, adding it to the pool if needed.
+ *
+ * The handle stays valid until the pool is freed and must not be modified.
+ * Equal strings always return the same handle.
+ *
+ * @param pool Pointer to the intern pool.
+ * @param str A null-terminated C string.
+ * @return The interned handle, or NULL on error.
+ *         Sets errno to EINVAL for NULL inputs or ENOMEM on allocation failure.
+ */
+const string_t* intern_string(intern_pool_t* pool, const char* str);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function intern_lookup
+ * @brief Returns the handle for a string only if it is already interned.
+ *
+ * Takes only a shared lock, so concurrent lookups never block each other.
+ *
+ * @param pool Pointer to the intern pool.
+ * @param str A null-terminated C string.
+ * @return The interned handle, or NULL if the string is not in the pool.
+ *         Sets errno to EINVAL for NULL inputs.
+ */
+const string_t* intern_lookup(intern_pool_t* pool, const char* str);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function intern_pool_size
+ * @brief Returns the number of unique strings held in the pool.
+ *
+ * @param pool Pointer to the intern pool.
+ * @return The number of interned strings, or LONG_MAX on error.
+ *         Sets errno to EINVAL for NULL input.
+ */
+const size_t intern_pool_size(intern_pool_t* pool);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_intern_pool
+ * @brief Frees the pool and every interned string.
+ *
+ * All handles, and any dict or vector entries borrowing them, become invalid.
+ *
+ * @param pool Pointer to the intern pool.
+ */
+void free_intern_pool(intern_pool_t* pool);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_intern_pool
+ * @brief Helper function for garbage collection of intern pools.
+ *
+ * Used with the INTERN_GBC macro for automatic cleanup.
+ *
+ * @param pool Double pointer to the intern pool to free.
+ */
+void _free_intern_pool(intern_pool_t** pool);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
     /**
-     * @brief An enum containing keywords for an iterator 
-     *
-     * This enum contains keywords that are used to describe the order of iteration
-     * within an iterator 
-     *
-     * @attribute FORWARD Keyword to command a forward iteration 
-     * @attribute REVERSE Keyword to command a reverese iteration
+     * @macro INTERN_GBC
+     * @brief A macro for enabling automatic cleanup of intern_pool_t objects.
      */
-    typedef enum {
-        FORWARD,
-        REVERSE
-    }iter_dir;
-#endif /* ITER_DIR_H*/
+    #define INTERN_GBC __attribute__((cleanup(_free_intern_pool)))
+#endif
 // --------------------------------------------------------------------------------
 
 /**
-* @function sort_str_vector
-* @brief Sorts a string vector in ascending or descending order.
-*
-* Uses an optimized QuickSort algorithm with median-of-three pivot selection
-* and insertion sort for small subarrays. Sort direction is determined by
-* the iter_dir parameter.
-*
+ * @function insert_dict_interned
+ * @brief Inserts an interned key into a dictionary without copying it.
+ *
+ * The dictionary borrows the pool's buffer and reuses its precomputed hash.
+ * The pool must outlive the dictionary.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param handle A handle returned by intern_string.
+ * @param value The value associated with the key.
+ * @return true if the key-value pair was inserted, false otherwise.
+ *         Sets errno to EINVAL for NULL inputs or duplicate keys, ENOMEM on 
+ *         allocation failure.
+ */
+bool insert_dict_interned(dict_t* dict, const string_t* handle, size_t value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function push_back_interned_str_vector
+ * @brief Adds an interned string to the end of a vector without copying it.
+ *
+ * The vector element borrows the pool's buffer, so two elements holding the 
+ * same interned string share one get_string() pointer.  The pool must outlive
+ * the vector.
+ *
+ * @param vec Target string vector.
+ * @param handle A handle returned by intern_string.
+ * @return true if successful, false on error.
+ *         Sets errno to EINVAL for NULL inputs or ENOMEM on allocation failure.
+ */
+bool push_back_interned_str_vector(string_v* vec, const string_t* handle);
+// ================================================================================ 
+// ================================================================================ 
+// CONCURRENT DICTIONARY PROTOTYPES
+
+/**
+ * @typedef concurrent_dict_t
+ * @brief Opaque struct representing a dictionary shared between threads.
+ *
+ * Keys are spread over independently locked shards, so threads touching 
+ * different shards never contend.  Lookups take a shared lock on one shard and 
+ * updates an exclusive one.
+ */
+typedef struct concurrent_dict_t concurrent_dict_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_concurrent_dict
+ * @brief Initializes a sharded dictionary that may be used from many threads.
+ *
+ * @param shards The number of shards, rounded up to a power of two.  Pass 0 for 
+ *               the default of 64.  A few shards per thread keeps contention low.
+ * @return A pointer to the new dictionary, or NULL on failure.
+ *         Sets errno to ENOMEM on allocation failure.
+ */
+concurrent_dict_t* init_concurrent_dict(size_t shards);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function insert_concurrent_dict
+ * @brief Inserts a key-value pair into a concurrent dictionary.
+ *
+ * @param dict Pointer to the concurrent dictionary.
+ * @param key The key to insert, copied into the dictionary.
+ * @param value The value associated with the key.
+ * @return true if inserted, false otherwise.  Sets errno to EINVAL for NULL 
+ *         inputs or an existing key, ENOMEM on allocation failure.
+ */
+bool insert_concurrent_dict(concurrent_dict_t* dict, const char* key, size_t value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function increment_concurrent_dict
+ * @brief Atomically adds delta to a key's value, inserting the key if missing.
+ *
+ * This is the building block for multi-threaded word counts; the lookup and 
+ * update happen under one shard lock.
+ *
+ * @param dict Pointer to the concurrent dictionary.
+ * @param key The key to increment.
+ * @param delta The amount added to the value, and the value of a new key.
+ * @return The updated value, or LONG_MAX on error.  Sets errno to EINVAL for 
+ *         NULL inputs or ENOMEM on allocation failure.
+ */
+size_t increment_concurrent_dict(concurrent_dict_t* dict, const char* key, size_t delta);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_concurrent_dict_value
+ * @brief Returns the value associated with a key.
+ *
+ * Unlike get_dict_value nothing is printed for a missing key.
+ *
+ * @param dict Pointer to the concurrent dictionary.
+ * @param key The key to look up.
+ * @return The value, or LONG_MAX if the key does not exist.  Sets errno to 
+ *         EINVAL for NULL inputs.
+ */
+size_t get_concurrent_dict_value(concurrent_dict_t* dict, const char* key);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function pop_concurrent_dict
+ * @brief Removes a key from a concurrent dictionary and returns its value.
+ *
+ * @param dict Pointer to the concurrent dictionary.
+ * @param key The key to remove.
+ * @return The removed value, or LONG_MAX if the key does not exist.  Sets errno 
+ *         to EINVAL for NULL inputs.
+ */
+size_t pop_concurrent_dict(concurrent_dict_t* dict, const char* key);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function concurrent_dict_size
+ * @brief Returns the number of keys in a concurrent dictionary.
+ *
+ * Shards are counted one at a time, so with concurrent writers the result is 
+ * only a snapshot.
+ *
+ * @param dict Pointer to the concurrent dictionary.
+ * @return The number of keys, or LONG_MAX with errno set to EINVAL on NULL input.
+ */
+const size_t concurrent_dict_size(concurrent_dict_t* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_concurrent_dict
+ * @brief Frees a concurrent dictionary and all of its keys.
+ *
+ * No other thread may be using the dictionary.
+ *
+ * @param dict Pointer to the concurrent dictionary.
+ */
+void free_concurrent_dict(concurrent_dict_t* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_concurrent_dict
+ * @brief Helper function for garbage collection of concurrent dictionaries.
+ *
+ * Used with the CDICT_GBC macro for automatic cleanup.
+ *
+ * @param dict Double pointer to the concurrent dictionary to free.
+ */
+void _free_concurrent_dict(concurrent_dict_t** dict);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro CDICT_GBC
+     * @brief A macro for enabling automatic cleanup of concurrent_dict_t objects.
+     */
+    #define CDICT_GBC __attribute__((cleanup(_free_concurrent_dict)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// SNAPSHOT DICTIONARY PROTOTYPES
+
+/**
+ * @typedef snapshot_dict_t
+ * @brief Opaque struct holding an immutable, atomically replaceable dict_t.
+ *
+ * Built for read-mostly tables.  Readers look keys up without locks and 
+ * without writing to any shared cache line; writers build a complete new 
+ * dict_t and publish it with one atomic pointer swap.  The old dict is freed 
+ * once every reader that could still see it has finished.
+ */
+typedef struct snapshot_dict_t snapshot_dict_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @typedef snapshot_reader_t
+ * @brief Opaque per-thread handle used to read a snapshot_dict_t.
+ *
+ * Each reading thread registers its own handle; it must not be shared.
+ */
+typedef struct snapshot_reader_t snapshot_reader_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_snapshot_dict
+ * @brief Creates a snapshot dictionary publishing an initial dict.
+ *
+ * @param initial The first snapshot, owned by the snapshot dictionary from now 
+ *                on and never modified again.  NULL publishes an empty dict.
+ * @return A pointer to the snapshot dictionary, or NULL with errno set to 
+ *         ENOMEM on allocation failure.
+ */
+snapshot_dict_t* init_snapshot_dict(dict_t* initial);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function register_snapshot_reader
+ * @brief Creates the read handle for one thread.
+ *
+ * @param snap Pointer to the snapshot dictionary.
+ * @return A reader handle, or NULL on failure.  Sets errno to EINVAL for a 
+ *         NULL input or ENOMEM on allocation failure.
+ */
+snapshot_reader_t* register_snapshot_reader(snapshot_dict_t* snap);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function unregister_snapshot_reader
+ * @brief Releases a reader handle once its thread stops reading.
+ *
+ * @param reader The handle returned by register_snapshot_reader.
+ */
+void unregister_snapshot_reader(snapshot_reader_t* reader);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_snapshot_dict_value
+ * @brief Looks a key up in the current snapshot without taking a lock.
+ *
+ * @param reader The calling thread's reader handle.
+ * @param key The key to look up.
+ * @return The value, or LONG_MAX if the key is not in the snapshot.  Sets errno 
+ *         to EINVAL for NULL inputs.
+ */
+size_t get_snapshot_dict_value(snapshot_reader_t* reader, const char* key);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function publish_snapshot_dict
+ * @brief Atomically replaces the current snapshot and frees the old one.
+ *
+ * Readers see either the old or the new dict, never a mix.  The call returns 
+ * after every reader that started on the old snapshot has finished, so it may 
+ * briefly wait, but readers are never blocked.  Calls from several writers 
+ * are serialized.
+ *
+ * @param snap Pointer to the snapshot dictionary.
+ * @param next The new snapshot, owned by the snapshot dictionary from now on 
+ *             and never modified again.
+ * @return true on success, false with errno set to EINVAL for NULL inputs or 
+ *         if next is already the current snapshot.
+ */
+bool publish_snapshot_dict(snapshot_dict_t* snap, dict_t* next);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_snapshot_dict
+ * @brief Frees the snapshot dictionary, its current dict and all reader handles.
+ *
+ * No thread may be reading or publishing.
+ *
+ * @param snap Pointer to the snapshot dictionary.
+ */
+void free_snapshot_dict(snapshot_dict_t* snap);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_snapshot_dict
+ * @brief Helper function for garbage collection of snapshot dictionaries.
+ *
+ * Used with the SNAPSHOT_GBC macro for automatic cleanup.
+ *
+ * @param snap Double pointer to the snapshot dictionary to free.
+ */
+void _free_snapshot_dict(snapshot_dict_t** snap);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro SNAPSHOT_GBC
+     * @brief A macro for enabling automatic cleanup of snapshot_dict_t objects.
+     */
+    #define SNAPSHOT_GBC __attribute__((cleanup(_free_snapshot_dict)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// FROZEN DICTIONARY PROTOTYPES
+
+/**
+ * @typedef frozen_dict_t
+ * @brief Opaque struct representing an immutable minimal perfect hash table.
+ *
+ * Built once from a dict_t for tables that are only queried afterwards, such as 
+ * stop-word lists.  Keys are packed contiguously and every lookup costs one 
+ * hash and one key compare.
+ */
+typedef struct frozen_dict_t frozen_dict_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function freeze_dict
+ * @brief Builds a frozen copy of a dictionary.
+ *
+ * The source dictionary is not modified and may be freed afterwards.  Building 
+ * takes time roughly linear in the number of keys.
+ *
+ * @param dict Pointer to the source dictionary.
+ * @return A pointer to the frozen dictionary, or NULL on failure.  Sets errno to 
+ *         EINVAL for a NULL input or ENOMEM on allocation failure.
+ */
+frozen_dict_t* freeze_dict(const dict_t* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_frozen_dict_value
+ * @brief Returns the value associated with a key in a frozen dictionary.
+ *
+ * @param frozen Pointer to the frozen dictionary.
+ * @param key The key to look up.
+ * @return The value, or LONG_MAX if the key does not exist.  Sets errno to 
+ *         EINVAL for NULL inputs.
+ */
+size_t get_frozen_dict_value(const frozen_dict_t* frozen, const char* key);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function is_frozen_key_value
+ * @brief Returns true if a key exists in a frozen dictionary.
+ *
+ * @param frozen Pointer to the frozen dictionary.
+ * @param key The key to look up.
+ * @return true if the key exists, false otherwise.  Sets errno to EINVAL and 
+ *         returns false for NULL inputs.
+ */
+bool is_frozen_key_value(const frozen_dict_t* frozen, const char* key);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function frozen_dict_size
+ * @brief Returns the number of keys in a frozen dictionary.
+ *
+ * @param frozen Pointer to the frozen dictionary.
+ * @return The number of keys, or LONG_MAX with errno set to EINVAL on NULL input.
+ */
+const size_t frozen_dict_size(const frozen_dict_t* frozen);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_frozen_dict
+ * @brief Frees a frozen dictionary.
+ *
+ * @param frozen Pointer to the frozen dictionary.
+ */
+void free_frozen_dict(frozen_dict_t* frozen);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_frozen_dict
+ * @brief Helper function for garbage collection of frozen dictionaries.
+ *
+ * Used with the FROZEN_GBC macro for automatic cleanup.
+ *
+ * @param frozen Double pointer to the frozen dictionary to free.
+ */
+void _free_frozen_dict(frozen_dict_t** frozen);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro FROZEN_GBC
+     * @brief A macro for enabling automatic cleanup of frozen_dict_t objects.
+     */
+    #define FROZEN_GBC __attribute__((cleanup(_free_frozen_dict)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// WORD SKETCH PROTOTYPES
+
+/**
+ * @typedef word_sketch_t
+ * @brief Opaque struct for approximate word counting in fixed memory.
+ *
+ * A Count-Min sketch estimates the frequency of any word and a Space-Saving 
+ * style heap tracks the k words with the largest estimates.  An estimate never 
+ * undercounts and overcounts by at most epsilon times the total count, with 
+ * probability at least 1 - delta.  Memory depends only on epsilon, delta and k, 
+ * never on the number of distinct words.
+ */
+typedef struct word_sketch_t word_sketch_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_word_sketch
+ * @brief Creates an empty word sketch.
+ *
+ * Uses about (e / epsilon) * ln(1 / delta) counters plus k tracked words.  
+ * Sketches that will be merged must be created with the same epsilon and delta.
+ *
+ * @param epsilon Relative error bound, between 0 and 1 exclusive.
+ * @param delta Probability of exceeding the error bound, between 0 and 1 exclusive.
+ * @param k The number of heavy hitters to track.
+ * @return A pointer to the sketch, or NULL on failure.  Sets errno to EINVAL 
+ *         for out of range arguments, including an epsilon or k so small or 
+ *         large that the table size overflows size_t, or ENOMEM on allocation 
+ *         failure.
+ */
+word_sketch_t* init_word_sketch(double epsilon, double delta, size_t k);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function add_word_sketch
+ * @brief Adds count occurrences of a word to a sketch.
+ *
+ * @param sketch Pointer to the sketch.
+ * @param word A null-terminated word.
+ * @param count The number of occurrences to add.
+ * @return true on success, false on failure.  Sets errno to EINVAL for NULL 
+ *         inputs or ENOMEM on allocation failure.
+ */
+bool add_word_sketch(word_sketch_t* sketch, const char* word, size_t count);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function count_words_sketch
+ * @brief Approximate counterpart of count_words that adds every token to a sketch.
+ *
+ * Tokens are split on the same delimiter set count_words uses, without 
+ * building a token vector, so a stream can be fed one chunk at a time.
+ *
+ * @param sketch Pointer to the sketch.
+ * @param str The string to tokenize.
+ * @param delim A string of delimiter characters.
+ * @return true on success, false on failure.  Sets errno to EINVAL for NULL 
+ *         inputs or ENOMEM on allocation failure.
+ */
+bool count_words_sketch(word_sketch_t* sketch, const string_t* str, const char* delim);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function word_sketch_estimate
+ * @brief Estimates how often a word has been added.
+ *
+ * @param sketch Pointer to the sketch.
+ * @param word A null-terminated word.
+ * @return The estimated count, never below the true count, or LONG_MAX with 
+ *         errno set to EINVAL for NULL inputs.
+ */
+size_t word_sketch_estimate(const word_sketch_t* sketch, const char* word);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function word_sketch_total
+ * @brief Returns the total number of occurrences added to a sketch.
+ *
+ * Multiply by epsilon for the error bound of word_sketch_estimate.
+ *
+ * @param sketch Pointer to the sketch.
+ * @return The total count, or LONG_MAX with errno set to EINVAL on NULL input.
+ */
+const size_t word_sketch_total(const word_sketch_t* sketch);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function word_sketch_top_k
+ * @brief Returns the most frequent tracked words with their estimated counts.
+ *
+ * Keys point into the sketch and stay valid until the sketch is next modified.
+ *
+ * @param sketch Pointer to the sketch.
+ * @param k The number of entries wanted.
+ * @param out Array of at least k entries, filled from the largest count down.
+ * @return The number of entries written, or LONG_MAX on failure.  Sets errno to 
+ *         EINVAL for NULL inputs or ENOMEM on allocation failure.
+ */
+size_t word_sketch_top_k(const word_sketch_t* sketch, size_t k, dict_entry_t* out);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function merge_word_sketch
+ * @brief Adds the counts of one sketch into another.
+ *
+ * Lets each thread or shard count into a private sketch and combine the 
+ * results afterwards.  The merged tracked words are the k best of both.
+ *
+ * @param dst The sketch receiving the counts.
+ * @param src The sketch to merge, left unchanged.
+ * @return true on success, false on failure.  Sets errno to EINVAL for NULL 
+ *         inputs or sketches of different dimensions, ENOMEM on allocation failure.
+ *         On failure dst is left unchanged, so the merge may be retried.
+ */
+bool merge_word_sketch(word_sketch_t* dst, const word_sketch_t* src);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_word_sketch
+ * @brief Frees a word sketch.
+ *
+ * @param sketch Pointer to the sketch.
+ */
+void free_word_sketch(word_sketch_t* sketch);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_word_sketch
+ * @brief Helper function for garbage collection of word sketches.
+ *
+ * Used with the SKETCH_GBC macro for automatic cleanup.
+ *
+ * @param sketch Double pointer to the sketch to free.
+ */
+void _free_word_sketch(word_sketch_t** sketch);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro SKETCH_GBC
+     * @brief A macro for enabling automatic cleanup of word_sketch_t objects.
+     */
+    #define SKETCH_GBC __attribute__((cleanup(_free_word_sketch)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// HYPERLOGLOG PROTOTYPES
+
+/**
+ * @typedef hll_t
+ * @brief Opaque struct estimating the number of distinct tokens in fixed memory.
+ *
+ * A HyperLogLog of precision p uses 2^p one byte registers and has a typical 
+ * relative error of 1.04 / sqrt(2^p), e.g. about 0.8% at p = 14 (16 KiB).
+ */
+typedef struct hll_t hll_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_hll
+ * @brief Creates an empty HyperLogLog estimator.
+ *
+ * @param precision Bits of the hash used to pick a register, from 4 to 18.
+ * @return A pointer to the estimator, or NULL on failure.  Sets errno to 
+ *         EINVAL for an out of range precision or ENOMEM on allocation failure.
+ */
+hll_t* init_hll(unsigned int precision);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function add_hll
+ * @brief Adds one token to an estimator.
+ *
+ * @param hll Pointer to the estimator.
+ * @param token A null-terminated token.
+ * @return true on success, false with errno set to EINVAL for NULL inputs.
+ */
+bool add_hll(hll_t* hll, const char* token);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function add_hll_string
+ * @brief Adds every token of a string, split on a set of delimiters.
+ *
+ * Tokens are hashed in place; no token vector or dictionary is built.
+ *
+ * @param hll Pointer to the estimator.
+ * @param str The string to tokenize.
+ * @param delim A string of delimiter characters.
+ * @return true on success, false with errno set to EINVAL for NULL inputs.
+ */
+bool add_hll_string(hll_t* hll, const string_t* str, const char* delim);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function add_hll_vector
+ * @brief Adds every string in a vector, reusing cached string hashes.
+ *
+ * @param hll Pointer to the estimator.
+ * @param vec The string vector.
+ * @return true on success, false with errno set to EINVAL for NULL inputs.
+ */
+bool add_hll_vector(hll_t* hll, const string_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function hll_estimate
+ * @brief Estimates the number of distinct tokens added.
+ *
+ * @param hll Pointer to the estimator.
+ * @return The estimate, or LONG_MAX with errno set to EINVAL on NULL input.
+ */
+size_t hll_estimate(const hll_t* hll);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function merge_hll
+ * @brief Folds one estimator into another, as if dst had seen both streams.
+ *
+ * Registers are combined with a vectorized bytewise max.
+ *
+ * @param dst The estimator receiving the merge.
+ * @param src The estimator to merge, left unchanged.
+ * @return true on success, false with errno set to EINVAL for NULL inputs or 
+ *         different precisions.
+ */
+bool merge_hll(hll_t* dst, const hll_t* src);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function hll_serialize
+ * @brief Writes an estimator to a portable byte buffer.
+ *
+ * The format is a five byte header (magic "HLL", version, precision) followed 
+ * by the registers, so it does not depend on the machine's endianness.
+ *
+ * @param hll Pointer to the estimator.
+ * @param buffer Destination, or NULL to query the size needed.
+ * @param size Size of buffer in bytes.
+ * @return The number of bytes written or needed, or LONG_MAX on failure.  Sets 
+ *         errno to EINVAL for a NULL estimator or ERANGE if buffer is too small.
+ */
+size_t hll_serialize(const hll_t* hll, unsigned char* buffer, size_t size);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function hll_deserialize
+ * @brief Rebuilds an estimator from the output of hll_serialize.
+ *
+ * @param buffer Serialized bytes.
+ * @param size Number of bytes in buffer.
+ * @return A new estimator, or NULL on failure.  Sets errno to EINVAL for a 
+ *         malformed buffer or ENOMEM on allocation failure.
+ */
+hll_t* hll_deserialize(const unsigned char* buffer, size_t size);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_hll
+ * @brief Frees a HyperLogLog estimator.
+ *
+ * @param hll Pointer to the estimator.
+ */
+void free_hll(hll_t* hll);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_hll
+ * @brief Helper function for garbage collection of HyperLogLog estimators.
+ *
+ * Used with the HLL_GBC macro for automatic cleanup.
+ *
+ * @param hll Double pointer to the estimator to free.
+ */
+void _free_hll(hll_t** hll);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro HLL_GBC
+     * @brief A macro for enabling automatic cleanup of hll_t objects.
+     */
+    #define HLL_GBC __attribute__((cleanup(_free_hll)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// SEARCH INDEX PROTOTYPES
+
+/**
+ * @typedef search_index_t
+ * @brief Opaque, immutable index for fast lookups in a large sorted string set.
+ *
+ * Built once from a sorted string vector.  Keys are stored in Eytzinger 
+ * (breadth first) order with their first eight bytes inline, and each probe 
+ * prefetches the nodes four levels below it, so a lookup touches far fewer 
+ * cache lines than binary_search_str_vector on the same data.  Positions 
+ * reported by the index are positions in the sorted source vector.
+ */
+typedef struct search_index_t search_index_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_search_index
+ * @brief Builds a search index from a string vector in ascending order.
+ *
+ * The keys are copied, so the vector may be changed or freed afterwards.
+ *
+ * @param vec string vector sorted in ascending (FORWARD) order
+ * @return A new search index, or NULL on failure.  Sets errno to EINVAL if vec 
+ *         is NULL, invalid or not sorted, ENOMEM on allocation failure
+ */
+search_index_t* init_search_index(const string_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function search_index_find
+ * @brief Returns the sorted position of a value in the index.
+ *
+ * @param index search index
+ * @param value The value to search for
+ * @return The position of the first copy of value, or LONG_MAX if it is not 
+ *         present.  Sets errno to EINVAL and returns LONG_MAX if an input is NULL
+ */
+size_t search_index_find(const search_index_t* index, const char* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function search_index_lower_bound
+ * @brief Returns the sorted position of the first key not less than value.
+ *
+ * @param index search index
+ * @param value The value to search for
+ * @return A position in [0, size], or LONG_MAX with errno set to EINVAL if an 
+ *         input is NULL
+ */
+size_t search_index_lower_bound(const search_index_t* index, const char* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function search_index_key
+ * @brief Returns the key stored at a sorted position.
+ *
+ * @param index search index
+ * @param rank position in sorted order
+ * @return The null terminated key, owned by the index, or NULL.  Sets errno to 
+ *         EINVAL if index is NULL, ERANGE if rank is out of bounds
+ */
+const char* search_index_key(const search_index_t* index, size_t rank);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function search_index_size
+ * @brief Returns the number of keys held by the index.
+ *
+ * @param index search index
+ * @return The number of keys, or LONG_MAX with errno set to EINVAL if index is NULL
+ */
+const size_t search_index_size(const search_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_search_index
+ * @brief Frees a search index and every key it holds.
+ *
+ * @param index search index to free
+ */
+void free_search_index(search_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_search_index
+ * @brief Helper function for garbage collection of search indexes.
+ *
+ * Used with the SINDEX_GBC macro for automatic cleanup.
+ *
+ * @param index Double pointer to the index to free.
+ */
+void _free_search_index(search_index_t** index);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro SINDEX_GBC
+     * @brief A macro for enabling automatic cleanup of search_index_t objects.
+     */
+    #define SINDEX_GBC __attribute__((cleanup(_free_search_index)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// RADIX TREE PROTOTYPES
+
+/**
+ * @typedef radix_tree_t
+ * @brief Opaque adaptive radix tree mapping string keys to size_t values.
+ *
+ * Inner nodes branch on one byte and come in four sizes (4, 16, 48 and 256 
+ * children) chosen by fan-out, the smallest filling a single cache line.  
+ * Runs of single-child nodes are collapsed into one node prefix.  Supports 
+ * exact lookup, ordered prefix scans and longest-prefix matching, e.g. for 
+ * routing URL paths.
+ */
+typedef struct radix_tree_t radix_tree_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_radix_tree
+ * @brief Creates an empty radix tree.
+ *
+ * @return A new radix tree, or NULL with errno set to ENOMEM on allocation failure
+ */
+radix_tree_t* init_radix_tree(void);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function build_radix_tree
+ * @brief Builds a radix tree in bulk from the strings of a vector.
+ *
+ * Each key maps to its index in vec; a repeated string maps to its first 
+ * index.  When the vector is known to be sorted every node is created 
+ * directly at its final size, which is faster than inserting the strings one 
+ * at a time; otherwise the strings are inserted individually.
+ *
+ * @param vec string vector holding the keys
+ * @return A new radix tree, or NULL on failure.  Sets errno to EINVAL if vec 
+ *         is NULL or invalid, ENOMEM on allocation failure
+ */
+radix_tree_t* build_radix_tree(const string_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function insert_radix_tree
+ * @brief Inserts a key, or replaces the value of an existing key.
+ *
+ * @param tree radix tree
+ * @param key null terminated key, copied into the tree
+ * @param value value stored for the key
+ * @return true on success, false with errno set to EINVAL for NULL inputs or 
+ *         ENOMEM on allocation failure
+ */
+bool insert_radix_tree(radix_tree_t* tree, const char* key, size_t value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_radix_tree_value
+ * @brief Returns the value stored for a key.
+ *
+ * @param tree radix tree
+ * @param key key to look up
+ * @return The stored value, or LONG_MAX if the key is absent.  Sets errno to 
+ *         EINVAL and returns LONG_MAX for NULL inputs
+ */
+size_t get_radix_tree_value(const radix_tree_t* tree, const char* key);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function is_radix_tree_key
+ * @brief Checks whether a key is present in the tree.
+ *
+ * @param tree radix tree
+ * @param key key to look up
+ * @return true if the key is present, false otherwise or with errno set to 
+ *         EINVAL for NULL inputs
+ */
+bool is_radix_tree_key(const radix_tree_t* tree, const char* key);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function radix_tree_prefix_scan
+ * @brief Returns every key starting with a prefix, in ascending order.
+ *
+ * @param tree radix tree
+ * @param prefix prefix to match, an empty prefix returns every key
+ * @return A new string vector, empty if nothing matches, or NULL on failure.  
+ *         Sets errno to EINVAL for NULL inputs, ENOMEM on allocation failure
+ */
+string_v* radix_tree_prefix_scan(const radix_tree_t* tree, const char* prefix);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function radix_tree_longest_prefix
+ * @brief Finds the longest key in the tree that is a prefix of key.
+ *
+ * @param tree radix tree
+ * @param key string to match, e.g. a URL path
+ * @param match_len optional, receives the length of the matching key or 0
+ * @return The value of the longest matching key, or LONG_MAX if no key is a 
+ *         prefix of key.  Sets errno to EINVAL and returns LONG_MAX for NULL inputs
+ */
+size_t radix_tree_longest_prefix(const radix_tree_t* tree, const char* key, 
+                                 size_t* match_len);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function radix_tree_size
+ * @brief Returns the number of keys in the tree.
+ *
+ * @param tree radix tree
+ * @return The number of keys, or LONG_MAX with errno set to EINVAL if tree is NULL
+ */
+const size_t radix_tree_size(const radix_tree_t* tree);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_radix_tree
+ * @brief Frees a radix tree and all of its keys.
+ *
+ * @param tree radix tree to free
+ */
+void free_radix_tree(radix_tree_t* tree);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_radix_tree
+ * @brief Helper function for garbage collection of radix trees.
+ *
+ * Used with the RADIX_GBC macro for automatic cleanup.
+ *
+ * @param tree Double pointer to the tree to free.
+ */
+void _free_radix_tree(radix_tree_t** tree);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro RADIX_GBC
+     * @brief A macro for enabling automatic cleanup of radix_tree_t objects.
+     */
+    #define RADIX_GBC __attribute__((cleanup(_free_radix_tree)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// FRONT CODED VECTOR PROTOTYPES
+
+/**
+ * @typedef front_coded_t
+ * @brief Opaque, read-only compressed copy of a sorted string vector.
+ *
+ * Strings are grouped into buckets.  The first string of each bucket is kept 
+ * whole and the others as the length of the prefix shared with the previous 
+ * string plus the remaining suffix.  Sorted vocabularies typically shrink 
+ * several times compared with a string_v, which spends a string_t header and 
+ * a separate allocation on every entry.
+ */
+typedef struct front_coded_t front_coded_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_front_coded
+ * @brief Builds a front coded copy of a string vector in ascending order.
+ *
+ * Larger buckets compress better; smaller buckets make access by index and 
+ * searches faster, since up to bucket_size - 1 strings are stepped over.
+ *
+ * @param vec string vector sorted in ascending (FORWARD) order
+ * @param bucket_size strings per bucket, 0 selects the default of 16
+ * @return A new front coded vector, or NULL on failure.  Sets errno to EINVAL 
+ *         if vec is NULL, invalid or not sorted, ENOMEM on allocation failure
+ */
+front_coded_t* init_front_coded(const string_v* vec, size_t bucket_size);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function front_coded_get
+ * @brief Decodes the string at an index into a caller supplied buffer.
+ *
+ * Call with a NULL buffer to obtain the length of the string, then pass a 
+ * buffer of at least length + 1 bytes.
+ *
+ * @param fc front coded vector
+ * @param index position of the string
+ * @param buffer destination for the null terminated string, or NULL
+ * @param size size of buffer in bytes
+ * @return The length of the string, or LONG_MAX on failure.  Sets errno to 
+ *         EINVAL if fc is NULL, ERANGE if index is out of bounds or the buffer 
+ *         is too small
+ */
+size_t front_coded_get(const front_coded_t* fc, size_t index, char* buffer, size_t size);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function front_coded_find
+ * @brief Returns the index of a string, searching without decoding it.
+ *
+ * Bucket heads are binary searched and the bucket is then scanned using only 
+ * the shared prefix lengths, touching suffix bytes only where needed.
+ *
+ * @param fc front coded vector
+ * @param value string to look up
+ * @return The index of the first copy of value, or LONG_MAX if it is absent.  
+ *         Sets errno to EINVAL and returns LONG_MAX for NULL inputs
+ */
+size_t front_coded_find(const front_coded_t* fc, const char* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function front_coded_lower_bound
+ * @brief Returns the index of the first string not less than value.
+ *
+ * @param fc front coded vector
+ * @param value string to locate
+ * @return An index in [0, size], or LONG_MAX with errno set to EINVAL for NULL inputs
+ */
+size_t front_coded_lower_bound(const front_coded_t* fc, const char* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function front_coded_size
+ * @brief Returns the number of strings held.
+ *
+ * @param fc front coded vector
+ * @return The number of strings, or LONG_MAX with errno set to EINVAL if fc is NULL
+ */
+const size_t front_coded_size(const front_coded_t* fc);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function front_coded_memory
+ * @brief Returns the number of bytes used by the front coded vector.
+ *
+ * @param fc front coded vector
+ * @return Bytes allocated, or LONG_MAX with errno set to EINVAL if fc is NULL
+ */
+size_t front_coded_memory(const front_coded_t* fc);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_front_coded
+ * @brief Frees a front coded vector.
+ *
+ * @param fc front coded vector to free
+ */
+void free_front_coded(front_coded_t* fc);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_front_coded
+ * @brief Helper function for garbage collection of front coded vectors.
+ *
+ * Used with the FCODE_GBC macro for automatic cleanup.
+ *
+ * @param fc Double pointer to the front coded vector to free.
+ */
+void _free_front_coded(front_coded_t** fc);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro FCODE_GBC
+     * @brief A macro for enabling automatic cleanup of front_coded_t objects.
+     */
+    #define FCODE_GBC __attribute__((cleanup(_free_front_coded)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// BINARY IMAGE PROTOTYPES
+
+/**
+ * @typedef str_vector_image_t
+ * @brief Opaque, read-only string vector opened from a binary image file.
+ *
+ * The file is memory mapped and used in place, so opening costs the same for 
+ * any number of strings and only the pages touched by lookups are read.  
+ * Images are written in the byte order of the producing machine and are 
+ * rejected on a machine with a different byte order.
+ */
+typedef struct str_vector_image_t str_vector_image_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @typedef dict_image_t
+ * @brief Opaque, read-only dictionary opened from a binary image file.
+ *
+ * The image holds the minimal perfect hash layout of a frozen_dict_t, so 
+ * lookups run directly against the mapped file.  It can only be opened on a 
+ * machine with the same byte order and size_t width as the producer.
+ */
+typedef struct dict_image_t dict_image_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function save_str_vector
+ * @brief Writes a string vector to a versioned, checksummed binary image.
+ *
+ * @param vec string vector to save
+ * @param path file to create or overwrite
+ * @return true on success.  On failure returns false, removes a partially 
+ *         written file and sets errno to EINVAL for NULL inputs, EIO for write 
+ *         errors or the value set by fopen
+ */
+bool save_str_vector(const string_v* vec, const char* path);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function open_str_vector_image
+ * @brief Maps a string vector image written by save_str_vector.
+ *
+ * The header is always validated.  Verifying the checksum reads the whole 
+ * file once, which is worth doing for files that may have been damaged in 
+ * transit.
+ *
+ * @param path image file
+ * @param verify true to check the body checksum
+ * @return A new image, or NULL on failure.  Sets errno to EINVAL for a NULL 
+ *         path or a malformed or incompatible file, EILSEQ for a checksum 
+ *         mismatch, or the value set by the operating system
+ */
+str_vector_image_t* open_str_vector_image(const char* path, bool verify);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function str_vector_image_index
+ * @brief Returns the string at an index of an image.
+ *
+ * @param image string vector image
+ * @param index position of the string
+ * @param len receives the string length, may be NULL
+ * @return A null terminated string inside the mapping, valid until the image 
+ *         is closed, or NULL with errno set to EINVAL for a NULL image or 
+ *         ERANGE for an out of range index
+ */
+const char* str_vector_image_index(const str_vector_image_t* image, size_t index, 
+                                   size_t* len);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function str_vector_image_find
+ * @brief Returns the index of a string in an image.
+ *
+ * Images saved from a sorted vector are binary searched; others are scanned.
+ *
+ * @param image string vector image
+ * @param value string to locate
+ * @return The index of value, or LONG_MAX if it is absent.  Sets errno to 
+ *         EINVAL for NULL inputs
+ */
+size_t str_vector_image_find(const str_vector_image_t* image, const char* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function str_vector_image_size
+ * @brief Returns the number of strings in an image.
+ *
+ * @param image string vector image
+ * @return The number of strings, or LONG_MAX with errno set to EINVAL if image is NULL
+ */
+const size_t str_vector_image_size(const str_vector_image_t* image);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function close_str_vector_image
+ * @brief Unmaps a string vector image.
+ *
+ * @param image string vector image to close
+ */
+void close_str_vector_image(str_vector_image_t* image);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _close_str_vector_image
+ * @brief Helper function for garbage collection of string vector images.
+ *
+ * Used with the STRIMG_GBC macro for automatic cleanup.
+ *
+ * @param image Double pointer to the image to close.
+ */
+void _close_str_vector_image(str_vector_image_t** image);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro STRIMG_GBC
+     * @brief A macro for enabling automatic cleanup of str_vector_image_t objects.
+     */
+    #define STRIMG_GBC __attribute__((cleanup(_close_str_vector_image)))
+#endif
+// --------------------------------------------------------------------------------
+
+/**
+ * @function save_dict
+ * @brief Writes a dictionary to a versioned, checksummed binary image.
+ *
+ * The dictionary is frozen first, so saving costs the same as freeze_dict.
+ *
+ * @param dict dictionary to save
+ * @param path file to create or overwrite
+ * @return true on success.  On failure returns false, removes a partially 
+ *         written file and sets errno to EINVAL for NULL inputs, ENOMEM, EIO 
+ *         for write errors or the value set by fopen
+ */
+bool save_dict(const dict_t* dict, const char* path);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function open_dict_image
+ * @brief Maps a dictionary image written by save_dict.
+ *
+ * @param path image file
+ * @param verify true to check the body checksum
+ * @return A new image, or NULL on failure.  Sets errno to EINVAL for a NULL 
+ *         path or a malformed or incompatible file, EILSEQ for a checksum 
+ *         mismatch, or the value set by the operating system
+ */
+dict_image_t* open_dict_image(const char* path, bool verify);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_dict_image_value
+ * @brief Returns the value stored for a key in a dictionary image.
+ *
+ * @param image dictionary image
+ * @param key key to look up
+ * @return The value, or LONG_MAX if the key is absent.  Sets errno to EINVAL 
+ *         for NULL inputs
+ */
+size_t get_dict_image_value(const dict_image_t* image, const char* key);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function dict_image_frozen
+ * @brief Returns a frozen dictionary view of an image.
+ *
+ * The view accepts the read functions of frozen_dict_t, such as 
+ * is_frozen_key_value, and must not be passed to free_frozen_dict.
+ *
+ * @param image dictionary image
+ * @return A view valid until the image is closed, or NULL with errno set to 
+ *         EINVAL if image is NULL
+ */
+const frozen_dict_t* dict_image_frozen(const dict_image_t* image);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function dict_image_size
+ * @brief Returns the number of keys in a dictionary image.
+ *
+ * @param image dictionary image
+ * @return The number of keys, or LONG_MAX with errno set to EINVAL if image is NULL
+ */
+const size_t dict_image_size(const dict_image_t* image);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function close_dict_image
+ * @brief Unmaps a dictionary image.
+ *
+ * @param image dictionary image to close
+ */
+void close_dict_image(dict_image_t* image);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _close_dict_image
+ * @brief Helper function for garbage collection of dictionary images.
+ *
+ * Used with the DICTIMG_GBC macro for automatic cleanup.
+ *
+ * @param image Double pointer to the image to close.
+ */
+void _close_dict_image(dict_image_t** image);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro DICTIMG_GBC
+     * @brief A macro for enabling automatic cleanup of dict_image_t objects.
+     */
+    #define DICTIMG_GBC __attribute__((cleanup(_close_dict_image)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// STRING BUILDER PROTOTYPES
+
+/*
+ * The functions below append to a string_t in place, turning it into a 
+ * string builder.  Unlike string_lit_concat, they grow the buffer 
+ * geometrically, so assembling a line from many pieces performs few 
+ * reallocations, and numbers are formatted without temporary buffers.
+ */
+
+/**
+ * @function string_format_concat
+ * @brief Appends printf style formatted text to a string.
+ *
+ * The text is formatted directly into the spare capacity of str, which is 
+ * grown and the text formatted once more only if it does not fit.
+ *
+ * @param str string to append to
+ * @param format printf style format string, followed by its arguments
+ * @return true on success.  On failure str is unchanged and errno is set to 
+ *         EINVAL for NULL inputs or an encoding error, ENOMEM on allocation 
+ *         failure
+ */
+bool string_format_concat(string_t* str, const char* format, ...);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function string_int_concat
+ * @brief Appends the decimal form of a signed integer to a string.
+ *
+ * @param str string to append to
+ * @param value integer to format
+ * @return true on success, false with errno set to EINVAL for a NULL string 
+ *         or ENOMEM on allocation failure
+ */
+bool string_int_concat(string_t* str, long long value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function string_uint_concat
+ * @brief Appends the decimal form of an unsigned integer to a string.
+ *
+ * @param str string to append to
+ * @param value integer to format
+ * @return true on success, false with errno set to EINVAL for a NULL string 
+ *         or ENOMEM on allocation failure
+ */
+bool string_uint_concat(string_t* str, unsigned long long value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function string_float_concat
+ * @brief Appends a floating point number in fixed notation to a string.
+ *
+ * The output is identical to printf with "%.*f".  Values with at most 15 
+ * significant digits before rounding are formatted without calling printf.
+ *
+ * @param str string to append to
+ * @param value number to format
+ * @param precision digits after the decimal point, a negative value selects 6
+ * @return true on success, false with errno set to EINVAL for a NULL string 
+ *         or ENOMEM on allocation failure
+ */
+bool string_float_concat(string_t* str, double value, int precision);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function clear_string
+ * @brief Empties a string but keeps its allocation for reuse.
+ *
+ * @param str string to clear, errno is set to EINVAL if it is NULL
+ */
+void clear_string(string_t* str);
+// ================================================================================ 
+// ================================================================================ 
+// NUMBER PARSING PROTOTYPES
+
+/**
+ * @enum parse_status
+ * @brief Result of the number parsing functions.
+ *
+ * The parsers report failures through this value alone and never modify 
+ * errno, so a column of fields can be parsed without clearing and checking 
+ * errno around every call.
+ */
+typedef enum {
+    PARSE_OK,        // The whole range is a number
+    PARSE_EMPTY,     // The range is empty
+    PARSE_INVALID,   // NULL input, or the range is not a number in the C locale syntax
+    PARSE_OVERFLOW   // A number outside the range of the result type
+} parse_status;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parse_int
+ * @brief Parses a decimal integer from exactly len bytes.
+ *
+ * The text is an optional sign followed by digits.  Whitespace and other 
+ * trailing characters are rejected and the bytes need not be null terminated, 
+ * so tokens and CSV fields can be parsed where they lie.
+ *
+ * @param str start of the text
+ * @param len number of bytes to parse
+ * @param value receives the number; on PARSE_OVERFLOW it receives LLONG_MAX 
+ *        or LLONG_MIN, and it is unchanged on other errors
+ * @return PARSE_OK, PARSE_EMPTY, PARSE_INVALID or PARSE_OVERFLOW
+ */
+parse_status parse_int(const char* str, size_t len, long long* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parse_uint
+ * @brief Parses an unsigned decimal integer from exactly len bytes.
+ *
+ * Accepts the same text as parse_int.  A minus sign is allowed only for zero; 
+ * other negative numbers report PARSE_OVERFLOW.
+ *
+ * @param str start of the text
+ * @param len number of bytes to parse
+ * @param value receives the number; on PARSE_OVERFLOW it receives ULLONG_MAX 
+ *        for positive numbers and 0 for negative ones, and it is unchanged on 
+ *        other errors
+ * @return PARSE_OK, PARSE_EMPTY, PARSE_INVALID or PARSE_OVERFLOW
+ */
+parse_status parse_uint(const char* str, size_t len, unsigned long long* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parse_double
+ * @brief Parses a decimal floating point number from exactly len bytes.
+ *
+ * Accepts an optional sign, digits with an optional '.' fraction and an 
+ * optional e or E exponent, as well as inf, infinity and nan in any case.  
+ * The decimal point is always '.', whatever the current locale.  The result 
+ * is correctly rounded, the same as strtod in the C locale.
+ *
+ * @param str start of the text
+ * @param len number of bytes to parse
+ * @param value receives the number; on PARSE_OVERFLOW it receives an infinity 
+ *        of the right sign, and it is unchanged on other errors
+ * @return PARSE_OK, PARSE_EMPTY, PARSE_INVALID or PARSE_OVERFLOW
+ */
+parse_status parse_double(const char* str, size_t len, double* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function string_to_int
+ * @brief Parses the whole of a string as a decimal integer.
+ *
+ * @param str string to parse
+ * @param value receives the number, see parse_int
+ * @return The status of parse_int, or PARSE_INVALID if str is NULL
+ */
+parse_status string_to_int(const string_t* str, long long* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function string_to_uint
+ * @brief Parses the whole of a string as an unsigned decimal integer.
+ *
+ * @param str string to parse
+ * @param value receives the number, see parse_uint
+ * @return The status of parse_uint, or PARSE_INVALID if str is NULL
+ */
+parse_status string_to_uint(const string_t* str, unsigned long long* value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function string_to_double
+ * @brief Parses the whole of a string as a floating point number.
+ *
+ * @param str string to parse
+ * @param value receives the number, see parse_double
+ * @return The status of parse_double, or PARSE_INVALID if str is NULL
+ */
+parse_status string_to_double(const string_t* str, double* value);
+// ================================================================================ 
+// ================================================================================ 
+// CSV READER PROTOTYPES
+
+/**
+ * @typedef csv_field_t
+ * @brief One field of a CSV row, viewed in place.
+ *
+ * str is not null terminated.  It points into the input, or into the reader 
+ * for quoted fields that contained "" escapes, and stays valid until the 
+ * next call to csv_next_row.  For a quoted field it excludes the quotes.
+ */
+typedef struct {
+    const char* str;
+    size_t len;
+} csv_field_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @typedef csv_reader_t
+ * @brief Opaque reader that splits delimited text into rows of field views.
+ *
+ * Rows end in \n or \r\n and blank lines are skipped.  A field that starts 
+ * with a double quote may contain delimiters and line breaks and writes a 
+ * quote as "".  Unlike tokenize_string, consecutive delimiters produce empty 
+ * fields and no string is allocated per field.
+ */
+typedef struct csv_reader_t csv_reader_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_csv_reader
+ * @brief Creates a reader over text already in memory.
+ *
+ * @param data text to parse, which must outlive the reader
+ * @param len number of bytes in data
+ * @param delim field delimiter, e.g. ',' for CSV or '\t' for TSV
+ * @return A new reader, or NULL with errno set to EINVAL if data is NULL or 
+ *         delim is a quote or line break, ENOMEM on allocation failure
+ */
+csv_reader_t* init_csv_reader(const char* data, size_t len, char delim);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_csv_stream
+ * @brief Creates a reader that reads a FILE* in chunks.
+ *
+ * Only the rows not yet returned are held in memory, so inputs larger than 
+ * memory can be read.  A row longer than the buffer grows it.  The caller 
+ * keeps ownership of file.
+ *
+ * @param file open stream to read from
+ * @param delim field delimiter
+ * @return A new reader, or NULL with errno set to EINVAL if file is NULL or 
+ *         delim is a quote or line break, ENOMEM on allocation failure
+ */
+csv_reader_t* init_csv_stream(FILE* file, char delim);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function open_csv_reader
+ * @brief Creates a reader over a file.
+ *
+ * On POSIX and Windows the file is memory mapped, so fields are views into 
+ * the mapping and the operating system pages the file in and out as it is 
+ * read.  Other targets stream the file as init_csv_stream does.
+ *
+ * @param path file to read
+ * @param delim field delimiter
+ * @return A new reader, or NULL with errno set to EINVAL for a NULL path or 
+ *         an invalid delim, ENOMEM, or the value set by the operating system
+ */
+csv_reader_t* open_csv_reader(const char* path, char delim);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function csv_next_row
+ * @brief Parses the next row.
+ *
+ * Set errno to 0 before reading to tell the end of the input from an error.
+ *
+ * @param reader CSV reader
+ * @param fields receives the fields of the row, valid until the next call
+ * @param count receives the number of fields
+ * @return true if a row was read.  false at the end of the input, or with 
+ *         errno set to EINVAL for NULL inputs, EILSEQ for an unterminated 
+ *         quoted field or text after a closing quote, ENOMEM or EIO
+ */
+bool csv_next_row(csv_reader_t* reader, const csv_field_t** fields, size_t* count);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function csv_reader_rows
+ * @brief Returns the number of rows read so far.
+ *
+ * After an EILSEQ error the malformed row is number csv_reader_rows() + 1, 
+ * counting blank lines out.
+ *
+ * @param reader CSV reader
+ * @return The number of rows, or LONG_MAX with errno set to EINVAL if reader is NULL
+ */
+const size_t csv_reader_rows(const csv_reader_t* reader);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_csv_reader
+ * @brief Frees a reader and unmaps or closes the file it opened.
+ *
+ * @param reader CSV reader to free
+ */
+void free_csv_reader(csv_reader_t* reader);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_csv_reader
+ * @brief Helper function for garbage collection of CSV readers.
+ *
+ * Used with the CSV_GBC macro for automatic cleanup.
+ *
+ * @param reader Double pointer to the reader to free.
+ */
+void _free_csv_reader(csv_reader_t** reader);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro CSV_GBC
+     * @brief A macro for enabling automatic cleanup of csv_reader_t objects.
+     */
+    #define CSV_GBC __attribute__((cleanup(_free_csv_reader)))
+#endif
+// ================================================================================ 
+// ================================================================================ 
+// LINE ITERATOR PROTOTYPES
+
+/**
+ * @typedef line_iter_t
+ * @brief Cursor over the lines of a block of text.
+ *
+ * Lives on the caller's stack and yields views into the text, so splitting 
+ * text into lines allocates nothing.  The fields are private to the library.  
+ * Modifying or freeing the text invalidates the cursor.
+ */
+typedef struct {
+    const char* next;
+    const char* end;
+} line_iter_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_line_iter
+ * @brief Returns a cursor positioned before the first line of a string.
+ *
+ * @param str string to split into lines
+ * @return A cursor.  If str is NULL errno is set to EINVAL and the cursor 
+ *         yields no lines.
+ */
+line_iter_t init_line_iter(const string_t* str);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_line_iter_lit
+ * @brief Returns a cursor positioned before the first line of a char buffer.
+ *
+ * @param data text to split into lines, which need not be null terminated
+ * @param len number of bytes in data
+ * @return A cursor.  If data is NULL errno is set to EINVAL and the cursor 
+ *         yields no lines.
+ */
+line_iter_t init_line_iter_lit(const char* data, size_t len);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function line_iter_next
+ * @brief Advances a cursor and returns the next line.
+ *
+ * Lines end in \n or \r\n, and the line break is not part of the view.  Text 
+ * after the last line break is returned as a final line if it is not empty, 
+ * so "a\nb" and "a\nb\n" both hold two lines.
+ *
+ * @param iter Cursor from init_line_iter or init_line_iter_lit.
+ * @param line Receives the start of the line, which is not null terminated.
+ * @param len Receives the length of the line.
+ * @return true if a line was produced, false once the text is exhausted.  
+ *         Sets errno to EINVAL for NULL inputs.
+ */
+bool line_iter_next(line_iter_t* iter, const char** line, size_t* len);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function read_line_string
+ * @brief Reads the next line of a file into a reusable string, like getline.
+ *
+ * The line replaces the contents of line, without its \n or \r\n.  The 
+ * buffer only grows to fit the longest line, so reading a file of any size 
+ * with one string uses constant memory.  Lines must not contain null bytes.
+ *
+ * @param line string that receives the line
+ * @param file open stream to read from
+ * @return true if a line was read, false at the end of the file or with errno 
+ *         set to EINVAL for NULL inputs, EIO for read errors or ENOMEM on 
+ *         allocation failure
+ */
+bool read_line_string(string_t* line, FILE* file);
+// ================================================================================ 
+// ================================================================================ 
+// GENERIC MACROS 
+
+/**
+* @macro s_size
+* @brief Generic macro to return the populated length of a string data type such as
+*        string_t and string_v
+*
+* @param dat A pointer to a string_t or strinv_v data type
+* @return The populated length of a string data type
+*/
+#define s_size(dat) _Generic((dat), \
+    string_t*: string_size, \
+    string_v*: str_vector_size, \
+    dict_t*: dict_size) (dat)
+// --------------------------------------------------------------------------------
+
+/**
+* @macro s_alloc
+* @brief Generic macro to return the allocated size of a string data type such as
+*        string_t and string_v
+*
+* @param dat A pointer to a string_t or strinv_v data type
+* @return The allocated length of a string data type
+*/
+#define s_alloc(dat) _Generic((dat), \
+    string_t*: string_alloc, \
+    string_v*: str_vector_alloc, \
+    dict_t*: dict_alloc) (dat)
+// ================================================================================
+// ================================================================================
+
+#ifndef ITER_DIR_H
+#define ITER_DIR_H
+    /**
+     * @brief An enum containing keywords for an iterator 
+     *
+     * This enum contains keywords that are used to describe the order of iteration
+     * within an iterator 
+     *
+     * @attribute FORWARD Keyword to command a forward iteration 
+     * @attribute REVERSE Keyword to command a reverese iteration
+     */
+    typedef enum {
+        FORWARD,
+        REVERSE
+    }iter_dir;
+#endif /* ITER_DIR_H*/
+// --------------------------------------------------------------------------------
+
+/**
+* @function sort_str_vector
+* @brief Sorts a string vector in ascending or descending order.
+*
+* Uses an optimized QuickSort algorithm with median-of-three pivot selection
+* and insertion sort for small subarrays. Sort direction is determined by
+* the iter_dir parameter.
+*
 * @param vec string vector to sort
 * @param direction FORWARD for ascending order, REVERSE for descending
 * @return void
@@ -1122,6 +3212,98 @@ bool is_key_value(const dict_t* dict, const char* key);
 void sort_str_vector(string_v* vec, iter_dir direction);
 // --------------------------------------------------------------------------------
 
+/**
+* @function unique_str_vector
+* @brief Sorts a string vector and removes duplicate strings.
+*
+* After sorting, duplicates are adjacent and one linear pass moves every kept 
+* string to its final slot while freeing the removed ones, so no element is 
+* shifted more than once.
+*
+* @param vec string vector to deduplicate, left in ascending order
+* @return The number of strings removed, or LONG_MAX with errno set to EINVAL 
+*         if vec is NULL or invalid
+*/
+size_t unique_str_vector(string_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+* @function unique_ordered_str_vector
+* @brief Removes duplicate strings while keeping first occurrences in place.
+*
+* Uses a hash set of the strings already kept, reusing each string's cached 
+* hash, then compacts the vector in one pass.
+*
+* @param vec string vector to deduplicate, original order preserved
+* @return The number of strings removed, or LONG_MAX on failure.  Sets errno to 
+*         EINVAL if vec is NULL or invalid, ENOMEM on allocation failure
+*/
+size_t unique_ordered_str_vector(string_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+* @function union_str_vector
+* @brief Returns the sorted union of two ascending string vectors.
+*
+* Both inputs must already be sorted in ascending (FORWARD) order.  The inputs
+* are merged in one linear pass; when one input is at least eight times the 
+* size of the other, runs are skipped with a galloping search instead.  
+* Strings repeated within or across the inputs appear once in the result.  
+* The result stores all of its characters in a single buffer owned by the 
+* vector and is released with free_str_vector as usual.
+*
+* @param a first sorted string vector
+* @param b second sorted string vector
+* @return A new sorted string vector, or NULL on failure.  Sets errno to 
+*         EINVAL if either input is NULL or invalid, ENOMEM on allocation failure
+*/
+string_v* union_str_vector(const string_v* a, const string_v* b);
+// --------------------------------------------------------------------------------
+
+/**
+* @function intersect_str_vector
+* @brief Returns the strings found in both of two ascending string vectors.
+*
+* Follows the same merge and galloping strategy as union_str_vector, so 
+* intersecting a short keyword list with a long one costs 
+* O(n log(m / n)) compares rather than a binary search per keyword.
+*
+* @param a first sorted string vector
+* @param b second sorted string vector
+* @return A new sorted string vector, or NULL on failure.  Sets errno to 
+*         EINVAL if either input is NULL or invalid, ENOMEM on allocation failure
+*/
+string_v* intersect_str_vector(const string_v* a, const string_v* b);
+// --------------------------------------------------------------------------------
+
+/**
+* @function difference_str_vector
+* @brief Returns the strings of a that do not appear in b.
+*
+* @param a sorted string vector to take strings from
+* @param b sorted string vector of strings to exclude
+* @return A new sorted string vector, or NULL on failure.  Sets errno to 
+*         EINVAL if either input is NULL or invalid, ENOMEM on allocation failure
+*/
+string_v* difference_str_vector(const string_v* a, const string_v* b);
+// --------------------------------------------------------------------------------
+
+/**
+* @function k_way_merge_str_vector
+* @brief Merges k ascending string vectors into one sorted vector.
+*
+* Unlike union_str_vector every input string is kept, duplicates included.  
+* A min-heap of input heads picks the next input, and the whole run of that 
+* input below the next smallest head is copied at once.
+*
+* @param vecs array of k sorted string vectors
+* @param k number of vectors in vecs
+* @return A new sorted string vector, or NULL on failure.  Sets errno to 
+*         EINVAL if vecs, k or any input is invalid, ENOMEM on allocation failure
+*/
+string_v* k_way_merge_str_vector(const string_v* const* vecs, size_t k);
+// --------------------------------------------------------------------------------
+
 /**
 * @function tokenize_string
 * @brief Splits a string into tokens based on delimiter characters.
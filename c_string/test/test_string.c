@@ -17,6 +17,10 @@
 #include <errno.h>
 #include <string.h>
 #include <limits.h>
+#if defined(__unix__) || defined(__APPLE__)
+    #include <pthread.h>
+    #include <stdatomic.h>
+#endif
 
 #include "test_string.h"
 #include "../c_string.h"
@@ -233,6 +237,189 @@ void test_concat_large_strings(void **state) {
 }
 // --------------------------------------------------------------------------------
 
+void test_string_format_concat(void **state) {
+    string_t* str = init_string("id=");
+    assert_true(string_format_concat(str, "%d|%5s|%-4s|%.2f|%x", -42, "ab", "cd", 3.14159, 255u));
+    assert_string_equal(get_string(str), "id=-42|   ab|cd  |3.14|ff");
+    assert_int_equal(string_size(str), strlen(get_string(str)));
+
+    // Output longer than the spare capacity forces a second formatting pass
+    char expected[512];
+    memset(expected, 'z', 300);
+    expected[300] = '\0';
+    clear_string(str);
+    assert_int_equal(string_size(str), 0);
+    assert_string_equal(get_string(str), "");
+    assert_true(string_format_concat(str, "%s", expected));
+    assert_string_equal(get_string(str), expected);
+    assert_int_equal(string_size(str), 300);
+
+    errno = 0;
+    assert_false(string_format_concat(NULL, "%d", 1));
+    assert_int_equal(errno, EINVAL);
+    free_string(str);
+}
+// --------------------------------------------------------------------------------
+
+void test_string_number_concat(void **state) {
+    string_t* str = init_string("");
+    char expected[64];
+    long long ints[8] = {0, 7, -7, 10, 99999, -1000000007LL, LLONG_MAX, LLONG_MIN};
+    for (size_t i = 0; i < 8; i++) {
+        clear_string(str);
+        assert_true(string_int_concat(str, ints[i]));
+        snprintf(expected, sizeof(expected), "%lld", ints[i]);
+        assert_string_equal(get_string(str), expected);
+        assert_int_equal(string_size(str), strlen(expected));
+    }
+    clear_string(str);
+    assert_true(string_uint_concat(str, ULLONG_MAX));
+    snprintf(expected, sizeof(expected), "%llu", ULLONG_MAX);
+    assert_string_equal(get_string(str), expected);
+
+    // Floats must match printf exactly, including ties and the slow path
+    double floats[12] = {0.0, -0.0, 0.125, 2.5, -1.005, 3.14159265358979, 
+                         1e20, -123456.789, 0.1, 999.9999, 1e-7, 1.0 / 3.0};
+    int precisions[6] = {0, 1, 2, 3, 6, 17};
+    for (size_t i = 0; i < 12; i++) {
+        for (size_t p = 0; p < 6; p++) {
+            clear_string(str);
+            assert_true(string_float_concat(str, floats[i], precisions[p]));
+            snprintf(expected, sizeof(expected), "%.*f", precisions[p], floats[i]);
+            assert_string_equal(get_string(str), expected);
+        }
+    }
+    clear_string(str);
+    assert_true(string_float_concat(str, 2.0, -1));
+    assert_string_equal(get_string(str), "2.000000");
+
+    // A row assembled from many pieces
+    clear_string(str);
+    for (int i = 0; i < 1000; i++) {
+        string_int_concat(str, i);
+        string_lit_concat(str, ",");
+        string_float_concat(str, i / 8.0, 3);
+        string_lit_concat(str, ";");
+    }
+    assert_true(string_size(str) > 10000);
+    assert_non_null(strstr(get_string(str), "999,124.875;"));
+    free_string(str);
+}
+// --------------------------------------------------------------------------------
+
+void test_parse_int_ranges(void **state) {
+    // Numbers are parsed from inside a larger buffer without null terminators
+    const char* text = "12,-7,+42,9223372036854775807,-9223372036854775808,9223372036854775808";
+    long long value = 0;
+    assert_int_equal(parse_int(text, 2, &value), PARSE_OK);
+    assert_int_equal(value, 12);
+    assert_int_equal(parse_int(text + 3, 2, &value), PARSE_OK);
+    assert_int_equal(value, -7);
+    assert_int_equal(parse_int(text + 6, 3, &value), PARSE_OK);
+    assert_int_equal(value, 42);
+    assert_int_equal(parse_int(text + 10, 19, &value), PARSE_OK);
+    assert_true(value == LLONG_MAX);
+    assert_int_equal(parse_int(text + 30, 20, &value), PARSE_OK);
+    assert_true(value == LLONG_MIN);
+    assert_int_equal(parse_int(text + 51, 19, &value), PARSE_OVERFLOW);
+    assert_true(value == LLONG_MAX);
+
+    unsigned long long uvalue = 0;
+    assert_int_equal(parse_uint("18446744073709551615", 20, &uvalue), PARSE_OK);
+    assert_true(uvalue == ULLONG_MAX);
+    assert_int_equal(parse_uint("18446744073709551616", 20, &uvalue), PARSE_OVERFLOW);
+    assert_true(uvalue == ULLONG_MAX);
+    assert_int_equal(parse_uint("-0", 2, &uvalue), PARSE_OK);
+    assert_true(uvalue == 0);
+    assert_int_equal(parse_uint("-3", 2, &uvalue), PARSE_OVERFLOW);
+
+    // Errors leave value alone and never set errno
+    char* invalid[6] = {"-", "+", " 1", "1 ", "0x10", "1.0"};
+    errno = 0;
+    value = 5;
+    for (size_t i = 0; i < 6; i++) {
+        assert_int_equal(parse_int(invalid[i], strlen(invalid[i]), &value), PARSE_INVALID);
+    }
+    assert_int_equal(parse_int("", 0, &value), PARSE_EMPTY);
+    assert_int_equal(parse_int(NULL, 1, &value), PARSE_INVALID);
+    assert_int_equal(value, 5);
+    assert_int_equal(errno, 0);
+
+    string_t* str = init_string("-123456789");
+    assert_int_equal(string_to_int(str, &value), PARSE_OK);
+    assert_int_equal(value, -123456789);
+    assert_int_equal(string_to_uint(str, &uvalue), PARSE_OVERFLOW);
+    assert_int_equal(string_to_int(NULL, &value), PARSE_INVALID);
+    free_string(str);
+}
+// --------------------------------------------------------------------------------
+
+void test_parse_double_matches_strtod(void **state) {
+    char* inputs[] = {
+        "0", "-0", "1", "-2.5", "3.14159", ".5", "5.", "1e10", "1E-10", "+7e+2", 
+        "0.1", "0.30000000000000004", "123456789012345678901234567890", 
+        "2.2250738585072014e-308", "4.9e-324", "2.4703282292062327e-324", 
+        "1.7976931348623157e308", "9007199254740993", "0.000000000000000000000001", 
+        "1.00000000000000011102230246251565404236316680908203125", 
+        "7.3177701707893310e+15", "1e-400", "000123.4500", "8.589973e9"
+    };
+    size_t count = sizeof(inputs) / sizeof(inputs[0]);
+    for (size_t i = 0; i < count; i++) {
+        double value = 0.0;
+        assert_int_equal(parse_double(inputs[i], strlen(inputs[i]), &value), PARSE_OK);
+        double expected = strtod(inputs[i], NULL);
+        assert_memory_equal(&value, &expected, sizeof(double));
+    }
+
+    // Pseudo random decimals with up to 17 significant digits
+    char buffer[64];
+    unsigned long long seed = 12345;
+    for (size_t i = 0; i < 20000; i++) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        int exponent = (int)(seed >> 33) % 600 - 300;
+        snprintf(buffer, sizeof(buffer), "%llu.%llue%d", (seed >> 40) % 100000, 
+                 (seed >> 8) % 100000000000ull, exponent);
+        double value = 0.0;
+        assert_int_equal(parse_double(buffer, strlen(buffer), &value), PARSE_OK);
+        double expected = strtod(buffer, NULL);
+        assert_memory_equal(&value, &expected, sizeof(double));
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_parse_double_special(void **state) {
+    double value = 0.0;
+    assert_int_equal(parse_double("inf", 3, &value), PARSE_OK);
+    assert_true(value > 1e308);
+    assert_int_equal(parse_double("-Infinity", 9, &value), PARSE_OK);
+    assert_true(value < -1e308);
+    assert_int_equal(parse_double("NaN", 3, &value), PARSE_OK);
+    assert_true(value != value);
+    errno = 0;
+    assert_int_equal(parse_double("1e309", 5, &value), PARSE_OVERFLOW);
+    assert_true(value > 1e308);
+    assert_int_equal(parse_double("-1.8e308", 8, &value), PARSE_OVERFLOW);
+    assert_true(value < -1e308);
+    assert_int_equal(errno, 0);
+
+    char* invalid[10] = {"-", ".", "e5", "1e", "1e+", "1.2.3", " 1", "1,5", "0x1p3", "infx"};
+    value = 2.0;
+    for (size_t i = 0; i < 10; i++) {
+        assert_int_equal(parse_double(invalid[i], strlen(invalid[i]), &value), PARSE_INVALID);
+    }
+    assert_int_equal(parse_double("", 0, &value), PARSE_EMPTY);
+    assert_true(value == 2.0);
+
+    // A length bound stops before the rest of the buffer
+    assert_int_equal(parse_double("2.75;99", 4, &value), PARSE_OK);
+    assert_true(value == 2.75);
+    string_t* str = init_string("-0.125");
+    assert_int_equal(string_to_double(str, &value), PARSE_OK);
+    assert_true(value == -0.125);
+    free_string(str);
+}
+// --------------------------------------------------------------------------------
+
 /* Test cases for string comparison */
 void test_compare_strings_equal(void **state) {
     string_t* str1 = init_string("hello");
@@ -316,6 +503,57 @@ void test_compare_strings_case_sensitivity(void **state) {
     free_string(str2);
 }
 // --------------------------------------------------------------------------------
+
+void test_compare_strings_long(void **state) {
+    // Exercise the 32/16 byte block paths and the scalar tail
+    char a[80];
+    char b[80];
+    memset(a, 'x', 79);
+    a[79] = '\0';
+    string_t* str1 = init_string(a);
+    for (size_t i = 0; i < 79; i++) {
+        memcpy(b, a, sizeof(a));
+        b[i] = 'y';
+        string_t* str2 = init_string(b);
+        assert_true(compare_strings(str1, str2) < 0);
+        assert_true(compare_strings(str2, a) > 0);
+        assert_false(equal_strings(str1, str2));
+        free_string(str2);
+    }
+    assert_int_equal(compare_strings(str1, a), 0);
+    free_string(str1);
+}
+// --------------------------------------------------------------------------------
+
+void test_equal_strings_nominal(void **state) {
+    string_t* str1 = init_string("hello world");
+    string_t* str2 = init_string("hello world");
+    string_t* str3 = init_string("hello");
+    
+    assert_true(equal_strings(str1, str2));
+    assert_true(equal_strings(str1, "hello world"));
+    assert_false(equal_strings(str1, str3));
+    assert_false(equal_strings(str3, "hellO"));
+    
+    free_string(str1);
+    free_string(str2);
+    free_string(str3);
+}
+// --------------------------------------------------------------------------------
+
+void test_equal_strings_null(void **state) {
+    string_t* str = init_string("hello");
+    
+    errno = 0;
+    assert_false(equal_strings(str, NULL));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_false(equal_strings_lit(NULL, "hello"));
+    assert_int_equal(errno, EINVAL);
+    
+    free_string(str);
+}
+// --------------------------------------------------------------------------------
 /* Test cases for copy_string and reserve_string */
 void test_copy_string_nominal(void **state) {
     string_t* str1 = init_string("hello world");
@@ -1819,6 +2057,224 @@ void test_tokenize_empty_delimiter(void **state) {
    free_str_vector(tokens);
    free_string(str);
 }
+// --------------------------------------------------------------------------------
+
+static void _assert_csv_row(csv_reader_t* reader, size_t expected_count, 
+                            const char* const* expected) {
+    const csv_field_t* fields = NULL;
+    size_t count = 0;
+    assert_true(csv_next_row(reader, &fields, &count));
+    assert_int_equal(count, expected_count);
+    for (size_t i = 0; i < count; i++) {
+        assert_int_equal(fields[i].len, strlen(expected[i]));
+        assert_memory_equal(fields[i].str, expected[i], fields[i].len);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_csv_reader_quotes(void **state) {
+    const char* text = "id,name,note\r\n"
+                       "1,\"Smith, Jane\",\"said \"\"hi\"\"\"\n"
+                       "\n"
+                       "2,,\"two\nlines\"\n"
+                       "3,a\"b,\"\"\n"
+                       "4,,";
+    csv_reader_t* reader = init_csv_reader(text, strlen(text), ',');
+    assert_non_null(reader);
+    const char* row0[3] = {"id", "name", "note"};
+    const char* row1[3] = {"1", "Smith, Jane", "said \"hi\""};
+    const char* row2[3] = {"2", "", "two\nlines"};
+    const char* row3[3] = {"3", "a\"b", ""};
+    const char* row4[3] = {"4", "", ""};
+    _assert_csv_row(reader, 3, row0);
+    _assert_csv_row(reader, 3, row1);
+    _assert_csv_row(reader, 3, row2);
+    _assert_csv_row(reader, 3, row3);
+    _assert_csv_row(reader, 3, row4);
+    const csv_field_t* fields = NULL;
+    size_t count = 0;
+    errno = 0;
+    assert_false(csv_next_row(reader, &fields, &count));
+    assert_int_equal(errno, 0);
+    assert_int_equal(csv_reader_rows(reader), 5);
+    free_csv_reader(reader);
+
+    // Unescaped fields are views into the input
+    const char* tsv = "a\tb c\t\"d\"";
+    reader = init_csv_reader(tsv, strlen(tsv), '\t');
+    assert_true(csv_next_row(reader, &fields, &count));
+    assert_int_equal(count, 3);
+    assert_ptr_equal(fields[1].str, tsv + 2);
+    assert_int_equal(fields[1].len, 3);
+    assert_ptr_equal(fields[2].str, tsv + 7);
+    assert_int_equal(fields[2].len, 1);
+    free_csv_reader(reader);
+
+    // A final \r ends the row after a quoted field as it does after a plain one
+    const char* cr = "a,\"b\"\r";
+    const char* row5[2] = {"a", "b"};
+    reader = init_csv_reader(cr, strlen(cr), ',');
+    _assert_csv_row(reader, 2, row5);
+    errno = 0;
+    assert_false(csv_next_row(reader, &fields, &count));
+    assert_int_equal(errno, 0);
+    free_csv_reader(reader);
+}
+// --------------------------------------------------------------------------------
+
+void test_csv_reader_malformed(void **state) {
+    const csv_field_t* fields = NULL;
+    size_t count = 0;
+    char* bad[2] = {"a,\"open\nb,c\n", "a,\"x\"y,b\n"};
+    for (size_t i = 0; i < 2; i++) {
+        csv_reader_t* reader = init_csv_reader(bad[i], strlen(bad[i]), ',');
+        errno = 0;
+        assert_false(csv_next_row(reader, &fields, &count));
+        assert_int_equal(errno, EILSEQ);
+        assert_int_equal(csv_reader_rows(reader), 0);
+        free_csv_reader(reader);
+    }
+    errno = 0;
+    assert_null(init_csv_reader("a", 1, '"'));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_null(init_csv_stream(NULL, ','));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_null(open_csv_reader("no_such_file.csv", ','));
+    assert_int_equal(errno, ENOENT);
+}
+// --------------------------------------------------------------------------------
+
+void test_csv_reader_file_modes(void **state) {
+    // Rows with long quoted fields straddle the stream buffer refills
+    const char* path = "csv_reader_test.csv";
+    FILE* file = fopen(path, "wb");
+    assert_non_null(file);
+    char note[200];
+    memset(note, 'q', sizeof(note) - 1);
+    note[sizeof(note) - 1] = '\0';
+    for (int i = 0; i < 5000; i++) {
+        fprintf(file, "%d,\"%s,\"\"%d\"\"\",%d.5\r\n", i, note, i, i);
+    }
+    fclose(file);
+
+    for (int mode = 0; mode < 2; mode++) {
+        FILE* stream = NULL;
+        csv_reader_t* reader = NULL;
+        if (mode == 0) {
+            reader = open_csv_reader(path, ',');
+        } else {
+            stream = fopen(path, "rb");
+            reader = init_csv_stream(stream, ',');
+        }
+        assert_non_null(reader);
+        const csv_field_t* fields = NULL;
+        size_t count = 0;
+        char expected[256];
+        int row = 0;
+        errno = 0;
+        while (csv_next_row(reader, &fields, &count)) {
+            assert_int_equal(count, 3);
+            long long id = 0;
+            assert_int_equal(parse_int(fields[0].str, fields[0].len, &id), PARSE_OK);
+            assert_int_equal(id, row);
+            snprintf(expected, sizeof(expected), "%s,\"%d\"", note, row);
+            assert_int_equal(fields[1].len, strlen(expected));
+            assert_memory_equal(fields[1].str, expected, fields[1].len);
+            double value = 0.0;
+            assert_int_equal(parse_double(fields[2].str, fields[2].len, &value), PARSE_OK);
+            assert_true(value == row + 0.5);
+            row++;
+        }
+        assert_int_equal(errno, 0);
+        assert_int_equal(row, 5000);
+        free_csv_reader(reader);
+        if (stream) fclose(stream);
+    }
+
+    // Empty files have no rows
+    file = fopen(path, "wb");
+    fclose(file);
+    csv_reader_t* reader = open_csv_reader(path, ',');
+    assert_non_null(reader);
+    const csv_field_t* fields = NULL;
+    size_t count = 0;
+    assert_false(csv_next_row(reader, &fields, &count));
+    free_csv_reader(reader);
+    remove(path);
+}
+// --------------------------------------------------------------------------------
+
+void test_line_iter(void **state) {
+    string_t* str = init_string("first\r\nsecond\n\nlast");
+    line_iter_t iter = init_line_iter(str);
+    const char* expected[4] = {"first", "second", "", "last"};
+    const char* line = NULL;
+    size_t len = 0;
+    size_t count = 0;
+    while (line_iter_next(&iter, &line, &len)) {
+        assert_true(count < 4);
+        assert_int_equal(len, strlen(expected[count]));
+        assert_memory_equal(line, expected[count], len);
+        count++;
+    }
+    assert_int_equal(count, 4);
+    free_string(str);
+
+    // A trailing line break does not add an empty line
+    iter = init_line_iter_lit("a\nb\n", 4);
+    assert_true(line_iter_next(&iter, &line, &len));
+    assert_true(line_iter_next(&iter, &line, &len));
+    assert_int_equal(len, 1);
+    assert_memory_equal(line, "b", 1);
+    assert_false(line_iter_next(&iter, &line, &len));
+
+    iter = init_line_iter_lit("", 0);
+    assert_false(line_iter_next(&iter, &line, &len));
+    errno = 0;
+    iter = init_line_iter(NULL);
+    assert_int_equal(errno, EINVAL);
+    assert_false(line_iter_next(&iter, &line, &len));
+}
+// --------------------------------------------------------------------------------
+
+void test_read_line_string(void **state) {
+    const char* path = "read_line_test.txt";
+    FILE* file = fopen(path, "wb");
+    assert_non_null(file);
+    char long_line[1000];
+    memset(long_line, 'x', sizeof(long_line) - 1);
+    long_line[sizeof(long_line) - 1] = '\0';
+    fprintf(file, "alpha\r\n%s\n\nomega", long_line);
+    fclose(file);
+
+    file = fopen(path, "rb");
+    string_t* line = init_string("");
+    assert_true(read_line_string(line, file));
+    assert_string_equal(get_string(line), "alpha");
+    assert_int_equal(string_size(line), 5);
+    assert_true(read_line_string(line, file));
+    assert_string_equal(get_string(line), long_line);
+    assert_int_equal(string_size(line), sizeof(long_line) - 1);
+    size_t alloc = string_alloc(line);
+    assert_true(read_line_string(line, file));
+    assert_int_equal(string_size(line), 0);
+    assert_true(read_line_string(line, file));
+    assert_string_equal(get_string(line), "omega");
+    // Shorter lines reuse the buffer
+    assert_int_equal(string_alloc(line), alloc);
+    errno = 0;
+    assert_false(read_line_string(line, file));
+    assert_int_equal(errno, 0);
+    assert_int_equal(string_size(line), 0);
+    errno = 0;
+    assert_false(read_line_string(line, NULL));
+    assert_int_equal(errno, EINVAL);
+    fclose(file);
+    free_string(line);
+    remove(path);
+}
 // ================================================================================ 
 // ================================================================================ 
 // TEST DICTIONARY 
@@ -1826,7 +2282,7 @@ void test_tokenize_empty_delimiter(void **state) {
 void test_init_dictionary(void **state) {
     dict_t* dict = init_dict();
     assert_int_equal(s_size(dict), 0);
-    assert_int_equal(s_alloc(dict), 3);
+    assert_int_equal(s_alloc(dict), 4);
     assert_int_equal(dict_hash_size(dict), 0);
     free_dict(dict);
 }
@@ -1838,7 +2294,7 @@ void test_insert_dictionary(void **state) {
     insert_dict(dict, "Two", 2);
     insert_dict(dict, "Three", 3);
     assert_int_equal(s_size(dict), 3);
-    assert_int_equal(s_alloc(dict), 3);
+    assert_int_equal(s_alloc(dict), 4);
     assert_int_equal(dict_hash_size(dict), 3);
     assert_int_equal(1, get_dict_value(dict, "One"));
     assert_int_equal(2, get_dict_value(dict, "Two"));
@@ -1855,8 +2311,8 @@ void test_pop_dictionary(void **state) {
     float value = pop_dict(dict, "Three");
     assert_float_equal(3, value, 1.0e-3);
     assert_int_equal(s_size(dict), 2);
-    assert_int_equal(s_alloc(dict), 3);
-    assert_int_equal(dict_hash_size(dict), 3);
+    assert_int_equal(s_alloc(dict), 4);
+    assert_int_equal(dict_hash_size(dict), 2);
     assert_int_equal(1, get_dict_value(dict, "One"));
     assert_int_equal(2, get_dict_value(dict, "Two"));
     // Backup original stderr
@@ -1883,7 +2339,7 @@ void test_pop_dictionary(void **state) {
         insert_dict(dict, "Two", 2);
         insert_dict(dict, "Three", 3);
         assert_int_equal(s_size(dict), 3);
-        assert_int_equal(s_alloc(dict), 3);
+        assert_int_equal(s_alloc(dict), 4);
         assert_int_equal(dict_hash_size(dict), 3);
         assert_int_equal(1, get_dict_value(dict, "One"));
         assert_int_equal(2, get_dict_value(dict, "Two"));
@@ -1899,7 +2355,7 @@ void test_update_dictionary(void **state) {
     insert_dict(dict, "Three", 3);
     update_dict(dict, "Three", 4);
     assert_int_equal(s_size(dict), 3);
-    assert_int_equal(s_alloc(dict), 3);
+    assert_int_equal(s_alloc(dict), 4);
     assert_int_equal(dict_hash_size(dict), 3);
     assert_int_equal(1, get_dict_value(dict, "One"));
     assert_int_equal(2, get_dict_value(dict, "Two"));
@@ -1929,7 +2385,7 @@ void test_update_dictionary_error(void **state) {
     stderr = original_stderr;
 
     assert_int_equal(s_size(dict), 3);
-    assert_int_equal(s_alloc(dict), 3);
+    assert_int_equal(s_alloc(dict), 4);
     assert_int_equal(dict_hash_size(dict), 3);
     assert_int_equal(1, get_dict_value(dict, "One"));
     assert_int_equal(2, get_dict_value(dict, "Two"));
@@ -2118,5 +2574,1211 @@ void test_count_words_consecutive_delimiters(void **state) {
    free_string(str);
 }
 // ================================================================================
+
+void test_intern_string_nominal(void **state) {
+    intern_pool_t* pool = init_intern_pool();
+    assert_non_null(pool);
+    
+    const string_t* one = intern_string(pool, "hello");
+    const string_t* two = intern_string(pool, "world");
+    const string_t* three = intern_string(pool, "hello");
+    
+    assert_non_null(one);
+    assert_non_null(two);
+    assert_ptr_equal(one, three);
+    assert_ptr_not_equal(one, two);
+    assert_string_equal(get_string(one), "hello");
+    assert_int_equal(string_size(two), 5);
+    assert_int_equal(intern_pool_size(pool), 2);
+    
+    assert_ptr_equal(intern_lookup(pool, "world"), two);
+    assert_null(intern_lookup(pool, "missing"));
+    
+    free_intern_pool(pool);
+}
+// --------------------------------------------------------------------------------
+
+void test_intern_string_growth(void **state) {
+    intern_pool_t* pool = init_intern_pool();
+    const string_t* handles[200];
+    char buffer[16];
+    
+    for (size_t i = 0; i < 200; i++) {
+        snprintf(buffer, sizeof(buffer), "key%zu", i);
+        handles[i] = intern_string(pool, buffer);
+        assert_non_null(handles[i]);
+    }
+    // Handles remain stable after the pool has resized
+    for (size_t i = 0; i < 200; i++) {
+        snprintf(buffer, sizeof(buffer), "key%zu", i);
+        assert_ptr_equal(intern_string(pool, buffer), handles[i]);
+    }
+    assert_int_equal(intern_pool_size(pool), 200);
+    
+    free_intern_pool(pool);
+}
+// --------------------------------------------------------------------------------
+
+void test_intern_string_null(void **state) {
+    errno = 0;
+    assert_null(intern_string(NULL, "hello"));
+    assert_int_equal(errno, EINVAL);
+    
+    intern_pool_t* pool = init_intern_pool();
+    errno = 0;
+    assert_null(intern_string(pool, NULL));
+    assert_int_equal(errno, EINVAL);
+    free_intern_pool(pool);
+}
+// --------------------------------------------------------------------------------
+
+void test_insert_dict_interned(void **state) {
+    intern_pool_t* pool = init_intern_pool();
+    dict_t* dict = init_dict();
+    
+    const string_t* key = intern_string(pool, "apple");
+    assert_true(insert_dict_interned(dict, key, 3));
+    assert_false(insert_dict_interned(dict, key, 4));
+    assert_false(insert_dict(dict, "apple", 4));
+    assert_int_equal(get_dict_value(dict, "apple"), 3);
+    assert_true(update_dict(dict, "apple", 5));
+    assert_int_equal(pop_dict(dict, "apple"), 5);
+    assert_int_equal(dict_size(dict), 0);
+    
+    // The pool still owns the key after the dictionary released it
+    assert_string_equal(get_string(key), "apple");
+    
+    free_dict(dict);
+    free_intern_pool(pool);
+}
+// --------------------------------------------------------------------------------
+
+void test_push_back_interned_str_vector(void **state) {
+    intern_pool_t* pool = init_intern_pool();
+    string_v* vec = init_str_vector(1);
+    
+    const string_t* key = intern_string(pool, "repeat");
+    for (size_t i = 0; i < 5; i++) {
+        assert_true(push_back_interned_str_vector(vec, key));
+    }
+    assert_true(push_back_str_vector(vec, "owned"));
+    assert_int_equal(str_vector_size(vec), 6);
+    assert_ptr_equal(get_string(str_vector_index(vec, 0)), 
+                     get_string(str_vector_index(vec, 4)));
+    
+    string_t* popped = pop_front_str_vector(vec);
+    assert_string_equal(get_string(popped), "repeat");
+    free_string(popped);
+    assert_true(delete_back_str_vector(vec));
+    assert_true(delete_front_str_vector(vec));
+    
+    free_str_vector(vec);
+    assert_string_equal(get_string(key), "repeat");
+    free_intern_pool(pool);
+}
+// --------------------------------------------------------------------------------
+
+void test_string_hash_cached(void **state) {
+    string_t* one = init_string("hello");
+    string_t* two = init_string("hello");
+    
+    size_t hash = string_hash(one);
+    assert_int_equal(hash, string_hash(one));
+    assert_int_equal(hash, string_hash(two));
+    
+    // Mutation invalidates the cached value
+    string_concat(one, " world");
+    string_t* three = init_string("hello world");
+    assert_int_equal(string_hash(one), string_hash(three));
+    assert_int_not_equal(string_hash(one), hash);
+    
+    to_uppercase(three);
+    assert_int_not_equal(string_hash(one), string_hash(three));
+    
+    free_string(one);
+    free_string(two);
+    free_string(three);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_string_keys(void **state) {
+    dict_t* dict = init_dict();
+    string_t* key = init_string("apple");
+    string_t* other = init_string("pear");
+    
+    assert_true(insert_dict_string(dict, key, 1));
+    assert_false(insert_dict_string(dict, key, 2));
+    assert_true(is_key_value_string(dict, key));
+    assert_false(is_key_value_string(dict, other));
+    assert_true(is_key_value(dict, "apple"));
+    
+    assert_true(update_dict_string(dict, key, 7));
+    assert_int_equal(get_dict_value_string(dict, key), 7);
+    assert_int_equal(get_dict_value(dict, "apple"), 7);
+    assert_false(update_dict_string(dict, other, 3));
+    
+    assert_int_equal(pop_dict_string(dict, key), 7);
+    assert_int_equal(pop_dict_string(dict, key), LONG_MAX);
+    assert_int_equal(dict_size(dict), 0);
+    
+    free_string(key);
+    free_string(other);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_string_keys_null(void **state) {
+    dict_t* dict = init_dict();
+    
+    errno = 0;
+    assert_false(insert_dict_string(dict, NULL, 1));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_false(is_key_value_string(NULL, NULL));
+    assert_int_equal(errno, EINVAL);
+    
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_power_of_two_growth(void **state) {
+    dict_t* dict = init_dict();
+    char key[80];
+    
+    // Key lengths cover every branch of the hash, from 0 to 70 bytes
+    for (size_t i = 0; i < 500; i++) {
+        size_t len = snprintf(key, sizeof(key), "%zu", i);
+        memset(key + len, 'k', i % 64);
+        key[len + i % 64] = '\0';
+        assert_true(insert_dict(dict, key, i));
+    }
+    assert_true(insert_dict(dict, "", 500));
+    size_t alloc = dict_alloc(dict);
+    assert_int_equal(alloc & (alloc - 1), 0);
+    assert_int_equal(dict_size(dict), 501);
+    
+    for (size_t i = 0; i < 500; i++) {
+        size_t len = snprintf(key, sizeof(key), "%zu", i);
+        memset(key + len, 'k', i % 64);
+        key[len + i % 64] = '\0';
+        assert_int_equal(get_dict_value(dict, key), i);
+    }
+    assert_int_equal(get_dict_value(dict, ""), 500);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_secure_hash(void **state) {
+    const unsigned char secret[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    dict_t* dict = init_dict_hash(SECURE_HASH, secret);
+    assert_non_null(dict);
+    string_t* key = init_string("string key");
+    char buffer[16];
+    
+    for (size_t i = 0; i < 100; i++) {
+        snprintf(buffer, sizeof(buffer), "key%zu", i);
+        assert_true(insert_dict(dict, buffer, i));
+    }
+    assert_true(insert_dict_string(dict, key, 100));
+    assert_true(is_key_value(dict, "string key"));
+    assert_true(update_dict(dict, "key42", 420));
+    assert_int_equal(get_dict_value(dict, "key42"), 420);
+    assert_int_equal(get_dict_value_string(dict, key), 100);
+    assert_int_equal(pop_dict(dict, "key7"), 7);
+    assert_false(is_key_value(dict, "key7"));
+    assert_int_equal(dict_size(dict), 100);
+    
+    free_string(key);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_hash_invalid(void **state) {
+    errno = 0;
+    assert_null(init_dict_hash(SECURE_HASH, NULL));
+    assert_int_equal(errno, EINVAL);
+    
+    dict_t* dict = init_dict_hash(FAST_HASH, NULL);
+    assert_non_null(dict);
+    assert_int_equal(dict_alloc(dict), 4);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_recycle_nodes(void **state) {
+    dict_t* dict = init_dict();
+    char key[32];
+    
+    for (size_t i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "w%zu", i);
+        assert_true(insert_dict(dict, key, i));
+    }
+    for (size_t i = 0; i < 1000; i += 2) {
+        snprintf(key, sizeof(key), "w%zu", i);
+        assert_int_equal(pop_dict(dict, key), i);
+    }
+    // Reinserted keys reuse popped nodes, some need more key storage
+    for (size_t i = 0; i < 1000; i += 2) {
+        snprintf(key, sizeof(key), "%s%zu", i % 4 ? "longer_word_" : "v", i);
+        assert_true(insert_dict(dict, key, i + 1));
+    }
+    assert_int_equal(dict_size(dict), 1000);
+    for (size_t i = 0; i < 1000; i++) {
+        if (i % 2) {
+            snprintf(key, sizeof(key), "w%zu", i);
+            assert_int_equal(get_dict_value(dict, key), i);
+        } else {
+            snprintf(key, sizeof(key), "%s%zu", i % 4 ? "longer_word_" : "v", i);
+            assert_int_equal(get_dict_value(dict, key), i + 1);
+        }
+    }
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_oversized_key(void **state) {
+    dict_t* dict = init_dict();
+    size_t len = 200 * 1024;
+    char* big = malloc(len + 1);
+    memset(big, 'a', len);
+    big[len] = '\0';
+    
+    assert_true(insert_dict(dict, "small", 1));
+    assert_true(insert_dict(dict, big, 2));
+    assert_true(insert_dict(dict, "after", 3));
+    assert_int_equal(get_dict_value(dict, big), 2);
+    assert_int_equal(get_dict_value(dict, "small"), 1);
+    assert_int_equal(get_dict_value(dict, "after"), 3);
+    
+    free(big);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_incremental_resize(void **state) {
+    dict_t* dict = init_dict();
+    char key[32];
+    assert_true(set_dict_incremental(dict, true));
+    
+    bool saw_rehash = false;
+    for (size_t i = 0; i < 2000; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        assert_true(insert_dict(dict, key, i));
+        saw_rehash |= dict_is_rehashing(dict);
+        // Every key stays reachable while the tables are split
+        if (i % 97 == 0) {
+            for (size_t j = 0; j <= i; j += 13) {
+                snprintf(key, sizeof(key), "key%zu", j);
+                assert_int_equal(get_dict_value(dict, key), j);
+            }
+        }
+    }
+    assert_true(saw_rehash);
+    assert_int_equal(dict_size(dict), 2000);
+    
+    string_v* keys = get_dict_keys(dict);
+    assert_int_equal(str_vector_size(keys), 2000);
+    free_str_vector(keys);
+    
+    for (size_t i = 0; i < 2000; i += 2) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        assert_int_equal(pop_dict(dict, key), i);
+    }
+    for (size_t i = 1; i < 2000; i += 2) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        assert_true(update_dict(dict, key, i * 2));
+        assert_int_equal(get_dict_value(dict, key), i * 2);
+    }
+    assert_false(dict_is_rehashing(dict));
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_incremental_disable(void **state) {
+    dict_t* dict = init_dict();
+    char key[32];
+    assert_true(set_dict_incremental(dict, true));
+    
+    // Stop inserting as soon as a migration is in flight
+    size_t count = 0;
+    do {
+        snprintf(key, sizeof(key), "key%zu", count);
+        assert_true(insert_dict(dict, key, count));
+        count++;
+    } while (!dict_is_rehashing(dict));
+    
+    assert_true(set_dict_incremental(dict, false));
+    assert_false(dict_is_rehashing(dict));
+    for (size_t i = 0; i < count; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        assert_int_equal(get_dict_value(dict, key), i);
+    }
+    
+    errno = 0;
+    assert_false(set_dict_incremental(NULL, true));
+    assert_int_equal(errno, EINVAL);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_shrink_on_pop(void **state) {
+    char key[32];
+    // Shrinking must work for both resize modes
+    for (int incremental = 0; incremental < 2; incremental++) {
+        dict_t* dict = init_dict();
+        assert_true(set_dict_incremental(dict, incremental));
+        for (size_t i = 0; i < 4096; i++) {
+            snprintf(key, sizeof(key), "key%zu", i);
+            assert_true(insert_dict(dict, key, i));
+        }
+        size_t grown = dict_alloc(dict);
+        assert_int_equal(dict_hash_size(dict), 4096);
+        
+        for (size_t i = 0; i < 4090; i++) {
+            snprintf(key, sizeof(key), "key%zu", i);
+            assert_int_equal(pop_dict(dict, key), i);
+        }
+        // Occupancy follows pops and the drained table is released
+        assert_int_equal(dict_hash_size(dict), 6);
+        assert_true(dict_alloc(dict) < grown);
+        for (size_t i = 4090; i < 4096; i++) {
+            snprintf(key, sizeof(key), "key%zu", i);
+            assert_int_equal(get_dict_value(dict, key), i);
+        }
+        free_dict(dict);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_reserve_shrink(void **state) {
+    dict_t* dict = init_dict();
+    char key[32];
+    assert_true(reserve_dict(dict, 1000));
+    size_t reserved = dict_alloc(dict);
+    assert_true(1000 < reserved * 0.7);
+    
+    // A reserved table takes its keys without resizing
+    for (size_t i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        assert_true(insert_dict(dict, key, i));
+    }
+    assert_int_equal(dict_alloc(dict), reserved);
+    
+    // Reserving less than the current size never shrinks
+    assert_true(reserve_dict(dict, 10));
+    assert_int_equal(dict_alloc(dict), reserved);
+    
+    for (size_t i = 0; i < 900; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        pop_dict(dict, key);
+    }
+    assert_true(shrink_dict(dict));
+    assert_int_equal(dict_alloc(dict), 256);
+    assert_true(dict_load_factor(dict) < 0.7);
+    for (size_t i = 900; i < 1000; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        assert_int_equal(get_dict_value(dict, key), i);
+    }
+    
+    errno = 0;
+    assert_false(reserve_dict(NULL, 10));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_false(shrink_dict(NULL));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_true(dict_load_factor(NULL) < 0.0);
+    assert_int_equal(errno, EINVAL);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_concurrent_dict_nominal(void **state) {
+    concurrent_dict_t* dict = init_concurrent_dict(0);
+    assert_non_null(dict);
+    assert_true(insert_concurrent_dict(dict, "one", 1));
+    assert_false(insert_concurrent_dict(dict, "one", 5));
+    assert_int_equal(increment_concurrent_dict(dict, "one", 2), 3);
+    assert_int_equal(increment_concurrent_dict(dict, "two", 4), 4);
+    assert_int_equal(get_concurrent_dict_value(dict, "two"), 4);
+    assert_int_equal(get_concurrent_dict_value(dict, "three"), LONG_MAX);
+    assert_int_equal(concurrent_dict_size(dict), 2);
+    assert_int_equal(pop_concurrent_dict(dict, "one"), 3);
+    assert_int_equal(pop_concurrent_dict(dict, "one"), LONG_MAX);
+    assert_int_equal(concurrent_dict_size(dict), 1);
+    
+    // Counts beyond float precision stay exact
+    assert_int_equal(increment_concurrent_dict(dict, "big", 16777217), 16777217);
+    
+    errno = 0;
+    assert_int_equal(increment_concurrent_dict(NULL, "one", 1), LONG_MAX);
+    assert_int_equal(errno, EINVAL);
+    free_concurrent_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_snapshot_dict_nominal(void **state) {
+    dict_t* first = init_dict();
+    insert_dict(first, "route", 1);
+    snapshot_dict_t* snap = init_snapshot_dict(first);
+    snapshot_reader_t* reader = register_snapshot_reader(snap);
+    assert_non_null(reader);
+    assert_int_equal(get_snapshot_dict_value(reader, "route"), 1);
+    assert_int_equal(get_snapshot_dict_value(reader, "missing"), LONG_MAX);
+    
+    dict_t* second = init_dict();
+    insert_dict(second, "route", 2);
+    insert_dict(second, "other", 3);
+    assert_true(publish_snapshot_dict(snap, second));
+    assert_int_equal(get_snapshot_dict_value(reader, "route"), 2);
+    assert_int_equal(get_snapshot_dict_value(reader, "other"), 3);
+    
+    // Republishing the live snapshot would free it under the readers
+    errno = 0;
+    assert_false(publish_snapshot_dict(snap, second));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_int_equal(get_snapshot_dict_value(NULL, "route"), LONG_MAX);
+    assert_int_equal(errno, EINVAL);
+    
+    unregister_snapshot_reader(reader);
+    free_snapshot_dict(snap);
+}
+// --------------------------------------------------------------------------------
+
+void test_snapshot_dict_empty(void **state) {
+    snapshot_dict_t* snap = init_snapshot_dict(NULL);
+    snapshot_reader_t* reader = register_snapshot_reader(snap);
+    assert_int_equal(get_snapshot_dict_value(reader, "route"), LONG_MAX);
+    errno = 0;
+    assert_false(publish_snapshot_dict(snap, NULL));
+    assert_int_equal(errno, EINVAL);
+    // Readers still registered are released with the dictionary
+    free_snapshot_dict(snap);
+}
+// --------------------------------------------------------------------------------
+
+void test_freeze_dict_nominal(void **state) {
+    dict_t* dict = init_dict();
+    char key[32];
+    for (size_t i = 0; i < 10000; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        assert_true(insert_dict(dict, key, i * 3));
+    }
+    frozen_dict_t* frozen = freeze_dict(dict);
+    free_dict(dict);
+    assert_non_null(frozen);
+    assert_int_equal(frozen_dict_size(frozen), 10000);
+    for (size_t i = 0; i < 10000; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        assert_int_equal(get_frozen_dict_value(frozen, key), i * 3);
+        assert_true(is_frozen_key_value(frozen, key));
+    }
+    // Missing keys land on some slot and fail the key compare
+    for (size_t i = 10000; i < 11000; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        assert_false(is_frozen_key_value(frozen, key));
+        assert_int_equal(get_frozen_dict_value(frozen, key), LONG_MAX);
+    }
+    assert_false(is_frozen_key_value(frozen, ""));
+    free_frozen_dict(frozen);
+}
+// --------------------------------------------------------------------------------
+
+void test_freeze_dict_small(void **state) {
+    dict_t* dict = init_dict();
+    frozen_dict_t* frozen = freeze_dict(dict);
+    assert_int_equal(frozen_dict_size(frozen), 0);
+    assert_false(is_frozen_key_value(frozen, "the"));
+    free_frozen_dict(frozen);
+    
+    // Freezing mid-migration picks up keys from both tables
+    set_dict_incremental(dict, true);
+    const char* words[] = {"the", "a", "an", "of", "and", "or", "to", "in"};
+    for (size_t i = 0; i < 8; i++) {
+        insert_dict(dict, words[i], i);
+    }
+    frozen = freeze_dict(dict);
+    assert_int_equal(frozen_dict_size(frozen), 8);
+    for (size_t i = 0; i < 8; i++) {
+        assert_int_equal(get_frozen_dict_value(frozen, words[i]), i);
+    }
+    free_frozen_dict(frozen);
+    free_dict(dict);
+    
+    errno = 0;
+    assert_null(freeze_dict(NULL));
+    assert_int_equal(errno, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_iter_nominal(void **state) {
+    dict_t* dict = init_dict();
+    char key[32];
+    for (size_t i = 0; i < 500; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        insert_dict(dict, key, i);
+    }
+    dict_iter_t iter = init_dict_iter(dict);
+    const char* k;
+    size_t len, value, count = 0, total = 0;
+    while (dict_iter_next(&iter, &k, &len, &value)) {
+        assert_int_equal(strlen(k), len);
+        assert_int_equal(get_dict_value(dict, (char*)k), value);
+        total += value;
+        count++;
+    }
+    assert_int_equal(count, 500);
+    assert_int_equal(total, 499 * 500 / 2);
+    // An exhausted cursor stays exhausted
+    assert_false(dict_iter_next(&iter, NULL, NULL, NULL));
+    
+    errno = 0;
+    assert_false(dict_iter_next(NULL, &k, &len, &value));
+    assert_int_equal(errno, EINVAL);
+    iter = init_dict_iter(NULL);
+    assert_false(dict_iter_next(&iter, &k, &len, &value));
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_iter_ordered(void **state) {
+    dict_t* dict = init_dict();
+    char key[32];
+    assert_true(set_dict_ordered(dict, true));
+    for (size_t i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        insert_dict(dict, key, i);
+    }
+    // Pop enough keys to force the order array to compact
+    for (size_t i = 0; i < 1000; i++) {
+        if (i % 3 != 0) {
+            snprintf(key, sizeof(key), "key%zu", i);
+            pop_dict(dict, key);
+        }
+    }
+    insert_dict(dict, "last", 5000);
+    
+    dict_iter_t iter = init_dict_iter(dict);
+    const char* k;
+    size_t value, expected = 0;
+    while (dict_iter_next(&iter, &k, NULL, &value)) {
+        if (expected < 1000) {
+            assert_int_equal(value, expected);
+            snprintf(key, sizeof(key), "key%zu", expected);
+            assert_string_equal(k, key);
+            expected += 3;
+        } else {
+            assert_string_equal(k, "last");
+            expected = 5000;
+        }
+    }
+    assert_int_equal(expected, 5000);
+    
+    string_v* keys = get_dict_keys(dict);
+    assert_string_equal(get_string(str_vector_index(keys, 0)), "key0");
+    assert_string_equal(get_string(str_vector_index(keys, 1)), "key3");
+    free_str_vector(keys);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_set_ordered_existing(void **state) {
+    dict_t* dict = init_dict();
+    insert_dict(dict, "a", 1);
+    insert_dict(dict, "b", 2);
+    assert_true(set_dict_ordered(dict, true));
+    insert_dict(dict, "c", 3);
+    
+    // Existing keys come first, then later inserts in order
+    dict_iter_t iter = init_dict_iter(dict);
+    const char* k;
+    size_t count = 0;
+    while (dict_iter_next(&iter, &k, NULL, NULL)) {
+        count++;
+        if (count == 3) assert_string_equal(k, "c");
+    }
+    assert_int_equal(count, 3);
+    
+    assert_true(set_dict_ordered(dict, false));
+    assert_int_equal(pop_dict(dict, "a"), 1);
+    errno = 0;
+    assert_false(set_dict_ordered(NULL, true));
+    assert_int_equal(errno, EINVAL);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_top_k(void **state) {
+    dict_t* dict = init_dict();
+    char key[32];
+    // Value i * 7 % 1009 is a permutation of 0..1008
+    for (size_t i = 0; i < 1009; i++) {
+        snprintf(key, sizeof(key), "key%zu", i);
+        insert_dict(dict, key, i * 7 % 1009);
+    }
+    dict_entry_t top[10];
+    assert_int_equal(dict_top_k(dict, 10, top), 10);
+    for (size_t i = 0; i < 10; i++) {
+        assert_int_equal(top[i].value, 1008 - i);
+        assert_int_equal(get_dict_value(dict, (char*)top[i].key), top[i].value);
+        assert_int_equal(strlen(top[i].key), top[i].key_len);
+    }
+    // Asking for more than the dict holds returns everything, sorted
+    dict_entry_t* all = malloc(2000 * sizeof(dict_entry_t));
+    assert_int_equal(dict_top_k(dict, 2000, all), 1009);
+    for (size_t i = 1; i < 1009; i++) {
+        assert_true(all[i - 1].value > all[i].value);
+    }
+    free(all);
+    assert_int_equal(dict_top_k(dict, 0, NULL), 0);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_top_k_count_words(void **state) {
+    string_t* text = init_string("b a c a b a d a c");
+    dict_t* counts = count_words(text, " ");
+    dict_entry_t top[3];
+    assert_int_equal(dict_top_k(counts, 3, top), 3);
+    assert_string_equal(top[0].key, "a");
+    assert_int_equal(top[0].value, 4);
+    // b and c tie on 2 and are ordered by key
+    assert_string_equal(top[1].key, "b");
+    assert_string_equal(top[2].key, "c");
+    
+    errno = 0;
+    assert_int_equal(dict_top_k(NULL, 3, top), LONG_MAX);
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_int_equal(dict_top_k(counts, 3, NULL), LONG_MAX);
+    assert_int_equal(errno, EINVAL);
+    free_dict(counts);
+    free_string(text);
+}
+// --------------------------------------------------------------------------------
+
+static void _feed_skewed(word_sketch_t* sketch, size_t part, size_t parts) {
+    // word i occurs 200 - i times, buried among 5000 words seen once
+    char word[32];
+    size_t n = 0;
+    for (size_t i = 0; i < 200; i++) {
+        for (size_t c = 0; c < 200 - i; c++) {
+            if (n++ % parts == part) {
+                snprintf(word, sizeof(word), "word%zu", i);
+                assert_true(add_word_sketch(sketch, word, 1));
+            }
+        }
+    }
+    for (size_t i = 0; i < 5000; i++) {
+        if (n++ % parts == part) {
+            snprintf(word, sizeof(word), "rare%zu", i);
+            assert_true(add_word_sketch(sketch, word, 1));
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_word_sketch_heavy_hitters(void **state) {
+    word_sketch_t* sketch = init_word_sketch(0.001, 0.01, 50);
+    _feed_skewed(sketch, 0, 1);
+    size_t total = word_sketch_total(sketch);
+    assert_int_equal(total, 200 * 201 / 2 + 5000);
+    
+    dict_entry_t top[10];
+    assert_int_equal(word_sketch_top_k(sketch, 10, top), 10);
+    char word[32];
+    for (size_t i = 0; i < 10; i++) {
+        snprintf(word, sizeof(word), "word%zu", i);
+        assert_string_equal(top[i].key, word);
+        assert_true(top[i].value >= 200 - i);
+        assert_true(top[i].value <= 200 - i + total / 1000);
+    }
+    // Estimates never undercount
+    assert_true(word_sketch_estimate(sketch, "word150") >= 50);
+    assert_true(word_sketch_estimate(sketch, "rare42") >= 1);
+    free_word_sketch(sketch);
+}
+// --------------------------------------------------------------------------------
+
+void test_word_sketch_merge(void **state) {
+    word_sketch_t* a = init_word_sketch(0.001, 0.01, 50);
+    word_sketch_t* b = init_word_sketch(0.001, 0.01, 50);
+    _feed_skewed(a, 0, 2);
+    _feed_skewed(b, 1, 2);
+    assert_true(merge_word_sketch(a, b));
+    assert_int_equal(word_sketch_total(a), 200 * 201 / 2 + 5000);
+    
+    dict_entry_t top[5];
+    assert_int_equal(word_sketch_top_k(a, 5, top), 5);
+    char word[32];
+    for (size_t i = 0; i < 5; i++) {
+        snprintf(word, sizeof(word), "word%zu", i);
+        assert_string_equal(top[i].key, word);
+        assert_true(top[i].value >= 200 - i);
+    }
+    // Only sketches of equal dimensions can merge
+    word_sketch_t* c = init_word_sketch(0.1, 0.01, 50);
+    errno = 0;
+    assert_false(merge_word_sketch(a, c));
+    assert_int_equal(errno, EINVAL);
+    free_word_sketch(a);
+    free_word_sketch(b);
+    free_word_sketch(c);
+}
+// --------------------------------------------------------------------------------
+
+void test_count_words_sketch(void **state) {
+    string_t* text = init_string("the cat and the dog and the bird");
+    word_sketch_t* sketch = init_word_sketch(0.01, 0.01, 2);
+    assert_true(count_words_sketch(sketch, text, " "));
+    assert_int_equal(word_sketch_total(sketch), 8);
+    assert_true(word_sketch_estimate(sketch, "the") >= 3);
+    
+    dict_entry_t top[2];
+    assert_int_equal(word_sketch_top_k(sketch, 2, top), 2);
+    assert_string_equal(top[0].key, "the");
+    assert_int_equal(top[0].value, 3);
+    
+    errno = 0;
+    assert_null(init_word_sketch(0.0, 0.01, 10));
+    assert_int_equal(errno, EINVAL);
+    // Widths that cannot be represented or allocated are rejected up front
+    errno = 0;
+    assert_null(init_word_sketch(1e-20, 0.01, 10));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_null(init_word_sketch(1e-18, 0.01, 10));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_false(count_words_sketch(sketch, NULL, " "));
+    assert_int_equal(errno, EINVAL);
+    free_word_sketch(sketch);
+    free_string(text);
+}
+// --------------------------------------------------------------------------------
+
+void test_hll_estimate(void **state) {
+    hll_t* hll = init_hll(14);
+    char token[32];
+    for (size_t i = 0; i < 100000; i++) {
+        snprintf(token, sizeof(token), "token%zu", i);
+        assert_true(add_hll(hll, token));
+        // Repeats never change the estimate
+        assert_true(add_hll(hll, "token0"));
+    }
+    size_t estimate = hll_estimate(hll);
+    assert_true(estimate > 97000 && estimate < 103000);
+    free_hll(hll);
+    
+    hll = init_hll(14);
+    assert_int_equal(hll_estimate(hll), 0);
+    string_t* text = init_string("a b c a b c d, e");
+    assert_true(add_hll_string(hll, text, " ,"));
+    assert_int_equal(hll_estimate(hll), 5);
+    
+    string_v* vec = init_str_vector(4);
+    push_back_str_vector(vec, "a");
+    push_back_str_vector(vec, "f");
+    assert_true(add_hll_vector(hll, vec));
+    assert_int_equal(hll_estimate(hll), 6);
+    
+    free_str_vector(vec);
+    free_string(text);
+    free_hll(hll);
+}
+// --------------------------------------------------------------------------------
+
+void test_hll_merge_serialize(void **state) {
+    hll_t* whole = init_hll(12);
+    hll_t* left = init_hll(12);
+    hll_t* right = init_hll(12);
+    char token[32];
+    for (size_t i = 0; i < 20000; i++) {
+        snprintf(token, sizeof(token), "t%zu", i);
+        add_hll(whole, token);
+        add_hll(i % 2 ? left : right, token);
+    }
+    // Ship one half through the wire format before merging
+    size_t size = hll_serialize(right, NULL, 0);
+    assert_int_equal(size, 5 + 4096);
+    unsigned char* buffer = malloc(size);
+    assert_int_equal(hll_serialize(right, buffer, size), size);
+    hll_t* copy = hll_deserialize(buffer, size);
+    assert_non_null(copy);
+    assert_true(merge_hll(left, copy));
+    assert_int_equal(hll_estimate(left), hll_estimate(whole));
+    
+    // A merged estimator has exactly the registers of one fed everything
+    unsigned char* expected = malloc(size);
+    hll_serialize(whole, expected, size);
+    hll_serialize(left, buffer, size);
+    assert_memory_equal(buffer, expected, size);
+    
+    errno = 0;
+    assert_int_equal(hll_serialize(left, buffer, size - 1), LONG_MAX);
+    assert_int_equal(errno, ERANGE);
+    buffer[0] = 'X';
+    errno = 0;
+    assert_null(hll_deserialize(buffer, size));
+    assert_int_equal(errno, EINVAL);
+    hll_t* other = init_hll(10);
+    assert_false(merge_hll(left, other));
+    errno = 0;
+    assert_null(init_hll(3));
+    assert_int_equal(errno, EINVAL);
+    
+    free(buffer);
+    free(expected);
+    free_hll(other);
+    free_hll(copy);
+    free_hll(whole);
+    free_hll(left);
+    free_hll(right);
+}
+// --------------------------------------------------------------------------------
+
+void test_radix_tree_nominal(void **state) {
+    radix_tree_t* tree = init_radix_tree();
+    char* paths[6] = {"/api", "/api/v1", "/api/v1/users", "/api/v2/users", 
+                      "/static/img", "/"};
+    for (size_t i = 0; i < 6; i++) {
+        assert_true(insert_radix_tree(tree, paths[i], i));
+    }
+    assert_int_equal(radix_tree_size(tree), 6);
+    for (size_t i = 0; i < 6; i++) {
+        assert_int_equal(get_radix_tree_value(tree, paths[i]), i);
+    }
+    assert_int_equal(get_radix_tree_value(tree, "/api/v"), LONG_MAX);
+    assert_int_equal(get_radix_tree_value(tree, "/api/v1/users/7"), LONG_MAX);
+    assert_int_equal(get_radix_tree_value(tree, ""), LONG_MAX);
+    assert_false(is_radix_tree_key(tree, "/stat"));
+    
+    // Inserting an existing key replaces its value
+    assert_true(insert_radix_tree(tree, "/api/v1", 42));
+    assert_int_equal(radix_tree_size(tree), 6);
+    assert_int_equal(get_radix_tree_value(tree, "/api/v1"), 42);
+    
+    errno = 0;
+    assert_false(insert_radix_tree(NULL, "/x", 1));
+    assert_int_equal(errno, EINVAL);
+    free_radix_tree(tree);
+}
+// --------------------------------------------------------------------------------
+
+void test_radix_tree_prefix_queries(void **state) {
+    radix_tree_t* tree = init_radix_tree();
+    char* paths[7] = {"/api", "/api/v1", "/api/v1/users", "/api/v2/users", 
+                      "/static/img", "/static/images/large", "/static/imgs"};
+    for (size_t i = 0; i < 7; i++) {
+        insert_radix_tree(tree, paths[i], i);
+    }
+    string_v* scan = radix_tree_prefix_scan(tree, "/api/v");
+    assert_int_equal(s_size(scan), 3);
+    assert_string_equal("/api/v1", get_string(str_vector_index(scan, 0)));
+    assert_string_equal("/api/v1/users", get_string(str_vector_index(scan, 1)));
+    assert_string_equal("/api/v2/users", get_string(str_vector_index(scan, 2)));
+    free_str_vector(scan);
+    
+    // The prefix ends inside a compressed node prefix
+    scan = radix_tree_prefix_scan(tree, "/stat");
+    assert_int_equal(s_size(scan), 3);
+    assert_string_equal("/static/images/large", get_string(str_vector_index(scan, 0)));
+    free_str_vector(scan);
+    scan = radix_tree_prefix_scan(tree, "");
+    assert_int_equal(s_size(scan), 7);
+    assert_true(is_str_vector_sorted(scan));
+    free_str_vector(scan);
+    scan = radix_tree_prefix_scan(tree, "/apx");
+    assert_int_equal(s_size(scan), 0);
+    free_str_vector(scan);
+    
+    size_t len = 0;
+    assert_int_equal(radix_tree_longest_prefix(tree, "/api/v1/users/42", &len), 2);
+    assert_int_equal(len, 13);
+    assert_int_equal(radix_tree_longest_prefix(tree, "/api/v1/items", &len), 1);
+    assert_int_equal(len, 7);
+    assert_int_equal(radix_tree_longest_prefix(tree, "/api/v3", &len), 0);
+    assert_int_equal(len, 4);
+    assert_int_equal(radix_tree_longest_prefix(tree, "/static/imgs", &len), 6);
+    assert_int_equal(radix_tree_longest_prefix(tree, "/static/im", &len), LONG_MAX);
+    assert_int_equal(len, 0);
+    assert_int_equal(radix_tree_longest_prefix(tree, "/ap", NULL), LONG_MAX);
+    free_radix_tree(tree);
+}
+// --------------------------------------------------------------------------------
+
+void test_radix_tree_node_growth(void **state) {
+    // 256 children below one node walk through every node size
+    radix_tree_t* tree = init_radix_tree();
+    char key[4] = {'k', 0, 'x', '\0'};
+    for (size_t b = 255; b >= 1; b--) {
+        key[1] = (char)b;
+        assert_true(insert_radix_tree(tree, key, b));
+        for (size_t c = 255; c >= b; c--) {
+            key[1] = (char)c;
+            assert_int_equal(get_radix_tree_value(tree, key), c);
+        }
+    }
+    assert_int_equal(radix_tree_size(tree), 255);
+    string_v* scan = radix_tree_prefix_scan(tree, "k");
+    assert_int_equal(s_size(scan), 255);
+    assert_true(is_str_vector_sorted(scan));
+    free_str_vector(scan);
+    free_radix_tree(tree);
+}
+// --------------------------------------------------------------------------------
+
+void test_build_radix_tree(void **state) {
+    // Random keys over a small alphabet give long shared prefixes and keys 
+    // that are prefixes of other keys
+    string_v* vec = init_str_vector(2000);
+    dict_t* dict = init_dict();
+    radix_tree_t* tree = init_radix_tree();
+    unsigned int seed = 7;
+    char key[32];
+    for (size_t i = 0; i < 2000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        size_t len = 1 + (seed >> 16) % 20;
+        for (size_t j = 0; j < len; j++) {
+            seed = seed * 1103515245u + 12345u;
+            key[j] = "ab/"[(seed >> 16) % 3];
+        }
+        key[len] = '\0';
+        push_back_str_vector(vec, key);
+        if (!is_key_value(dict, key)) {
+            insert_dict(dict, key, i);
+            insert_radix_tree(tree, key, i);
+        }
+    }
+    radix_tree_t* built = build_radix_tree(vec);
+    assert_non_null(built);
+    assert_int_equal(radix_tree_size(built), dict_size(dict));
+    assert_int_equal(radix_tree_size(tree), dict_size(dict));
+    for (size_t i = 0; i < 2000; i++) {
+        const char* k = get_string(str_vector_index(vec, i));
+        assert_int_equal(get_radix_tree_value(built, k), get_dict_value(dict, (char*)k));
+        assert_int_equal(get_radix_tree_value(tree, k), get_dict_value(dict, (char*)k));
+    }
+    
+    // Prefix scans agree with a prefix range over the sorted unique keys, and 
+    // a sorted vector takes the bulk build path
+    unique_str_vector(vec);
+    radix_tree_t* sorted = build_radix_tree(vec);
+    assert_int_equal(radix_tree_size(sorted), dict_size(dict));
+    for (size_t i = 0; i < s_size(vec); i++) {
+        assert_int_equal(get_radix_tree_value(sorted, get_string(str_vector_index(vec, i))), i);
+    }
+    char* prefixes[5] = {"a", "ab/", "b/b/a", "/", "aaaaaaaaaa"};
+    for (size_t p = 0; p < 5; p++) {
+        size_t first = 0;
+        size_t last = 0;
+        prefix_range_str_vector(vec, prefixes[p], false, &first, &last);
+        string_v* a = radix_tree_prefix_scan(built, prefixes[p]);
+        string_v* b = radix_tree_prefix_scan(tree, prefixes[p]);
+        string_v* c = radix_tree_prefix_scan(sorted, prefixes[p]);
+        assert_int_equal(s_size(a), last - first);
+        assert_int_equal(s_size(b), last - first);
+        assert_int_equal(s_size(c), last - first);
+        for (size_t i = 0; i < s_size(a); i++) {
+            const char* expected = get_string(str_vector_index(vec, first + i));
+            assert_string_equal(expected, get_string(str_vector_index(a, i)));
+            assert_string_equal(expected, get_string(str_vector_index(b, i)));
+            assert_string_equal(expected, get_string(str_vector_index(c, i)));
+        }
+        free_str_vector(a);
+        free_str_vector(b);
+        free_str_vector(c);
+    }
+    
+    string_v* empty = init_str_vector(1);
+    radix_tree_t* none = build_radix_tree(empty);
+    assert_int_equal(radix_tree_size(none), 0);
+    assert_int_equal(get_radix_tree_value(none, "a"), LONG_MAX);
+    errno = 0;
+    assert_null(build_radix_tree(NULL));
+    assert_int_equal(errno, EINVAL);
+    
+    free_radix_tree(none);
+    free_str_vector(empty);
+    free_radix_tree(sorted);
+    free_radix_tree(built);
+    free_radix_tree(tree);
+    free_dict(dict);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+void test_dict_image_round_trip(void **state) {
+    const char* path = "dict_image_test.bin";
+    dict_t* dict = init_dict();
+    char key[32];
+    for (size_t i = 0; i < 3000; i++) {
+        snprintf(key, sizeof(key), "image_key_%zu", i * 7);
+        insert_dict(dict, key, i);
+    }
+    assert_true(save_dict(dict, path));
+    dict_image_t* image = open_dict_image(path, true);
+    assert_non_null(image);
+    assert_int_equal(dict_image_size(image), 3000);
+    for (size_t i = 0; i < 3000; i++) {
+        snprintf(key, sizeof(key), "image_key_%zu", i * 7);
+        assert_int_equal(get_dict_image_value(image, key), i);
+        snprintf(key, sizeof(key), "image_key_%zu", i * 7 + 1);
+        assert_int_equal(get_dict_image_value(image, key), LONG_MAX);
+    }
+    assert_true(is_frozen_key_value(dict_image_frozen(image), "image_key_0"));
+    close_dict_image(image);
+
+    // A vector image is not a dict image
+    string_v* vec = init_str_vector(1);
+    push_back_str_vector(vec, "one");
+    assert_true(save_str_vector(vec, path));
+    errno = 0;
+    assert_null(open_dict_image(path, true));
+    assert_int_equal(errno, EINVAL);
+    free_str_vector(vec);
+
+    // A damaged slot that is not the last one is rejected without verify
+    dict_t* pair = init_dict();
+    insert_dict(pair, "one", 7);
+    insert_dict(pair, "two", 9);
+    assert_true(save_dict(pair, path));
+    FILE* file = fopen(path, "r+b");
+    assert_non_null(file);
+    unsigned char bytes[512];
+    size_t size = fread(bytes, 1, sizeof(bytes), file);
+    // The first slot holds offset 0 and key length 3
+    size_t first[2] = {0, 3};
+    size_t pos = 72;
+    while (pos + sizeof(first) <= size && memcmp(bytes + pos, first, sizeof(first)) != 0) {
+        pos += sizeof(size_t);
+    }
+    assert_true(pos + sizeof(first) <= size);
+    size_t wild = (size_t)1 << 40;
+    fseek(file, (long)pos, SEEK_SET);
+    fwrite(&wild, sizeof(wild), 1, file);
+    fclose(file);
+    errno = 0;
+    assert_null(open_dict_image(path, false));
+    assert_int_equal(errno, EINVAL);
+    free_dict(pair);
+
+    // Empty dictionaries round trip
+    dict_t* empty = init_dict();
+    assert_true(save_dict(empty, path));
+    image = open_dict_image(path, true);
+    assert_non_null(image);
+    assert_int_equal(dict_image_size(image), 0);
+    assert_int_equal(get_dict_image_value(image, "image_key_0"), LONG_MAX);
+    close_dict_image(image);
+    remove(path);
+    free_dict(empty);
+    free_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+#if defined(__unix__) || defined(__APPLE__)
+static void* _intern_worker(void* arg) {
+    intern_pool_t* pool = arg;
+    char buffer[16];
+    for (size_t i = 0; i < 1000; i++) {
+        snprintf(buffer, sizeof(buffer), "word%zu", i % 100);
+        if (!intern_string(pool, buffer)) return NULL;
+    }
+    return pool;
+}
+// --------------------------------------------------------------------------------
+
+void test_intern_string_threaded(void **state) {
+    intern_pool_t* pool = init_intern_pool();
+    pthread_t threads[4];
+    for (size_t i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, _intern_worker, pool);
+    }
+    for (size_t i = 0; i < 4; i++) {
+        void* result = NULL;
+        pthread_join(threads[i], &result);
+        assert_non_null(result);
+    }
+    assert_int_equal(intern_pool_size(pool), 100);
+    free_intern_pool(pool);
+}
+// --------------------------------------------------------------------------------
+
+static void* _count_worker(void* arg) {
+    concurrent_dict_t* dict = arg;
+    char buffer[16];
+    for (size_t i = 0; i < 10000; i++) {
+        snprintf(buffer, sizeof(buffer), "word%zu", i % 500);
+        if (increment_concurrent_dict(dict, buffer, 1) == LONG_MAX) return NULL;
+    }
+    return dict;
+}
+// --------------------------------------------------------------------------------
+
+void test_concurrent_dict_threaded(void **state) {
+    concurrent_dict_t* dict = init_concurrent_dict(8);
+    pthread_t threads[8];
+    for (size_t i = 0; i < 8; i++) {
+        pthread_create(&threads[i], NULL, _count_worker, dict);
+    }
+    for (size_t i = 0; i < 8; i++) {
+        void* result = NULL;
+        pthread_join(threads[i], &result);
+        assert_non_null(result);
+    }
+    // No increment is lost, every word was seen 20 times by each thread
+    assert_int_equal(concurrent_dict_size(dict), 500);
+    char buffer[16];
+    for (size_t i = 0; i < 500; i++) {
+        snprintf(buffer, sizeof(buffer), "word%zu", i);
+        assert_int_equal(get_concurrent_dict_value(dict, buffer), 160);
+    }
+    free_concurrent_dict(dict);
+}
+// --------------------------------------------------------------------------------
+
+static atomic_bool _snapshot_done;
+
+static void* _snapshot_worker(void* arg) {
+    snapshot_reader_t* reader = arg;
+    size_t last = 0;
+    while (!atomic_load(&_snapshot_done)) {
+        // Versions only move forward and a published key never disappears
+        size_t version = get_snapshot_dict_value(reader, "version");
+        if (version == LONG_MAX || version < last) return NULL;
+        last = version;
+    }
+    return reader;
+}
+// --------------------------------------------------------------------------------
+
+void test_snapshot_dict_threaded(void **state) {
+    dict_t* first = init_dict();
+    insert_dict(first, "version", 0);
+    snapshot_dict_t* snap = init_snapshot_dict(first);
+    atomic_store(&_snapshot_done, false);
+    
+    pthread_t threads[4];
+    for (size_t i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, _snapshot_worker, register_snapshot_reader(snap));
+    }
+    for (size_t v = 1; v <= 200; v++) {
+        dict_t* next = init_dict();
+        insert_dict(next, "version", v);
+        assert_true(publish_snapshot_dict(snap, next));
+    }
+    atomic_store(&_snapshot_done, true);
+    for (size_t i = 0; i < 4; i++) {
+        void* result = NULL;
+        pthread_join(threads[i], &result);
+        assert_non_null(result);
+        unregister_snapshot_reader(result);
+    }
+    free_snapshot_dict(snap);
+}
+#endif
+// --------------------------------------------------------------------------------
 // ================================================================================
 // eof
@@ -82,6 +82,21 @@ void test_concat_special_characters(void **state);
 void test_concat_large_strings(void **state);
 // -------------------------------------------------------------------------------- 
 
+void test_string_format_concat(void **state);
+// --------------------------------------------------------------------------------
+
+void test_string_number_concat(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parse_int_ranges(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parse_double_matches_strtod(void **state);
+// --------------------------------------------------------------------------------
+
+void test_parse_double_special(void **state);
+// --------------------------------------------------------------------------------
+
 void test_compare_strings_equal(void **state);
 // -------------------------------------------------------------------------------- 
 
@@ -103,6 +118,15 @@ void test_compare_strings_null(void **state);
 void test_compare_strings_case_sensitivity(void **state);
 // --------------------------------------------------------------------------------
 
+void test_compare_strings_long(void **state);
+// --------------------------------------------------------------------------------
+
+void test_equal_strings_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+void test_equal_strings_null(void **state);
+// --------------------------------------------------------------------------------
+
 void test_copy_string_nominal(void **state);
 // --------------------------------------------------------------------------------
 
@@ -476,6 +500,21 @@ void test_tokenize_null_inputs(void **state);
 // --------------------------------------------------------------------------------
 
 void test_tokenize_empty_delimiter(void **state);
+// --------------------------------------------------------------------------------
+
+void test_csv_reader_quotes(void **state);
+// --------------------------------------------------------------------------------
+
+void test_csv_reader_malformed(void **state);
+// --------------------------------------------------------------------------------
+
+void test_csv_reader_file_modes(void **state);
+// --------------------------------------------------------------------------------
+
+void test_line_iter(void **state);
+// --------------------------------------------------------------------------------
+
+void test_read_line_string(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -532,6 +571,124 @@ void test_count_words_case_sensitive(void **state);
 void test_count_words_consecutive_delimiters(void **state);
 // --------------------------------------------------------------------------------
 
+void test_intern_string_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+void test_intern_string_growth(void **state);
+// --------------------------------------------------------------------------------
+
+void test_intern_string_null(void **state);
+// --------------------------------------------------------------------------------
+
+void test_insert_dict_interned(void **state);
+// --------------------------------------------------------------------------------
+
+void test_push_back_interned_str_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_string_hash_cached(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_string_keys(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_string_keys_null(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_power_of_two_growth(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_secure_hash(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_hash_invalid(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_recycle_nodes(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_oversized_key(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_incremental_resize(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_incremental_disable(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_shrink_on_pop(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_reserve_shrink(void **state);
+// --------------------------------------------------------------------------------
+
+void test_concurrent_dict_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+void test_snapshot_dict_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+void test_snapshot_dict_empty(void **state);
+// --------------------------------------------------------------------------------
+
+void test_freeze_dict_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+void test_freeze_dict_small(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_iter_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_iter_ordered(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_set_ordered_existing(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_top_k(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_top_k_count_words(void **state);
+// --------------------------------------------------------------------------------
+
+void test_word_sketch_heavy_hitters(void **state);
+// --------------------------------------------------------------------------------
+
+void test_word_sketch_merge(void **state);
+// --------------------------------------------------------------------------------
+
+void test_count_words_sketch(void **state);
+// --------------------------------------------------------------------------------
+
+void test_hll_estimate(void **state);
+// --------------------------------------------------------------------------------
+
+void test_hll_merge_serialize(void **state);
+// --------------------------------------------------------------------------------
+
+void test_radix_tree_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+void test_radix_tree_prefix_queries(void **state);
+// --------------------------------------------------------------------------------
+
+void test_radix_tree_node_growth(void **state);
+// --------------------------------------------------------------------------------
+
+void test_build_radix_tree(void **state);
+// --------------------------------------------------------------------------------
+
+void test_dict_image_round_trip(void **state);
+// --------------------------------------------------------------------------------
+
+#if defined(__unix__) || defined(__APPLE__)
+    void test_intern_string_threaded(void **state);
+    void test_concurrent_dict_threaded(void **state);
+    void test_snapshot_dict_threaded(void **state);
+#endif
+// --------------------------------------------------------------------------------
+
 void test_count_words_single_word(void **state);
 // ================================================================================
 // ================================================================================ 
@@ -17,6 +17,8 @@
 
 #include "../c_string.h"
 #include <errno.h>
+#include <limits.h>
+#include <stdio.h>
 // ================================================================================ 
 // ================================================================================ 
 
@@ -949,6 +951,541 @@ void test_reverse_str_vector(void **state) {
 
     free_str_vector(vec);
 }
+// --------------------------------------------------------------------------------
+
+void test_unique_str_vector(void **state) {
+    string_v* vec = init_str_vector(8);
+    char* words[8] = {"pear", "apple", "pear", "fig", "apple", "pear", "kiwi", "fig"};
+    for (size_t i = 0; i < 8; i++) {
+        push_back_str_vector(vec, words[i]);
+    }
+    assert_int_equal(unique_str_vector(vec), 4);
+    
+    char* a[4] = {"apple", "fig", "kiwi", "pear"};
+    assert_int_equal(s_size(vec), 4);
+    for (size_t i = 0; i < s_size(vec); i++) {
+        assert_string_equal(a[i], get_string(str_vector_index(vec, i)));
+    }
+    // Already unique, nothing more to remove
+    assert_int_equal(unique_str_vector(vec), 0);
+    // The freed tail slots can be reused
+    push_back_str_vector(vec, "apple");
+    assert_int_equal(unique_str_vector(vec), 1);
+    assert_int_equal(s_size(vec), 4);
+    
+    errno = 0;
+    assert_int_equal(unique_str_vector(NULL), LONG_MAX);
+    assert_int_equal(errno, EINVAL);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+void test_unique_ordered_str_vector(void **state) {
+    string_v* vec = init_str_vector(8);
+    char* words[8] = {"pear", "apple", "pear", "fig", "apple", "pear", "kiwi", "fig"};
+    for (size_t i = 0; i < 8; i++) {
+        push_back_str_vector(vec, words[i]);
+    }
+    assert_int_equal(unique_ordered_str_vector(vec), 4);
+    
+    char* a[4] = {"pear", "apple", "fig", "kiwi"};
+    assert_int_equal(s_size(vec), 4);
+    for (size_t i = 0; i < s_size(vec); i++) {
+        assert_string_equal(a[i], get_string(str_vector_index(vec, i)));
+    }
+    
+    string_v* empty = init_str_vector(1);
+    assert_int_equal(unique_ordered_str_vector(empty), 0);
+    errno = 0;
+    assert_int_equal(unique_ordered_str_vector(NULL), LONG_MAX);
+    assert_int_equal(errno, EINVAL);
+    free_str_vector(empty);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+void test_unique_ordered_str_vector_large(void **state) {
+    string_v* vec = init_str_vector(4000);
+    char word[32];
+    for (size_t i = 0; i < 4000; i++) {
+        snprintf(word, sizeof(word), "w%zu", (i * 7) % 1000);
+        push_back_str_vector(vec, word);
+    }
+    assert_int_equal(unique_ordered_str_vector(vec), 3000);
+    for (size_t i = 0; i < 1000; i++) {
+        snprintf(word, sizeof(word), "w%zu", (i * 7) % 1000);
+        assert_string_equal(word, get_string(str_vector_index(vec, i)));
+    }
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+static string_v* _sorted_vector(char** words, size_t n) {
+    string_v* vec = init_str_vector(n > 0 ? n : 1);
+    for (size_t i = 0; i < n; i++) {
+        push_back_str_vector(vec, words[i]);
+    }
+    sort_str_vector(vec, FORWARD);
+    return vec;
+}
+// --------------------------------------------------------------------------------
+
+void test_set_ops_str_vector(void **state) {
+    char* x[6] = {"apple", "fig", "kiwi", "pear", "plum", "apple"};
+    char* y[4] = {"banana", "fig", "plum", "zucchini"};
+    string_v* a = _sorted_vector(x, 6);
+    string_v* b = _sorted_vector(y, 4);
+    
+    string_v* u = union_str_vector(a, b);
+    char* u_exp[7] = {"apple", "banana", "fig", "kiwi", "pear", "plum", "zucchini"};
+    assert_int_equal(s_size(u), 7);
+    for (size_t i = 0; i < 7; i++) {
+        assert_string_equal(u_exp[i], get_string(str_vector_index(u, i)));
+    }
+    
+    string_v* n = intersect_str_vector(a, b);
+    assert_int_equal(s_size(n), 2);
+    assert_string_equal("fig", get_string(str_vector_index(n, 0)));
+    assert_string_equal("plum", get_string(str_vector_index(n, 1)));
+    
+    string_v* d = difference_str_vector(a, b);
+    char* d_exp[3] = {"apple", "kiwi", "pear"};
+    assert_int_equal(s_size(d), 3);
+    for (size_t i = 0; i < 3; i++) {
+        assert_string_equal(d_exp[i], get_string(str_vector_index(d, i)));
+    }
+    
+    // Arena-backed results behave like any other vector
+    string_t* last = pop_back_str_vector(d);
+    assert_string_equal("pear", get_string(last));
+    push_back_str_vector(d, "quince");
+    assert_string_equal("quince", get_string(str_vector_index(d, 2)));
+    
+    string_v* empty = init_str_vector(1);
+    string_v* e = intersect_str_vector(a, empty);
+    assert_int_equal(s_size(e), 0);
+    
+    errno = 0;
+    assert_null(union_str_vector(a, NULL));
+    assert_int_equal(errno, EINVAL);
+    
+    free_string(last);
+    free_str_vector(e);
+    free_str_vector(empty);
+    free_str_vector(d);
+    free_str_vector(n);
+    free_str_vector(u);
+    free_str_vector(b);
+    free_str_vector(a);
+}
+// --------------------------------------------------------------------------------
+
+void test_set_ops_skewed_str_vector(void **state) {
+    // A large list against a handful of keywords exercises the galloping path
+    string_v* big = init_str_vector(2000);
+    char word[32];
+    for (size_t i = 0; i < 2000; i++) {
+        snprintf(word, sizeof(word), "key%05zu", i * 2);
+        push_back_str_vector(big, word);
+    }
+    char* k[5] = {"key00000", "key00001", "key01000", "key03998", "zzz"};
+    string_v* small = _sorted_vector(k, 5);
+    
+    string_v* n = intersect_str_vector(small, big);
+    assert_int_equal(s_size(n), 3);
+    assert_string_equal("key00000", get_string(str_vector_index(n, 0)));
+    assert_string_equal("key01000", get_string(str_vector_index(n, 1)));
+    assert_string_equal("key03998", get_string(str_vector_index(n, 2)));
+    
+    string_v* d = difference_str_vector(big, small);
+    assert_int_equal(s_size(d), 1997);
+    string_v* u = union_str_vector(big, small);
+    assert_int_equal(s_size(u), 2002);
+    for (size_t i = 1; i < s_size(u); i++) {
+        assert_true(compare_strings_string(str_vector_index(u, i - 1), 
+                    (string_t*)str_vector_index(u, i)) < 0);
+    }
+    free_str_vector(u);
+    free_str_vector(d);
+    free_str_vector(n);
+    free_str_vector(small);
+    free_str_vector(big);
+}
+// --------------------------------------------------------------------------------
+
+void test_k_way_merge_str_vector(void **state) {
+    char* x[3] = {"b", "d", "f"};
+    char* y[4] = {"a", "b", "c", "g"};
+    char* z[2] = {"e", "h"};
+    string_v* vecs[4] = {_sorted_vector(x, 3), _sorted_vector(y, 4), 
+                         init_str_vector(1), _sorted_vector(z, 2)};
+    string_v* m = k_way_merge_str_vector((const string_v* const*)vecs, 4);
+    char* exp[9] = {"a", "b", "b", "c", "d", "e", "f", "g", "h"};
+    assert_int_equal(s_size(m), 9);
+    for (size_t i = 0; i < 9; i++) {
+        assert_string_equal(exp[i], get_string(str_vector_index(m, i)));
+    }
+    
+    errno = 0;
+    assert_null(k_way_merge_str_vector((const string_v* const*)vecs, 0));
+    assert_int_equal(errno, EINVAL);
+    
+    free_str_vector(m);
+    for (size_t i = 0; i < 4; i++) {
+        free_str_vector(vecs[i]);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_bounds_str_vector(void **state) {
+    char* words[7] = {"apple", "apricot", "banana", "band", "band", "bandana", "cherry"};
+    string_v* vec = init_str_vector(7);
+    for (size_t i = 0; i < 7; i++) {
+        push_back_str_vector(vec, words[i]);
+    }
+    assert_true(is_str_vector_sorted(vec));
+    assert_int_equal(lower_bound_str_vector(vec, "band", false), 3);
+    assert_int_equal(upper_bound_str_vector(vec, "band", false), 5);
+    assert_int_equal(lower_bound_str_vector(vec, "aardvark", false), 0);
+    assert_int_equal(lower_bound_str_vector(vec, "zebra", false), 7);
+    assert_int_equal(upper_bound_str_vector(vec, "b", false), 2);
+    
+    errno = 0;
+    assert_int_equal(lower_bound_str_vector(NULL, "band", false), LONG_MAX);
+    assert_int_equal(errno, EINVAL);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+void test_prefix_range_str_vector(void **state) {
+    char* words[7] = {"cherry", "band", "apricot", "bandana", "apple", "banana", "band"};
+    string_v* vec = init_str_vector(7);
+    for (size_t i = 0; i < 7; i++) {
+        push_back_str_vector(vec, words[i]);
+    }
+    assert_false(is_str_vector_sorted(vec));
+    size_t first = 0;
+    size_t last = 0;
+    assert_true(prefix_range_str_vector(vec, "ban", true, &first, &last));
+    assert_true(is_str_vector_sorted(vec));
+    assert_int_equal(first, 2);
+    assert_int_equal(last, 6);
+    assert_string_equal("banana", get_string(str_vector_index(vec, first)));
+    assert_string_equal("bandana", get_string(str_vector_index(vec, last - 1)));
+    
+    assert_true(prefix_range_str_vector(vec, "ap", false, &first, &last));
+    assert_int_equal(first, 0);
+    assert_int_equal(last, 2);
+    assert_true(prefix_range_str_vector(vec, "", false, &first, &last));
+    assert_int_equal(first, 0);
+    assert_int_equal(last, 7);
+    // No match gives an empty range at the insertion point
+    assert_true(prefix_range_str_vector(vec, "bx", false, &first, &last));
+    assert_int_equal(first, last);
+    assert_int_equal(first, 6);
+    
+    errno = 0;
+    assert_false(prefix_range_str_vector(vec, "a", false, NULL, &last));
+    assert_int_equal(errno, EINVAL);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+void test_str_vector_sorted_flag(void **state) {
+    string_v* vec = init_str_vector(4);
+    assert_true(is_str_vector_sorted(vec));
+    push_back_str_vector(vec, "b");
+    push_back_str_vector(vec, "d");
+    push_front_str_vector(vec, "a");
+    insert_str_vector(vec, "c", 2);
+    assert_true(is_str_vector_sorted(vec));
+    
+    insert_str_vector(vec, "z", 1);
+    assert_false(is_str_vector_sorted(vec));
+    // Removing elements never breaks the order, but the flag stays conservative
+    delete_any_str_vector(vec, 1);
+    assert_false(is_str_vector_sorted(vec));
+    sort_str_vector(vec, FORWARD);
+    assert_true(is_str_vector_sorted(vec));
+    
+    reverse_str_vector(vec);
+    assert_false(is_str_vector_sorted(vec));
+    sort_str_vector(vec, FORWARD);
+    assert_true(is_str_vector_sorted(vec));
+    sort_str_vector(vec, REVERSE);
+    assert_false(is_str_vector_sorted(vec));
+    
+    // Set operation results inherit the order of their inputs
+    sort_str_vector(vec, FORWARD);
+    string_v* u = union_str_vector(vec, vec);
+    assert_true(is_str_vector_sorted(u));
+    
+    errno = 0;
+    assert_false(is_str_vector_sorted(NULL));
+    assert_int_equal(errno, EINVAL);
+    free_str_vector(u);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+void test_search_index_nominal(void **state) {
+    // Keys sharing their first eight bytes exercise the full key compare
+    char* words[8] = {"apple", "banana", "prefix_0001", "prefix_0002", 
+                      "prefix_0002", "prefix_01", "prefixes", "zebra"};
+    string_v* vec = init_str_vector(8);
+    for (size_t i = 0; i < 8; i++) {
+        push_back_str_vector(vec, words[i]);
+    }
+    search_index_t* index = init_search_index(vec);
+    assert_non_null(index);
+    free_str_vector(vec);
+    
+    assert_int_equal(search_index_size(index), 8);
+    assert_int_equal(search_index_find(index, "apple"), 0);
+    assert_int_equal(search_index_find(index, "prefix_0002"), 3);
+    assert_int_equal(search_index_find(index, "prefix_01"), 5);
+    assert_int_equal(search_index_find(index, "zebra"), 7);
+    assert_int_equal(search_index_find(index, "prefix_"), LONG_MAX);
+    assert_int_equal(search_index_find(index, "zzz"), LONG_MAX);
+    assert_int_equal(search_index_lower_bound(index, "prefix_"), 2);
+    assert_int_equal(search_index_lower_bound(index, "a"), 0);
+    assert_int_equal(search_index_lower_bound(index, "zzz"), 8);
+    assert_string_equal("prefixes", search_index_key(index, 6));
+    
+    errno = 0;
+    assert_null(search_index_key(index, 8));
+    assert_int_equal(errno, ERANGE);
+    errno = 0;
+    assert_int_equal(search_index_find(NULL, "apple"), LONG_MAX);
+    assert_int_equal(errno, EINVAL);
+    free_search_index(index);
+}
+// --------------------------------------------------------------------------------
+
+void test_search_index_matches_lower_bound(void **state) {
+    string_v* vec = init_str_vector(3000);
+    char word[32];
+    for (size_t i = 0; i < 3000; i++) {
+        snprintf(word, sizeof(word), "key%06zu", i * 3);
+        push_back_str_vector(vec, word);
+    }
+    search_index_t* index = init_search_index(vec);
+    assert_non_null(index);
+    for (size_t i = 0; i < 9003; i++) {
+        snprintf(word, sizeof(word), "key%06zu", i);
+        assert_int_equal(search_index_lower_bound(index, word), 
+                         lower_bound_str_vector(vec, word, false));
+        size_t expected = i % 3 == 0 && i < 9000 ? i / 3 : LONG_MAX;
+        assert_int_equal(search_index_find(index, word), expected);
+    }
+    // Queries that leave the prefix every key shares
+    assert_int_equal(search_index_lower_bound(index, "ke"), 0);
+    assert_int_equal(search_index_lower_bound(index, "kez"), 3000);
+    assert_int_equal(search_index_lower_bound(index, "aaa"), 0);
+    assert_int_equal(search_index_find(index, "ke"), LONG_MAX);
+    assert_int_equal(search_index_find(index, "kez"), LONG_MAX);
+    free_search_index(index);
+    
+    // Unsorted input is rejected, an empty vector gives an empty index
+    push_front_str_vector(vec, "zzz");
+    errno = 0;
+    assert_null(init_search_index(vec));
+    assert_int_equal(errno, EINVAL);
+    string_v* empty = init_str_vector(1);
+    index = init_search_index(empty);
+    assert_int_equal(search_index_find(index, "key"), LONG_MAX);
+    assert_int_equal(search_index_lower_bound(index, "key"), 0);
+    free_search_index(index);
+    free_str_vector(empty);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+static string_v* _lexicon(size_t n, size_t repeat) {
+    // Sorted keys with long shared prefixes, each repeated repeat times
+    string_v* vec = init_str_vector(n * repeat);
+    char word[64];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(word, sizeof(word), "lexicon/entry/%c%c/%zu", 
+                 (int)('a' + i / 100 % 26), (int)('a' + i / 10 % 10), i % 10);
+        for (size_t r = 0; r < repeat; r++) {
+            push_back_str_vector(vec, word);
+        }
+    }
+    sort_str_vector(vec, FORWARD);
+    return vec;
+}
+// --------------------------------------------------------------------------------
+
+void test_front_coded_round_trip(void **state) {
+    string_v* vec = _lexicon(500, 1);
+    size_t buckets[3] = {0, 1, 7};
+    char buffer[64];
+    for (size_t b = 0; b < 3; b++) {
+        front_coded_t* fc = init_front_coded(vec, buckets[b]);
+        assert_non_null(fc);
+        assert_int_equal(front_coded_size(fc), 500);
+        for (size_t i = 0; i < 500; i++) {
+            const char* expected = get_string(str_vector_index(vec, i));
+            assert_int_equal(front_coded_get(fc, i, NULL, 0), strlen(expected));
+            assert_int_equal(front_coded_get(fc, i, buffer, sizeof(buffer)), strlen(expected));
+            assert_string_equal(expected, buffer);
+        }
+        free_front_coded(fc);
+    }
+    
+    front_coded_t* fc = init_front_coded(vec, 0);
+    // Far less than the bytes of the strings alone
+    size_t raw = 0;
+    for (size_t i = 0; i < 500; i++) {
+        raw += string_size(str_vector_index(vec, i)) + 1;
+    }
+    assert_true(front_coded_memory(fc) * 3 < raw);
+    
+    errno = 0;
+    assert_int_equal(front_coded_get(fc, 0, buffer, 5), LONG_MAX);
+    assert_int_equal(errno, ERANGE);
+    errno = 0;
+    assert_int_equal(front_coded_get(fc, 500, buffer, sizeof(buffer)), LONG_MAX);
+    assert_int_equal(errno, ERANGE);
+    free_front_coded(fc);
+    
+    // Unsorted input is rejected
+    push_back_str_vector(vec, "aaa");
+    errno = 0;
+    assert_null(init_front_coded(vec, 0));
+    assert_int_equal(errno, EINVAL);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+void test_front_coded_search(void **state) {
+    // Repeated keys straddle bucket boundaries
+    string_v* vec = _lexicon(300, 3);
+    char* probes[7] = {"", "a", "lexicon/entry/", "lexicon/entry/ab/3", 
+                       "lexicon/entry/ab/35", "lexicon/entry/cz", "zzz"};
+    char word[64];
+    size_t buckets[3] = {0, 1, 5};
+    for (size_t b = 0; b < 3; b++) {
+        front_coded_t* fc = init_front_coded(vec, buckets[b]);
+        for (size_t i = 0; i < s_size(vec); i++) {
+            const char* key = get_string(str_vector_index(vec, i));
+            size_t first = lower_bound_str_vector(vec, key, false);
+            assert_int_equal(front_coded_find(fc, key), first);
+            // A key one byte longer falls just after every copy
+            snprintf(word, sizeof(word), "%s!", key);
+            assert_int_equal(front_coded_lower_bound(fc, word), 
+                             lower_bound_str_vector(vec, word, false));
+            assert_int_equal(front_coded_find(fc, word), LONG_MAX);
+        }
+        for (size_t p = 0; p < 7; p++) {
+            assert_int_equal(front_coded_lower_bound(fc, probes[p]), 
+                             lower_bound_str_vector(vec, probes[p], false));
+        }
+        free_front_coded(fc);
+    }
+    
+    string_v* empty = init_str_vector(1);
+    front_coded_t* fc = init_front_coded(empty, 0);
+    assert_int_equal(front_coded_size(fc), 0);
+    assert_int_equal(front_coded_find(fc, "a"), LONG_MAX);
+    assert_int_equal(front_coded_lower_bound(fc, "a"), 0);
+    errno = 0;
+    assert_int_equal(front_coded_find(NULL, "a"), LONG_MAX);
+    assert_int_equal(errno, EINVAL);
+    free_front_coded(fc);
+    free_str_vector(empty);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+void test_str_vector_image_round_trip(void **state) {
+    const char* path = "str_vector_image_test.bin";
+    string_v* vec = _lexicon(400, 2);
+    push_back_str_vector(vec, "");
+    sort_str_vector(vec, FORWARD);
+    assert_true(save_str_vector(vec, path));
+    str_vector_image_t* image = open_str_vector_image(path, true);
+    assert_non_null(image);
+    assert_int_equal(str_vector_image_size(image), s_size(vec));
+    size_t len = 0;
+    for (size_t i = 0; i < s_size(vec); i++) {
+        const char* expected = get_string(str_vector_index(vec, i));
+        assert_string_equal(str_vector_image_index(image, i, &len), expected);
+        assert_int_equal(len, strlen(expected));
+        assert_int_equal(str_vector_image_find(image, expected), 
+                         lower_bound_str_vector(vec, expected, false));
+    }
+    assert_int_equal(str_vector_image_find(image, "lexicon/entry/ab/35"), LONG_MAX);
+    errno = 0;
+    assert_null(str_vector_image_index(image, s_size(vec), &len));
+    assert_int_equal(errno, ERANGE);
+    close_str_vector_image(image);
+
+    // Unsorted vectors are searched by scanning
+    reverse_str_vector(vec);
+    assert_true(save_str_vector(vec, path));
+    image = open_str_vector_image(path, false);
+    assert_non_null(image);
+    for (size_t i = 0; i < s_size(vec); i += 2) {
+        const char* key = get_string(str_vector_index(vec, i));
+        assert_string_equal(str_vector_image_index(image, 
+                            str_vector_image_find(image, key), NULL), key);
+    }
+    close_str_vector_image(image);
+    remove(path);
+    free_str_vector(vec);
+}
+// --------------------------------------------------------------------------------
+
+void test_str_vector_image_rejects_bad_files(void **state) {
+    const char* path = "str_vector_image_bad.bin";
+    string_v* vec = _lexicon(50, 1);
+    assert_true(save_str_vector(vec, path));
+
+    // Flip one byte of the last string
+    FILE* file = fopen(path, "r+b");
+    assert_non_null(file);
+    fseek(file, -2, SEEK_END);
+    fputc('#', file);
+    fclose(file);
+    errno = 0;
+    assert_null(open_str_vector_image(path, true));
+    assert_int_equal(errno, EILSEQ);
+    // The header is still valid, so an unverified open succeeds
+    str_vector_image_t* image = open_str_vector_image(path, false);
+    assert_non_null(image);
+    close_str_vector_image(image);
+
+    // A damaged offset is caught by the open checks even without verify
+    assert_true(save_str_vector(vec, path));
+    file = fopen(path, "r+b");
+    assert_non_null(file);
+    uint64_t wild = (uint64_t)1 << 40;
+    fseek(file, 72 + sizeof(uint64_t), SEEK_SET);
+    fwrite(&wild, sizeof(wild), 1, file);
+    fclose(file);
+    errno = 0;
+    assert_null(open_str_vector_image(path, false));
+    assert_int_equal(errno, EINVAL);
+
+    // Truncated files and other formats fail the header checks
+    file = fopen(path, "wb");
+    fputs("not an image, just some text that is long enough for a header", file);
+    fputs(" and then some more text to pad it out", file);
+    fclose(file);
+    errno = 0;
+    assert_null(open_str_vector_image(path, false));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_null(open_dict_image(path, false));
+    assert_int_equal(errno, EINVAL);
+    remove(path);
+    errno = 0;
+    assert_null(open_str_vector_image(path, false));
+    assert_int_equal(errno, ENOENT);
+    free_str_vector(vec);
+}
 // ================================================================================
 // ================================================================================
 // eof
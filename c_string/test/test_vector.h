@@ -197,6 +197,51 @@ void test_delete_any_multiple(void **state);
 // --------------------------------------------------------------------------------
 
 void test_reverse_str_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_unique_str_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_unique_ordered_str_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_unique_ordered_str_vector_large(void **state);
+// --------------------------------------------------------------------------------
+
+void test_set_ops_str_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_set_ops_skewed_str_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_k_way_merge_str_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_bounds_str_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_prefix_range_str_vector(void **state);
+// --------------------------------------------------------------------------------
+
+void test_str_vector_sorted_flag(void **state);
+// --------------------------------------------------------------------------------
+
+void test_search_index_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+void test_search_index_matches_lower_bound(void **state);
+// --------------------------------------------------------------------------------
+
+void test_front_coded_round_trip(void **state);
+// --------------------------------------------------------------------------------
+
+void test_front_coded_search(void **state);
+// --------------------------------------------------------------------------------
+
+void test_str_vector_image_round_trip(void **state);
+// --------------------------------------------------------------------------------
+
+void test_str_vector_image_rejects_bad_files(void **state);
 // ================================================================================
 // ================================================================================ 
 #endif /* test_vector_H */
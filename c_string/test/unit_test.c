@@ -47,6 +47,11 @@ const struct CMUnitTest test_string[] = {
     cmocka_unit_test(test_concat_multiple_times),
     cmocka_unit_test(test_concat_special_characters),
     cmocka_unit_test(test_concat_large_strings),
+    cmocka_unit_test(test_string_format_concat),
+    cmocka_unit_test(test_string_number_concat),
+    cmocka_unit_test(test_parse_int_ranges),
+    cmocka_unit_test(test_parse_double_matches_strtod),
+    cmocka_unit_test(test_parse_double_special),
     cmocka_unit_test(test_compare_strings_equal),
     cmocka_unit_test(test_compare_strings_less),
     cmocka_unit_test(test_compare_strings_greater),
@@ -54,6 +59,9 @@ const struct CMUnitTest test_string[] = {
     cmocka_unit_test(test_compare_strings_empty),
     cmocka_unit_test(test_compare_strings_null),
     cmocka_unit_test(test_compare_strings_case_sensitivity), 
+    cmocka_unit_test(test_compare_strings_long),
+    cmocka_unit_test(test_equal_strings_nominal),
+    cmocka_unit_test(test_equal_strings_null),
     cmocka_unit_test(test_copy_string_nominal),
     cmocka_unit_test(test_copy_string_empty),
     cmocka_unit_test(test_copy_string_null),
@@ -174,6 +182,11 @@ const struct CMUnitTest test_string[] = {
     cmocka_unit_test(test_tokenize_only_delimiters),
     cmocka_unit_test(test_tokenize_null_inputs),
     cmocka_unit_test(test_tokenize_empty_delimiter),
+    cmocka_unit_test(test_csv_reader_quotes),
+    cmocka_unit_test(test_csv_reader_malformed),
+    cmocka_unit_test(test_csv_reader_file_modes),
+    cmocka_unit_test(test_line_iter),
+    cmocka_unit_test(test_read_line_string),
     cmocka_unit_test(test_count_words_nominal),
     cmocka_unit_test(test_count_words_empty_string),
     cmocka_unit_test(test_count_words_single_word),
@@ -247,6 +260,21 @@ const struct CMUnitTest test_string_vector[] = {
     cmocka_unit_test(test_delete_null_vector),
     cmocka_unit_test(test_delete_any_multiple),
     cmocka_unit_test(test_reverse_str_vector),
+    cmocka_unit_test(test_unique_str_vector),
+    cmocka_unit_test(test_unique_ordered_str_vector),
+    cmocka_unit_test(test_unique_ordered_str_vector_large),
+    cmocka_unit_test(test_set_ops_str_vector),
+    cmocka_unit_test(test_set_ops_skewed_str_vector),
+    cmocka_unit_test(test_k_way_merge_str_vector),
+    cmocka_unit_test(test_bounds_str_vector),
+    cmocka_unit_test(test_prefix_range_str_vector),
+    cmocka_unit_test(test_str_vector_sorted_flag),
+    cmocka_unit_test(test_search_index_nominal),
+    cmocka_unit_test(test_search_index_matches_lower_bound),
+    cmocka_unit_test(test_front_coded_round_trip),
+    cmocka_unit_test(test_front_coded_search),
+    cmocka_unit_test(test_str_vector_image_round_trip),
+    cmocka_unit_test(test_str_vector_image_rejects_bad_files),
 };
 // --------------------------------------------------------------------------------
 
@@ -263,6 +291,48 @@ const struct CMUnitTest test_dictionary[] = {
     cmocka_unit_test(test_get_dict_keys_empty),
     cmocka_unit_test(test_get_dict_keys_null),
     cmocka_unit_test(test_get_dict_keys_after_pop),
+    cmocka_unit_test(test_intern_string_nominal),
+    cmocka_unit_test(test_intern_string_growth),
+    cmocka_unit_test(test_intern_string_null),
+    cmocka_unit_test(test_insert_dict_interned),
+    cmocka_unit_test(test_push_back_interned_str_vector),
+    cmocka_unit_test(test_string_hash_cached),
+    cmocka_unit_test(test_dict_string_keys),
+    cmocka_unit_test(test_dict_string_keys_null),
+    cmocka_unit_test(test_dict_power_of_two_growth),
+    cmocka_unit_test(test_dict_secure_hash),
+    cmocka_unit_test(test_dict_hash_invalid),
+    cmocka_unit_test(test_dict_recycle_nodes),
+    cmocka_unit_test(test_dict_oversized_key),
+    cmocka_unit_test(test_dict_incremental_resize),
+    cmocka_unit_test(test_dict_incremental_disable),
+    cmocka_unit_test(test_dict_shrink_on_pop),
+    cmocka_unit_test(test_dict_reserve_shrink),
+    cmocka_unit_test(test_concurrent_dict_nominal),
+    cmocka_unit_test(test_snapshot_dict_nominal),
+    cmocka_unit_test(test_snapshot_dict_empty),
+    cmocka_unit_test(test_freeze_dict_nominal),
+    cmocka_unit_test(test_freeze_dict_small),
+    cmocka_unit_test(test_dict_iter_nominal),
+    cmocka_unit_test(test_dict_iter_ordered),
+    cmocka_unit_test(test_dict_set_ordered_existing),
+    cmocka_unit_test(test_dict_top_k),
+    cmocka_unit_test(test_dict_top_k_count_words),
+    cmocka_unit_test(test_word_sketch_heavy_hitters),
+    cmocka_unit_test(test_word_sketch_merge),
+    cmocka_unit_test(test_count_words_sketch),
+    cmocka_unit_test(test_hll_estimate),
+    cmocka_unit_test(test_hll_merge_serialize),
+    cmocka_unit_test(test_radix_tree_nominal),
+    cmocka_unit_test(test_radix_tree_prefix_queries),
+    cmocka_unit_test(test_radix_tree_node_growth),
+    cmocka_unit_test(test_build_radix_tree),
+    cmocka_unit_test(test_dict_image_round_trip),
+    #if defined(__unix__) || defined(__APPLE__)
+        cmocka_unit_test(test_intern_string_threaded),
+        cmocka_unit_test(test_concurrent_dict_threaded),
+        cmocka_unit_test(test_snapshot_dict_threaded),
+    #endif
 };
 // ================================================================================ 
 // ================================================================================ 